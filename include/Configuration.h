@@ -2,12 +2,23 @@
 #pragma once
 
 #include "PinMapping.h"
+#include <ArduinoJson.h>
 #include <cstdint>
 #include <TaskSchedulerDeclarations.h>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
+#include <optional>
+#include <vector>
 
 #define CONFIG_FILENAME "/config.json"
+#define CONFIG_BINARY_FILENAME "/config.bin"
+#define CONFIG_BINARY_MAGIC 0x4344544f // "ODTC"
+#define CONFIG_BINARY_FORMAT 2
+#define CONFIG_FALLBACK_FILENAME "/config.fallback.json" // JSON copy of the last layout or version change, used if the binary file can not be read
+
+#define CONFIG_WRITE_DELAY 1000 // ms without further changes before a deferred write is performed
+#define CONFIG_WRITE_MAX_DELAY 5000 // ms after the first change a deferred write is performed at the latest
 #define CONFIG_VERSION 0x00011d00 // 0.1.29 // make sure to clean all after change
 
 #define WIFI_MAX_SSID_STRLEN 32
@@ -125,12 +136,10 @@ struct CONFIG_T {
             bool Expire;
         } Hass;
 
+        // The certificates are stored as separate blobs, see ConfigBlob
         struct {
             bool Enabled;
-            char RootCaCert[MQTT_MAX_CERT_STRLEN + 1];
             bool CertLogin;
-            char ClientCert[MQTT_MAX_CERT_STRLEN + 1];
-            char ClientKey[MQTT_MAX_CERT_STRLEN + 1];
         } Tls;
     } Mqtt;
 
@@ -172,14 +181,54 @@ struct CONFIG_T {
     char Dev_PinMapping[DEV_MAX_MAPPING_NAME_STRLEN + 1];
 };
 
+// Large, rarely used settings which are not kept in RAM but read from flash on demand
+enum class ConfigBlob : uint8_t {
+    MqttRootCaCert,
+    MqttClientCert,
+    MqttClientKey,
+};
+#define CONFIG_BLOB_COUNT 3
+
 class ConfigurationClass {
 public:
     void init(Scheduler& scheduler);
     bool read();
     bool write();
     void migrate();
+
+    using WriteCallback = std::function<void(const bool success)>;
+
+    // Schedules a write performed by the main loop. Requests arriving within
+    // CONFIG_WRITE_DELAY are combined into a single write. Returns the
+    // sequence number of the request which can be compared to WriteStats.
+    uint32_t writeDeferred(const WriteCallback& callback = nullptr);
+    void flush();
+    void discardPendingWrite();
+
+    struct WriteStats {
+        bool Pending;
+        bool LastSuccess;
+        uint32_t Requests; // Also the sequence number of the last request
+        uint32_t Completed; // Last request which was covered by a finished write
+        uint32_t Saved; // Last request which was covered by a successful write
+        uint32_t Writes;
+        uint32_t LastDuration;
+        uint32_t MaxDuration;
+    };
+    WriteStats getWriteStats();
     CONFIG_T const& get();
 
+    String readBlob(const ConfigBlob blob);
+
+    // Writes the value right away if it differs from the stored one
+    bool writeBlob(const ConfigBlob blob, const String& value);
+
+    // Stores the value with the next write if it differs from the stored one.
+    // Used together with writeDeferred() to keep flash writes out of the web server.
+    void setBlob(const ConfigBlob blob, const String& value);
+
+    size_t exportJson(Print& output);
+
     class WriteGuard {
     public:
         WriteGuard();
@@ -199,7 +248,21 @@ public:
 private:
     void loop();
 
+    bool readBinary(bool& layoutChanged);
+    bool writePendingBlobs();
+    bool readJson(const char* filename);
+    void writeFallback();
+    void fromJson(JsonDocument& doc);
+    void toJson(JsonDocument& doc, const bool includeBlobs = true);
+
     Task _loopTask;
+
+    std::mutex _deferredWriteMutex;
+    std::vector<WriteCallback> _writeCallbacks;
+    std::optional<String> _pendingBlobs[CONFIG_BLOB_COUNT];
+    WriteStats _writeStats = {};
+    uint32_t _writeFirstRequest = 0;
+    uint32_t _writeLastRequest = 0;
 };
 
 extern ConfigurationClass Configuration;
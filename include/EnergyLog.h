@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <FS.h>
+#include <TaskSchedulerDeclarations.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#define ENERGY_LOG_FILENAME "/energy.log"
+#define ENERGY_LOG_OLD_FILENAME "/energy.old.log"
+#define ENERGY_ROLLUP_FILENAME "/energy_rollup.bin"
+#define ENERGY_ROLLUP_MAGIC 0x4544544f // "ODTE"
+#define ENERGY_ROLLUP_FORMAT 1
+
+#define ENERGY_LOG_INTERVAL 300 // Seconds covered by one interval record
+#define ENERGY_LOG_FLUSH_INTERVAL (20 * 60) // Seconds between two flash writes
+#define ENERGY_LOG_CHECKPOINT_INTERVAL 288 // Intervals between two checkpoints (1 day)
+#define ENERGY_LOG_MAX_SIZE (128 * 1024) // Size after which the log is rotated
+#define ENERGY_LOG_MAX_PENDING 1024 // Flush earlier if this amount of bytes is buffered
+
+#define ENERGY_ROLLUP_DAYS 31
+#define ENERGY_ROLLUP_MONTHS 24
+
+#define ENERGY_MAX_CHANNELS 6
+
+enum EnergyLogRecordType : uint8_t {
+    ENERGY_RECORD_CHECKPOINT = 'C', // Absolute yield total of all strings, defines the layout of the following records
+    ENERGY_RECORD_INTERVAL = 'I', // Energy of all strings within one interval
+};
+
+struct EnergyLogInverter_t {
+    uint64_t Serial;
+    uint8_t Channels;
+
+    bool operator==(const EnergyLogInverter_t& other) const
+    {
+        return Serial == other.Serial && Channels == other.Channels;
+    }
+};
+
+struct EnergyLogRecord_t {
+    EnergyLogRecordType Type;
+    uint32_t Index; // Epoch / ENERGY_LOG_INTERVAL
+    std::vector<uint32_t> Values; // Energy in Wh of every string in the order of the layout
+};
+
+// Sequentially decodes a log file. Stops at the end of the file or at the first corrupted record.
+class EnergyLogReader {
+public:
+    // Reads at most maxSize bytes of the file
+    bool open(const char* filename, const size_t maxSize = SIZE_MAX);
+
+    // Continues with records which are still buffered in RAM. They follow
+    // the previously opened file, so its layout and index are kept.
+    void openBuffer(std::vector<uint8_t>&& data);
+
+    bool next(EnergyLogRecord_t& record);
+
+    // Inverters and strings of the last checkpoint
+    const std::vector<EnergyLogInverter_t>& getLayout() const;
+
+private:
+    int read();
+    size_t read(uint8_t* buffer, const size_t len);
+    bool readVarint(uint32_t& value);
+
+    File _file;
+    size_t _remaining = 0; // Bytes of _file which may still be read
+    std::vector<uint8_t> _data;
+    size_t _dataPos = 0;
+    std::vector<EnergyLogInverter_t> _layout;
+    size_t _valueCount = 0;
+    uint32_t _index = 0;
+};
+
+class EnergyLogClass {
+public:
+    EnergyLogClass();
+    void init(Scheduler& scheduler);
+
+    // Writes all buffered records to flash
+    void flush();
+
+    // Opens both log files and copies the records which are not yet written
+    // to flash. The current log is limited to its size at the time of the
+    // call so records flushed meanwhile are not returned twice. The log is
+    // not rotated until closeSnapshot() was called.
+    void openSnapshot(EnergyLogReader& oldLog, EnergyLogReader& log, std::vector<uint8_t>& pending);
+    void closeSnapshot();
+
+    struct Rollup_t {
+        uint32_t Key; // YYYYMMDD for days, YYYYMM for months
+        uint32_t Energy; // Wh
+    };
+
+    // Calls onRollup for all daily and monthly sums of the inverter, oldest first
+    bool getRollups(const uint64_t serial, const std::function<void(const Rollup_t&, bool monthly)>& onRollup);
+
+private:
+    void loop();
+
+    struct InverterEnergy_t {
+        uint64_t Serial;
+        uint8_t Channels;
+        uint32_t YieldTotal[ENERGY_MAX_CHANNELS]; // Last known yield total in Wh
+        uint32_t Pending[ENERGY_MAX_CHANNELS]; // Energy of the current interval in Wh
+        uint32_t LastUpdate; // Last statistics update which was processed
+        Rollup_t Days[ENERGY_ROLLUP_DAYS];
+        Rollup_t Months[ENERGY_ROLLUP_MONTHS];
+    };
+
+    InverterEnergy_t* getInverter(const uint64_t serial);
+    void addRollups(InverterEnergy_t& inv, const uint32_t index, const uint32_t energy);
+    void closeInterval();
+    bool rotateLog();
+    void encodeRecord(const EnergyLogRecordType type, const uint32_t indexValue, const std::vector<uint32_t>& values);
+    void writeBuffer();
+    bool readRollups();
+    bool writeRollups();
+    void replayLog(const char* filename);
+
+    Task _loopTask;
+    std::mutex _mutex;
+
+    std::vector<InverterEnergy_t> _inverters;
+    std::vector<EnergyLogInverter_t> _layout; // Layout of the last written checkpoint
+
+    std::vector<uint8_t> _buffer; // Encoded records not yet written to flash
+    uint32_t _fileSize = 0;
+    uint8_t _openSnapshots = 0;
+
+    uint32_t _currentIndex = 0; // Interval which is currently accumulated
+    uint32_t _lastRecordIndex = 0; // Interval of the last encoded record
+    uint32_t _lastCheckpointIndex = 0;
+    bool _checkpointRequired = true;
+    uint32_t _lastFlush = 0;
+};
+
+extern EnergyLogClass EnergyLog;
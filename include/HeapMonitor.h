@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <HeapAccounting.h>
+#include <TaskSchedulerDeclarations.h>
+#include <cstdint>
+
+#define HEAP_MONITOR_INTERVAL 10 // Seconds between two samples
+
+class HeapMonitorClass {
+public:
+    HeapMonitorClass();
+    void init(Scheduler& scheduler);
+
+    // 0 if the whole free heap is one block, approaching 100 if it is split into many small blocks
+    uint8_t getFragmentation() const;
+    uint8_t getFragmentationMax() const;
+
+    // Allocations per second during the last interval
+    float getAllocationRate(const HeapTag_t tag) const;
+
+private:
+    void loop();
+
+    Task _loopTask;
+
+    uint8_t _fragmentation = 0;
+    uint8_t _fragmentationMax = 0;
+
+    uint32_t _lastAllocations[HEAP_TAG_COUNT] = {};
+    float _allocationRate[HEAP_TAG_COUNT] = {};
+};
+
+extern HeapMonitorClass HeapMonitor;
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+#include <TaskSchedulerDeclarations.h>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#define INVERTER_PERSISTENCE_MAGIC 0x4944544f // "ODTI"
+#define INVERTER_PERSISTENCE_FORMAT 1
+#define INVERTER_PERSISTENCE_INTERVAL (10 * TASK_SECOND)
+#define INVERTER_PERSISTENCE_STATS_INTERVAL (15 * 60) // Minimum seconds between two statistic snapshots
+
+class InverterAbstract;
+
+class InverterPersistenceClass {
+public:
+    InverterPersistenceClass();
+    void init(Scheduler& scheduler);
+
+    // Restores DevInfo, grid profile and limit of all inverters. The restored
+    // data is marked as stale until it was received from the inverter again.
+    void restoreAll();
+
+    // Writes all inverters whose data changed since the last save
+    void flush();
+
+    // Deletes the persisted data of a removed inverter
+    void remove(const uint64_t serial);
+
+private:
+    void loop();
+
+    struct InverterState_t {
+        uint64_t Serial;
+        uint32_t MetadataCrc;
+        uint32_t StatisticsUpdate;
+        uint32_t StatisticsSaved; // Uptime in seconds
+        bool StatisticsRestorePending;
+    };
+
+    InverterState_t* getState(const uint64_t serial);
+    bool restore(InverterAbstract* inv, const bool restoreStatistics);
+    bool save(InverterAbstract* inv, const bool saveStatistics);
+    void process(const bool force);
+
+    static String getFilename(const uint64_t serial);
+
+    Task _loopTask;
+    std::mutex _mutex;
+
+    std::vector<InverterState_t> _states;
+};
+
+extern InverterPersistenceClass InverterPersistence;
@@ -2,10 +2,17 @@
 #pragma once
 
 #include <TaskSchedulerDeclarations.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <cstdint>
 
 #define INVERTER_UPDATE_SETTINGS_INTERVAL 60000l
 
+#define HOY_TASK_NAME "hoymiles"
+#define HOY_TASK_STACK_SIZE 8192
+#define HOY_TASK_PRIORITY 2 // Above loopTask
+#define HOY_TASK_IDLE_WAIT 10 // Max sleep if all radios are idle (ms)
+
 class InverterSettingsClass {
 public:
     InverterSettingsClass();
@@ -13,10 +20,10 @@ public:
 
 private:
     void settingsLoop();
-    void hoyLoop();
+    static void hoyTask(void* parameter);
 
     Task _settingsTask;
-    Task _hoyTask;
+    TaskHandle_t _hoyTaskHandle = nullptr;
 };
 
 extern InverterSettingsClass InverterSettings;
@@ -38,6 +38,11 @@ private:
     Ticker _mqttReconnectTimer;
     MqttSubscribeParser _mqttSubscribeParser;
     std::mutex _clientLock;
+
+    // Only loaded from flash while a TLS connection is used
+    String _tlsRootCaCert;
+    String _tlsClientCert;
+    String _tlsClientKey;
 };
 
 extern MqttSettingsClass MqttSettings;
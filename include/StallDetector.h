@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <functional>
+
+#define STALL_THRESHOLD_MS 100 // Duration of a main loop iteration which is considered a stall
+#define STALL_CHECK_INTERVAL_MS 25
+#define STALL_RECORD_COUNT 8
+#define STALL_TRACE_DEPTH 3
+#define STALL_NAME_LENGTH 24
+#define STALL_TASK_SLOTS 8 // Tasks which can be within a scope at the same time
+
+enum StallContext_t {
+    STALL_CONTEXT_LOOP, // Scheduler tasks within the main loop
+    STALL_CONTEXT_WEB, // Web server request handlers
+    STALL_CONTEXT_MODBUS, // Modbus TCP workers
+    STALL_CONTEXT_COUNT,
+};
+
+struct StallRecord_t {
+    uint32_t BootCount;
+    uint32_t Uptime; // Seconds since boot when the stall was detected
+    uint32_t DurationMs; // Updated while the stall lasts
+    bool Finished; // False if the iteration did not finish before the record was read or the device was reset
+    uint8_t Depth[STALL_CONTEXT_COUNT];
+    char Trace[STALL_CONTEXT_COUNT][STALL_TRACE_DEPTH][STALL_NAME_LENGTH]; // Outermost activity first
+};
+
+// Watches the duration of every main loop iteration. If an iteration takes
+// longer than STALL_THRESHOLD_MS the activities which were running at that
+// time are recorded. The records are kept in RTC memory and therefore
+// survive a software or watchdog reset.
+class StallDetectorClass {
+public:
+    void init();
+
+    // Has to be called at the start of every main loop iteration
+    void beginIteration();
+
+    // Marks the lifetime of an activity which should be named in stall records.
+    // Activities are tracked per task. The context of a nested scope is
+    // ignored, the trace belongs to the context of the outermost scope of
+    // that task. Scopes of the loop context only count within the loop task.
+    class Scope {
+    public:
+        explicit Scope(const char* name, const StallContext_t context = STALL_CONTEXT_LOOP);
+        ~Scope();
+
+    private:
+        int8_t _slot; // -1 if no slot was available
+        uint8_t _depth;
+    };
+
+    uint32_t getBootCount() const;
+
+    // Calls onRecord for all stored records, oldest first
+    void getRecords(const std::function<void(const StallRecord_t&)>& onRecord);
+
+private:
+    static void checkCallback(void* arg);
+    void check();
+
+    struct Activity_t {
+        TaskHandle_t Task; // nullptr if the slot is free
+        StallContext_t Context;
+        uint8_t Depth;
+        char Names[STALL_TRACE_DEPTH][STALL_NAME_LENGTH];
+    };
+
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+    Activity_t _activities[STALL_TASK_SLOTS] = {};
+    TaskHandle_t _loopTask = nullptr;
+
+    std::atomic<int64_t> _iterationStart { 0 };
+    std::atomic<StallRecord_t*> _activeRecord { nullptr }; // Record of the current iteration if it stalls
+    int64_t _recordStart = 0; // Start of the iteration belonging to _activeRecord
+
+    esp_timer_handle_t _timer = nullptr;
+};
+
+extern StallDetectorClass StallDetector;
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <TaskSchedulerDeclarations.h>
+#include <cstdint>
+
+#define TASK_PROFILE_BUCKETS 16
+#define TASK_PROFILE_FIRST_BUCKET_US 16 // Upper bound of the first bucket, every further bucket doubles
+
+class TaskProfilerClass {
+public:
+    struct Profile_t {
+        const char* Name;
+        uint32_t Count;
+        uint64_t TotalUs;
+        uint32_t MaxUs;
+        uint32_t Overruns; // Invocations which took longer than the interval of the task
+        uint32_t Buckets[TASK_PROFILE_BUCKETS];
+        Profile_t* Next;
+    };
+
+    void init(Scheduler& scheduler);
+
+    // Returns a callback which measures the runtime of every invocation of callback.
+    // Can already be used in the constructors of other global objects.
+    static TaskCallback wrap(const char* name, TaskCallback callback);
+
+    // Profiles are only updated within the loop task and read without
+    // locking. Values of a running task can therefore be slightly off.
+    const Profile_t* getFirstProfile() const;
+
+    // Upper bound of the duration in us which covers percent of all invocations
+    static uint32_t getPercentile(const Profile_t& profile, const uint8_t percent);
+
+private:
+    void addSample(Profile_t& profile, const uint32_t cycles);
+
+    static Profile_t* _firstProfile;
+
+    Scheduler* _scheduler = nullptr;
+    uint32_t _cpuFreqMHz = 240;
+};
+
+extern TaskProfilerClass TaskProfiler;
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+#include <TaskSchedulerDeclarations.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define TIMESERIES_SAMPLE_INTERVAL 10 // Seconds between samples of the finest level
+#define TIMESERIES_GAP INT16_MIN // Marks a sample without any data
+#define TIMESERIES_MIN_FREE_HEAP (32 * 1024) // Keep at least this amount of heap free when allocating new series
+
+// Boards without PSRAM have to place all series in internal RAM which is
+// also required by TLS and the web server. Both values can be overridden by
+// build flags, a budget of 0 disables the time series on these boards.
+#ifndef TIMESERIES_INTERNAL_BUDGET
+#define TIMESERIES_INTERNAL_BUDGET (30 * 1024) // Bytes all series may use together
+#endif
+#ifndef TIMESERIES_INTERNAL_LEVELS
+#define TIMESERIES_INTERNAL_LEVELS 2 // Resolutions kept, the 15 min level (7 days) is dropped
+#endif
+
+enum class TimeSeriesField : uint8_t {
+    AcPower,
+    DcPower,
+    YieldDay,
+    Temperature,
+    Count,
+};
+
+enum class TimeSeriesResolution : uint8_t {
+    Sec10, // 10 s for 1 h
+    Min1, // 1 min for 24 h
+    Min15, // 15 min for 7 days
+    Count,
+};
+
+class TimeSeriesClass {
+public:
+    TimeSeriesClass();
+    void init(Scheduler& scheduler);
+
+    static bool parseField(const String& name, TimeSeriesField& field);
+    static const char* getFieldName(const TimeSeriesField field);
+    static const char* getFieldUnit(const TimeSeriesField field);
+    static uint16_t getInterval(const TimeSeriesResolution resolution);
+    static uint16_t getDepth(const TimeSeriesResolution resolution);
+
+    // Amount of resolutions which are recorded, starting with the finest one
+    uint8_t getLevelCount() const;
+
+    // Returns the finest recorded resolution whose history still covers the given age in seconds
+    TimeSeriesResolution getResolutionForAge(const uint32_t age) const;
+
+    // Calls onValue for every sample of the inverter which started between maxAge and minAge
+    // seconds ago, oldest first. The age of the sample start is passed together with the value,
+    // gaps are passed as NAN. Returns false if there is no series for the inverter.
+    bool query(const uint64_t serial, const TimeSeriesField field, const TimeSeriesResolution resolution,
+        const uint32_t maxAge, const uint32_t minAge, const std::function<void(uint32_t, float)>& onValue);
+
+private:
+    void loop();
+
+    struct Accumulator_t {
+        int32_t Sum;
+        uint16_t Count;
+        int16_t Last;
+    };
+
+    struct Ring_t {
+        std::unique_ptr<int16_t[]> Data;
+        uint16_t Head; // Position of the next sample
+        uint16_t Count;
+    };
+
+    struct Series_t {
+        uint64_t Serial;
+        uint32_t LastUpdate; // Last statistics update which was fed into the series
+        Ring_t Rings[static_cast<uint8_t>(TimeSeriesResolution::Count)][static_cast<uint8_t>(TimeSeriesField::Count)];
+        Accumulator_t Accumulators[static_cast<uint8_t>(TimeSeriesResolution::Count)][static_cast<uint8_t>(TimeSeriesField::Count)];
+    };
+
+    size_t getSeriesSize() const;
+    Series_t* getSeries(const uint64_t serial, const bool create);
+    void push(Series_t& series, const uint8_t level, const uint8_t field, const int16_t value);
+
+    Task _loopTask;
+    std::mutex _mutex;
+
+    std::vector<std::unique_ptr<Series_t>> _series;
+    uint8_t _levelCount = static_cast<uint8_t>(TimeSeriesResolution::Count);
+    size_t _budget = SIZE_MAX; // Bytes all series may use together
+    uint32_t _samples = 0; // Amount of finest level samples since start
+    uint32_t _startTime = 0; // millis() of the start of the first sample
+};
+
+extern TimeSeriesClass TimeSeries;
@@ -1,9 +1,11 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "WebApi_config.h"
 #include "WebApi_device.h"
 #include "WebApi_devinfo.h"
 #include "WebApi_dtu.h"
+#include "WebApi_energy.h"
 #include "WebApi_errors.h"
 #include "WebApi_eventlog.h"
 #include "WebApi_file.h"
@@ -20,7 +22,9 @@
 #include "WebApi_power.h"
 #include "WebApi_prometheus.h"
 #include "WebApi_security.h"
+#include "WebApi_stall.h"
 #include "WebApi_sysstatus.h"
+#include "WebApi_timeseries.h"
 #include "WebApi_webapp.h"
 #include "WebApi_ws_console.h"
 #include "WebApi_ws_live.h"
@@ -48,9 +52,11 @@ public:
 private:
     AsyncWebServer _server;
 
+    WebApiConfigClass _webApiConfig;
     WebApiDeviceClass _webApiDevice;
     WebApiDevInfoClass _webApiDevInfo;
     WebApiDtuClass _webApiDtu;
+    WebApiEnergyClass _webApiEnergy;
     WebApiEventlogClass _webApiEventlog;
     WebApiFileClass _webApiFile;
     WebApiFirmwareClass _webApiFirmware;
@@ -66,7 +72,9 @@ private:
     WebApiPowerClass _webApiPower;
     WebApiPrometheusClass _webApiPrometheus;
     WebApiSecurityClass _webApiSecurity;
+    WebApiStallClass _webApiStall;
     WebApiSysstatusClass _webApiSysstatus;
+    WebApiTimeSeriesClass _webApiTimeSeries;
     WebApiWebappClass _webApiWebapp;
     WebApiWsConsoleClass _webApiWsConsole;
     WebApiWsLiveClass _webApiWsLive;
@@ -17,6 +17,15 @@ private:
 
     void addPanelInfo(AsyncResponseStream* stream, const String& serial, const uint8_t idx, std::shared_ptr<InverterAbstract> inv, const ChannelType_t type, const ChannelNum_t channel);
 
+    void addTaskProfiles(AsyncResponseStream* stream);
+
+    void addHeapTags(AsyncResponseStream* stream);
+
+    void addRadioHistograms(AsyncResponseStream* stream);
+
+    // Prints the samples of a histogram, scale converts the values to the base unit of the metric
+    void addHistogram(AsyncResponseStream* stream, const char* name, const String& labels, const Histogram& histogram, const double scale = 1);
+
     enum MetricType_t {
         NONE = 0,
         GAUGE,
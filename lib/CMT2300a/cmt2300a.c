@@ -770,9 +770,13 @@ bool CMT2300A_Init(void)
  * *********************************************************/
 bool CMT2300A_ConfigRegBank(uint8_t base_addr, const uint8_t bank[], uint8_t len)
 {
+    cmt_spi3_reg_t regs[len];
     uint8_t i;
-    for (i = 0; i < len; i++)
-        CMT2300A_WriteReg(i + base_addr, bank[i]);
+    for (i = 0; i < len; i++) {
+        regs[i].addr = i + base_addr;
+        regs[i].dat = bank[i];
+    }
+    CMT2300A_WriteRegs(regs, len);
 
     return true;
 }
@@ -53,6 +53,17 @@ void CMT2300A_WriteReg(const uint8_t addr, const uint8_t dat)
     cmt_spi3_write(addr, dat);
 }
 
+/*! ********************************************************
+ * @name    CMT2300A_WriteRegs
+ * @desc    Write multiple CMT2300A registers in one SPI bus session.
+ * @param   regs: register addresses and values
+ *          len: number of registers
+ * *********************************************************/
+void CMT2300A_WriteRegs(const cmt_spi3_reg_t regs[], const uint8_t len)
+{
+    cmt_spi3_write_regs(regs, len);
+}
+
 /*! ********************************************************
  * @name    CMT2300A_ReadFifo
  * @desc    Reads the contents of the CMT2300A FIFO.
@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <Arduino.h>
+#include "cmt_spi3.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,6 +41,7 @@ void CMT2300A_InitSpi(const int8_t pin_sdio, const int8_t pin_clk, const int8_t
 
 uint8_t CMT2300A_ReadReg(const uint8_t addr);
 void CMT2300A_WriteReg(const uint8_t addr, const uint8_t dat);
+void CMT2300A_WriteRegs(const cmt_spi3_reg_t regs[], const uint8_t len);
 
 void CMT2300A_ReadFifo(uint8_t buf[], const uint16_t len);
 void CMT2300A_WriteFifo(const uint8_t buf[], const uint16_t len);
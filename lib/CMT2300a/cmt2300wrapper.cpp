@@ -29,11 +29,13 @@ bool CMT2300A::isChipConnected()
 bool CMT2300A::startListening(void)
 {
     CMT2300A_GoStby();
-    CMT2300A_ClearInterruptFlags();
 
     /* Must clear FIFO after enable SPI to read or write the FIFO */
-    CMT2300A_EnableReadFifo();
-    CMT2300A_ClearRxFifo();
+    cmt_spi3_reg_t regs[4];
+    uint8_t len = _clearInterruptFlags(regs);
+    len += _selectFifo(false, &regs[len]);
+    regs[len++] = { CMT2300A_CUS_FIFO_CLR, CMT2300A_MASK_FIFO_CLR_RX };
+    CMT2300A_WriteRegs(regs, len);
 
     if (!CMT2300A_GoRx()) {
         return false;
@@ -67,15 +69,34 @@ void CMT2300A::read(void* buf, const uint8_t len)
 }
 
 bool CMT2300A::write(const uint8_t* buf, const uint8_t len)
+{
+    if (!startTransmit(buf, len)) {
+        return false;
+    }
+
+    uint32_t timer = millis();
+
+    while (!isTransmitDone()) {
+        if (millis() - timer > CMT_TX_TIMEOUT) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CMT2300A::startTransmit(const uint8_t* buf, const uint8_t len)
 {
     CMT2300A_GoStby();
-    CMT2300A_ClearInterruptFlags();
 
     /* Must clear FIFO after enable SPI to read or write the FIFO */
-    CMT2300A_EnableWriteFifo();
-    CMT2300A_ClearTxFifo();
+    cmt_spi3_reg_t regs[5];
+    uint8_t regLen = _clearInterruptFlags(regs);
+    regLen += _selectFifo(true, &regs[regLen]);
+    regs[regLen++] = { CMT2300A_CUS_FIFO_CLR, CMT2300A_MASK_FIFO_CLR_TX };
+    regs[regLen++] = { CMT2300A_CUS_PKT15, len }; // set Tx length
+    CMT2300A_WriteRegs(regs, regLen);
 
-    CMT2300A_WriteReg(CMT2300A_CUS_PKT15, len); // set Tx length
     /* The length need be smaller than 32 */
     CMT2300A_WriteFifo(buf, len);
 
@@ -83,32 +104,41 @@ bool CMT2300A::write(const uint8_t* buf, const uint8_t len)
         return false;
     }
 
-    if (!CMT2300A_GoTx()) {
-        return false;
-    }
-
-    uint32_t timer = millis();
+    return CMT2300A_GoTx();
+}
 
-    while (!(CMT2300A_MASK_TX_DONE_FLG & CMT2300A_ReadReg(CMT2300A_CUS_INT_CLR1))) {
-        if (millis() - timer > 95) {
-            return false;
-        }
+bool CMT2300A::isTransmitDone()
+{
+    if (!(CMT2300A_MASK_TX_DONE_FLG & CMT2300A_ReadReg(CMT2300A_CUS_INT_CLR1))) {
+        return false;
     }
 
-    CMT2300A_ClearInterruptFlags();
-    CMT2300A_GoSleep();
-
+    finishTransmit();
     return true;
 }
 
+void CMT2300A::finishTransmit()
+{
+    // Stay in standby mode. Flags are cleared by startListening(), which
+    // would have to wake up the chip from sleep mode otherwise.
+    CMT2300A_GoStby();
+}
+
 void CMT2300A::setChannel(const uint8_t channel)
 {
+    if (channel == _channel) {
+        return;
+    }
     CMT2300A_SetFrequencyChannel(channel);
+    _channel = channel;
 }
 
 uint8_t CMT2300A::getChannel(void)
 {
-    return CMT2300A_ReadReg(CMT2300A_CUS_FREQ_CHNL);
+    if (_channel == CMT_CHANNEL_UNKNOWN) {
+        _channel = CMT2300A_ReadReg(CMT2300A_CUS_FREQ_CHNL);
+    }
+    return _channel;
 }
 
 uint8_t CMT2300A::getDynamicPayloadSize(void)
@@ -264,6 +294,32 @@ void CMT2300A::flush_rx(void)
     CMT2300A_ClearRxFifo();
 }
 
+uint8_t CMT2300A::_clearInterruptFlags(cmt_spi3_reg_t regs[])
+{
+    // Clear all flags unconditionally instead of reading them first
+    regs[0] = { CMT2300A_CUS_INT_CLR1, CMT2300A_MASK_SL_TMO_CLR | CMT2300A_MASK_RX_TMO_CLR | CMT2300A_MASK_TX_DONE_CLR };
+    regs[1] = { CMT2300A_CUS_INT_CLR2, CMT2300A_MASK_LBD_CLR | CMT2300A_MASK_PREAM_OK_CLR | CMT2300A_MASK_SYNC_OK_CLR | CMT2300A_MASK_NODE_OK_CLR | CMT2300A_MASK_CRC_OK_CLR | CMT2300A_MASK_PKT_DONE_CLR };
+    return 2;
+}
+
+uint8_t CMT2300A::_selectFifo(const bool write, cmt_spi3_reg_t regs[])
+{
+    uint8_t fifoCtl = _fifoCtl;
+    if (write) {
+        fifoCtl |= CMT2300A_MASK_SPI_FIFO_RD_WR_SEL | CMT2300A_MASK_FIFO_RX_TX_SEL;
+    } else {
+        fifoCtl &= ~(CMT2300A_MASK_SPI_FIFO_RD_WR_SEL | CMT2300A_MASK_FIFO_RX_TX_SEL);
+    }
+
+    if (fifoCtl == _fifoCtl) {
+        return 0;
+    }
+
+    _fifoCtl = fifoCtl;
+    regs[0] = { CMT2300A_CUS_FIFO_CTL, fifoCtl };
+    return 1;
+}
+
 bool CMT2300A::_init_pins()
 {
     CMT2300A_InitSpi(_pin_sdio, _pin_clk, _pin_cs, _pin_fcs, _spi_speed);
@@ -321,6 +377,9 @@ bool CMT2300A::_init_radio()
     /* Use a single 64-byte FIFO for either Tx or Rx */
     CMT2300A_EnableFifoMerge(true);
 
+    _fifoCtl = CMT2300A_ReadReg(CMT2300A_CUS_FIFO_CTL);
+    _channel = CMT_CHANNEL_UNKNOWN;
+
     /* Go to sleep for configuration to take effect */
     if (!CMT2300A_GoSleep()) {
         return false; // CMT2300A not switched to sleep mode!
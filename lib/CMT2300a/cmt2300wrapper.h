@@ -1,11 +1,14 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "cmt_spi3.h"
 #include <stdint.h>
 
 #define CMT2300A_ONE_STEP_SIZE 2500 // frequency channel step size for fast frequency hopping operation: One step size is 2.5 kHz.
 #define FH_OFFSET 100 // value * CMT2300A_ONE_STEP_SIZE = channel frequency offset
 #define CMT_SPI_SPEED 4000000 // 4 MHz
+#define CMT_CHANNEL_UNKNOWN 0xFF
+#define CMT_TX_TIMEOUT 95 // ms
 
 #define CMT_BASE_FREQ_900 900000000
 #define CMT_BASE_FREQ_860 860000000
@@ -64,8 +67,29 @@ public:
      */
     void read(void* buf, const uint8_t len);
 
+    /**
+     * Transmit a payload and wait until it was sent (blocking)
+     */
     bool write(const uint8_t* buf, const uint8_t len);
 
+    /**
+     * Start the transmission of a payload and return immediately.
+     * Completion is signaled by the TX_DONE interrupt (GPIO2) or can be polled
+     * using isTransmitDone(). Afterwards finishTransmit() has to be called
+     * (isTransmitDone() does this implicitly).
+     */
+    bool startTransmit(const uint8_t* buf, const uint8_t len);
+
+    /**
+     * Check if the transmission started by startTransmit() is done
+     */
+    bool isTransmitDone();
+
+    /**
+     * Put the chip back to standby after a transmission
+     */
+    void finishTransmit();
+
     /**
      * Set RF communication channel. The frequency used by a channel is
      * @param channel Which RF channel to communicate on, 0-254
@@ -128,6 +152,10 @@ private:
      */
     bool _init_radio();
 
+    // Add the register writes required for the operation to regs and return their count
+    static uint8_t _clearInterruptFlags(cmt_spi3_reg_t regs[]);
+    uint8_t _selectFifo(const bool write, cmt_spi3_reg_t regs[]);
+
     int8_t _pin_sdio;
     int8_t _pin_clk;
     int8_t _pin_cs;
@@ -135,4 +163,8 @@ private:
     uint32_t _spi_speed;
 
     FrequencyBand_t _frequencyBand = FrequencyBand_t::BAND_860;
+
+    // Cached register contents to avoid redundant SPI transfers
+    uint8_t _channel = CMT_CHANNEL_UNKNOWN;
+    uint8_t _fifoCtl = 0;
 };
@@ -84,6 +84,37 @@ void cmt_spi3_write(const uint8_t addr, const uint8_t data)
     SPI_PARAM_UNLOCK();
 }
 
+void cmt_spi3_write_regs(const cmt_spi3_reg_t* regs, const uint8_t len)
+{
+    spi_transaction_ext_t trans {
+        .base {
+            .flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR,
+            .cmd = 0,
+            .addr = 0,
+            .length = 8,
+            .rxlength = 0,
+            .user = &cs_reg, // CS for register access
+            .tx_buffer = nullptr,
+            .rx_buffer = nullptr,
+        },
+        .command_bits = 1,
+        .address_bits = 7,
+        .dummy_bits = 0,
+    };
+
+    // Keep the bus for the whole sequence instead of locking and
+    // acquiring it for every single register
+    SPI_PARAM_LOCK();
+    spi_device_acquire_bus(spi, portMAX_DELAY);
+    for (uint8_t i = 0; i < len; i++) {
+        trans.base.addr = regs[i].addr;
+        trans.base.tx_buffer = &regs[i].dat;
+        ESP_ERROR_CHECK(spi_device_polling_transmit(spi, reinterpret_cast<spi_transaction_t*>(&trans)));
+    }
+    spi_device_release_bus(spi);
+    SPI_PARAM_UNLOCK();
+}
+
 uint8_t cmt_spi3_read(const uint8_t addr)
 {
     uint8_t data;
@@ -9,7 +9,13 @@ extern "C" {
 
 void cmt_spi3_init(const int8_t pin_sdio, const int8_t pin_clk, const int8_t pin_cs, const int8_t pin_fcs, const int32_t spi_speed);
 
+typedef struct {
+    uint8_t addr;
+    uint8_t dat;
+} cmt_spi3_reg_t;
+
 void cmt_spi3_write(const uint8_t addr, const uint8_t dat);
+void cmt_spi3_write_regs(const cmt_spi3_reg_t* regs, const uint8_t len);
 uint8_t cmt_spi3_read(const uint8_t addr);
 
 void cmt_spi3_write_fifo(const uint8_t* p_buf, const uint16_t len);
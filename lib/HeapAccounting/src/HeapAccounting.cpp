@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HeapAccounting.h"
+#include <cstdlib>
+#include <esp_heap_caps.h>
+
+HeapAccountingClass HeapAccounting;
+
+void* HeapAccountingClass::allocate(const HeapTag_t tag, const size_t size)
+{
+    void* ptr = malloc(size);
+    if (ptr != nullptr) {
+        add(tag, heap_caps_get_allocated_size(ptr));
+    }
+    return ptr;
+}
+
+void* HeapAccountingClass::reallocate(const HeapTag_t tag, void* ptr, const size_t size)
+{
+    const size_t oldSize = ptr != nullptr ? heap_caps_get_allocated_size(ptr) : 0;
+
+    void* newPtr = realloc(ptr, size);
+    if (newPtr != nullptr) {
+        remove(tag, oldSize);
+        add(tag, heap_caps_get_allocated_size(newPtr));
+    }
+    return newPtr;
+}
+
+void HeapAccountingClass::deallocate(const HeapTag_t tag, void* ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+    remove(tag, heap_caps_get_allocated_size(ptr));
+    free(ptr);
+}
+
+void HeapAccountingClass::add(const HeapTag_t tag, const size_t size)
+{
+    Counter_t& counter = _counters[tag];
+    counter.Allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const uint32_t live = counter.Live.fetch_add(size, std::memory_order_relaxed) + size;
+    uint32_t peak = counter.Peak.load(std::memory_order_relaxed);
+    while (live > peak && !counter.Peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+}
+
+void HeapAccountingClass::remove(const HeapTag_t tag, const size_t size)
+{
+    _counters[tag].Live.fetch_sub(size, std::memory_order_relaxed);
+}
+
+HeapAccountingClass::Stats_t HeapAccountingClass::getStats(const HeapTag_t tag) const
+{
+    const Counter_t& counter = _counters[tag];
+    return {
+        counter.Live.load(std::memory_order_relaxed),
+        counter.Peak.load(std::memory_order_relaxed),
+        counter.Allocations.load(std::memory_order_relaxed),
+    };
+}
+
+const char* HeapAccountingClass::getTagName(const HeapTag_t tag)
+{
+    static constexpr const char* names[HEAP_TAG_COUNT] = {
+        "radio",
+        "parser",
+        "json",
+        "mqtt",
+        "websocket",
+        "config",
+    };
+    return tag < HEAP_TAG_COUNT ? names[tag] : "unknown";
+}
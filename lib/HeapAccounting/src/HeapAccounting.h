@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+enum HeapTag_t : uint8_t {
+    HEAP_TAG_RADIO, // Queued and running radio commands
+    HEAP_TAG_PARSER, // Inverter payload parsers
+    HEAP_TAG_JSON, // Temporary JSON documents
+    HEAP_TAG_MQTT, // Documents and payloads built for MQTT
+    HEAP_TAG_WEBSOCKET, // Messages queued for websocket clients
+    HEAP_TAG_CONFIG, // Configuration and pin mapping documents
+    HEAP_TAG_COUNT,
+};
+
+// Counts the heap usage of allocations made on behalf of a subsystem. The
+// size of every block is taken from the heap itself, so the numbers include
+// the rounding of the allocator but not its block headers.
+class HeapAccountingClass {
+public:
+    struct Stats_t {
+        uint32_t Live; // Bytes currently allocated
+        uint32_t Peak; // Maximum of Live since boot
+        uint32_t Allocations; // Number of allocations since boot
+    };
+
+    void* allocate(const HeapTag_t tag, const size_t size);
+    void* reallocate(const HeapTag_t tag, void* ptr, const size_t size);
+    void deallocate(const HeapTag_t tag, void* ptr);
+
+    // For memory which is allocated elsewhere but owned by the subsystem
+    void add(const HeapTag_t tag, const size_t size);
+    void remove(const HeapTag_t tag, const size_t size);
+
+    Stats_t getStats(const HeapTag_t tag) const;
+    static const char* getTagName(const HeapTag_t tag);
+
+private:
+    struct Counter_t {
+        std::atomic<uint32_t> Live;
+        std::atomic<uint32_t> Peak;
+        std::atomic<uint32_t> Allocations;
+    };
+
+    Counter_t _counters[HEAP_TAG_COUNT] = {};
+};
+
+extern HeapAccountingClass HeapAccounting;
+
+// Standard allocator which accounts all its memory to a tag, e.g. for
+// std::allocate_shared or containers
+template <typename T>
+class HeapTaggedAllocator {
+public:
+    using value_type = T;
+
+    explicit HeapTaggedAllocator(const HeapTag_t tag)
+        : _tag(tag)
+    {
+    }
+
+    template <typename U>
+    HeapTaggedAllocator(const HeapTaggedAllocator<U>& other)
+        : _tag(other.getTag())
+    {
+    }
+
+    T* allocate(const size_t n)
+    {
+        void* ptr = HeapAccounting.allocate(_tag, n * sizeof(T));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, const size_t)
+    {
+        HeapAccounting.deallocate(_tag, ptr);
+    }
+
+    HeapTag_t getTag() const
+    {
+        return _tag;
+    }
+
+    template <typename U>
+    bool operator==(const HeapTaggedAllocator<U>& other) const
+    {
+        return _tag == other.getTag();
+    }
+
+    template <typename U>
+    bool operator!=(const HeapTaggedAllocator<U>& other) const
+    {
+        return _tag != other.getTag();
+    }
+
+private:
+    HeapTag_t _tag;
+};
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "HeapAccounting.h"
+#include <ArduinoJson.h>
+
+// Allocator for JsonDocument which accounts all its memory to a tag:
+//   JsonDocument doc(HeapTaggedJsonAllocator::get(HEAP_TAG_CONFIG));
+class HeapTaggedJsonAllocator : public ArduinoJson::Allocator {
+public:
+    static HeapTaggedJsonAllocator* get(const HeapTag_t tag)
+    {
+        static HeapTaggedJsonAllocator allocators[HEAP_TAG_COUNT] = {
+            HEAP_TAG_RADIO,
+            HEAP_TAG_PARSER,
+            HEAP_TAG_JSON,
+            HEAP_TAG_MQTT,
+            HEAP_TAG_WEBSOCKET,
+            HEAP_TAG_CONFIG,
+        };
+        return &allocators[tag];
+    }
+
+    void* allocate(size_t size) override
+    {
+        return HeapAccounting.allocate(_tag, size);
+    }
+
+    void deallocate(void* ptr) override
+    {
+        HeapAccounting.deallocate(_tag, ptr);
+    }
+
+    void* reallocate(void* ptr, size_t new_size) override
+    {
+        return HeapAccounting.reallocate(_tag, ptr, new_size);
+    }
+
+private:
+    HeapTaggedJsonAllocator(const HeapTag_t tag)
+        : _tag(tag)
+    {
+    }
+
+    HeapTag_t _tag;
+};
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "FragmentBuffer.h"
+#include "Hoymiles.h"
+#include "crc.h"
+#include <cstring>
+
+/*
+Every fragment of a response contains RF_FRAGMENT_DATA_SIZE bytes of payload,
+only the last one (marked with 0x80 in the fragment id) may be shorter or
+longer. Therefore the position of a fragment within the payload is known as
+soon as it is received, independent of the order in which the fragments
+arrive. The CRC16 covers the whole payload and is updated whenever the next
+fragment in order becomes available. Should an inverter ever send a shorter
+fragment in the middle, finish() moves the following fragments together.
+*/
+
+FragmentBuffer::FragmentBuffer()
+{
+    clear();
+}
+
+void FragmentBuffer::clear()
+{
+    _received = 0;
+    _lastId = 0;
+    _maxId = 0;
+    _length = 0;
+    _mainCmd = 0;
+    _mainCmdMismatch = false;
+    _crc = 0xffff;
+    _crcFragments = 0;
+    _crcValid = false;
+}
+
+bool FragmentBuffer::add(const uint8_t packet[], const uint8_t len)
+{
+    if (len < 11) {
+        Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) fragment too short\r\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    const uint8_t fragmentCount = packet[9];
+
+    // Packets with 0x81 will be seen as 1
+    const uint8_t fragmentId = fragmentCount & 0b01111111; // fragmentId is 1 based
+
+    // 0b10000000 == 0x80
+    const bool isLast = (fragmentCount & 0b10000000) == 0b10000000;
+
+    if (fragmentId == 0) {
+        Hoymiles.getMessageOutput()->println("ERROR: fragment id zero received and ignored");
+        return false;
+    }
+
+    if (fragmentId >= MAX_RF_FRAGMENT_COUNT) {
+        Hoymiles.getMessageOutput()->printf("ERROR: fragment id %" PRId8 " is too large for buffer and ignored\r\n", fragmentId);
+        return false;
+    }
+
+    const uint8_t dataLength = len - 11;
+    if (dataLength > (isLast ? MAX_RF_FRAGMENT_DATA_SIZE : RF_FRAGMENT_DATA_SIZE)) {
+        Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) fragment too large\r\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    // A retransmitted fragment is already in place and possibly part of the CRC
+    if (wasReceived(fragmentId)) {
+        return true;
+    }
+
+    memcpy(&_data[(fragmentId - 1) * RF_FRAGMENT_DATA_SIZE], &packet[10], dataLength);
+    _fragmentLength[fragmentId - 1] = dataLength;
+    _received |= 1 << (fragmentId - 1);
+
+    if (_lastId == 0) {
+        _mainCmd = packet[0];
+    } else if (packet[0] != _mainCmd) {
+        _mainCmdMismatch = true;
+    }
+
+    if (fragmentId > _lastId) {
+        _lastId = fragmentId;
+    }
+
+    if (isLast) {
+        _maxId = fragmentId;
+    }
+
+    updateCrc();
+    return true;
+}
+
+void FragmentBuffer::updateCrc()
+{
+    // The last fragment contains the CRC itself and is handled in finish()
+    while (_crcFragments < MAX_RF_FRAGMENT_COUNT
+        && wasReceived(_crcFragments + 1)
+        && _crcFragments + 1 != _maxId) {
+
+        _crc = crc16(&_data[_crcFragments * RF_FRAGMENT_DATA_SIZE], _fragmentLength[_crcFragments], _crc);
+        _crcFragments++;
+    }
+}
+
+void FragmentBuffer::finish()
+{
+    _crcValid = false;
+    _length = 0;
+
+    if (_maxId == 0) {
+        return;
+    }
+
+    // Close gaps of fragments which were shorter than expected
+    for (uint8_t i = 0; i < _maxId; i++) {
+        const uint8_t* src = &_data[i * RF_FRAGMENT_DATA_SIZE];
+        if (src != &_data[_length]) {
+            memmove(&_data[_length], src, _fragmentLength[i]);
+        }
+        _length += _fragmentLength[i];
+    }
+
+    const uint8_t lastLength = _fragmentLength[_maxId - 1];
+    if (_crcFragments + 1 != _maxId || lastLength < 2) {
+        return;
+    }
+
+    const uint16_t crc = crc16(&_data[_length - lastLength], lastLength - 2, _crc);
+    const uint16_t crcRcv = (_data[_length - 2] << 8) | _data[_length - 1];
+
+    _crcValid = crc == crcRcv;
+}
+
+bool FragmentBuffer::wasReceived(const uint8_t fragmentId) const
+{
+    return _received & (1 << (fragmentId - 1));
+}
+
+uint8_t FragmentBuffer::getLastId() const
+{
+    return _lastId;
+}
+
+uint8_t FragmentBuffer::getMaxId() const
+{
+    return _maxId;
+}
+
+bool FragmentBuffer::hasMainCmd(const uint8_t mainCmd) const
+{
+    return !_mainCmdMismatch && _mainCmd == mainCmd;
+}
+
+bool FragmentBuffer::isCrcValid() const
+{
+    return _crcValid;
+}
+
+const uint8_t* FragmentBuffer::getData() const
+{
+    return _data;
+}
+
+uint8_t FragmentBuffer::getLength() const
+{
+    return _length;
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+
+#define MAX_RF_FRAGMENT_COUNT 13
+
+// Payload bytes of every fragment except the last one of a response
+#define RF_FRAGMENT_DATA_SIZE 16
+
+// Payload bytes of a single packet without the header (10 bytes) and the CRC8
+#define MAX_RF_FRAGMENT_DATA_SIZE (MAX_RF_PAYLOAD_SIZE - 11)
+
+// Reassembles the fragments of a response in place. Every fragment is
+// written to its final position as soon as it is received and the CRC16 is
+// calculated over all fragments which are available without gaps. Once all
+// fragments are received finish() verifies the CRC and the payload can be
+// read as one contiguous buffer.
+class FragmentBuffer {
+public:
+    FragmentBuffer();
+
+    void clear();
+
+    // Stores the payload of a received packet. Returns false if the packet was ignored.
+    bool add(const uint8_t packet[], const uint8_t len);
+
+    // Has to be called once after all fragments up to getMaxId() were received
+    void finish();
+
+    // fragmentId is 1 based
+    bool wasReceived(const uint8_t fragmentId) const;
+
+    // Highest received fragment id
+    uint8_t getLastId() const;
+
+    // Id of the fragment containing the end marker or 0 if it was not received yet
+    uint8_t getMaxId() const;
+
+    // The following methods are only valid after finish()
+    bool hasMainCmd(const uint8_t mainCmd) const;
+    bool isCrcValid() const;
+    const uint8_t* getData() const;
+    uint8_t getLength() const; // Including the CRC16
+
+private:
+    void updateCrc();
+
+    uint8_t _data[(MAX_RF_FRAGMENT_COUNT - 1) * RF_FRAGMENT_DATA_SIZE + MAX_RF_FRAGMENT_DATA_SIZE];
+    uint8_t _fragmentLength[MAX_RF_FRAGMENT_COUNT];
+
+    uint16_t _received; // Bit n represents fragment id n + 1
+    uint8_t _lastId;
+    uint8_t _maxId;
+    uint8_t _length;
+
+    uint8_t _mainCmd;
+    bool _mainCmdMismatch;
+
+    uint16_t _crc;
+    uint8_t _crcFragments; // Amount of leading fragments which are already part of _crc
+    bool _crcValid;
+};
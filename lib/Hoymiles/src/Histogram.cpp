@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "Histogram.h"
+#include <cstring>
+
+Histogram::Histogram(const Histogram& other)
+    : _bounds(other._bounds)
+    , _boundCount(other._boundCount)
+{
+    portENTER_CRITICAL(&other._lock);
+    memcpy(_buckets, other._buckets, sizeof(_buckets));
+    _count = other._count;
+    _sum = other._sum;
+    portEXIT_CRITICAL(&other._lock);
+}
+
+void Histogram::add(const int32_t value)
+{
+    uint8_t i = 0;
+    while (i < _boundCount && value > _bounds[i]) {
+        i++;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    _buckets[i]++;
+    _count++;
+    _sum += value;
+    portEXIT_CRITICAL(&_lock);
+}
+
+void Histogram::reset()
+{
+    portENTER_CRITICAL(&_lock);
+    for (auto& bucket : _buckets) {
+        bucket = 0;
+    }
+    _count = 0;
+    _sum = 0;
+    portEXIT_CRITICAL(&_lock);
+}
+
+uint8_t Histogram::getBoundCount() const
+{
+    return _boundCount;
+}
+
+int32_t Histogram::getBound(const uint8_t index) const
+{
+    return _bounds[index];
+}
+
+uint32_t Histogram::getBucket(const uint8_t index) const
+{
+    return _buckets[index];
+}
+
+uint32_t Histogram::getCumulativeBucket(const uint8_t index) const
+{
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i <= index && i <= _boundCount; i++) {
+        sum += _buckets[i];
+    }
+    return sum;
+}
+
+uint32_t Histogram::getCount() const
+{
+    return _count;
+}
+
+int64_t Histogram::getSum() const
+{
+    return _sum;
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <freertos/FreeRTOS.h>
+
+#define HISTOGRAM_MAX_BOUNDS 12
+
+// Counts observations in buckets with fixed upper bounds (like a Prometheus
+// histogram). Values above the last bound are counted in an overflow bucket.
+// The bounds have to outlive the histogram.
+//
+// add() and reset() may run in another task than the readers. Readers take
+// a copy first, which is consistent in itself.
+class Histogram {
+public:
+    template <size_t N>
+    explicit Histogram(const int32_t (&bounds)[N])
+        : _bounds(bounds)
+        , _boundCount(N)
+    {
+        static_assert(N <= HISTOGRAM_MAX_BOUNDS, "Too many histogram bounds");
+    }
+
+    Histogram(const Histogram& other);
+    Histogram& operator=(const Histogram&) = delete;
+
+    void add(const int32_t value);
+    void reset();
+
+    uint8_t getBoundCount() const;
+    int32_t getBound(const uint8_t index) const;
+
+    // Number of observations within the bucket, index getBoundCount() is the overflow bucket
+    uint32_t getBucket(const uint8_t index) const;
+
+    // Number of observations less or equal than the bound, index getBoundCount() returns getCount()
+    uint32_t getCumulativeBucket(const uint8_t index) const;
+
+    uint32_t getCount() const;
+    int64_t getSum() const;
+
+private:
+    const int32_t* _bounds;
+    uint8_t _boundCount;
+
+    uint32_t _buckets[HISTOGRAM_MAX_BOUNDS + 1] = {};
+    uint32_t _count = 0;
+    int64_t _sum = 0;
+
+    mutable portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+};
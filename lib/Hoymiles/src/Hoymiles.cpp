@@ -37,6 +37,12 @@ void HoymilesClass::initCMT(const int8_t pin_sdio, const int8_t pin_clk, const i
     _radioCmt->init(pin_sdio, pin_clk, pin_cs, pin_fcs, pin_gpio2, pin_gpio3);
 }
 
+void HoymilesClass::setLoopTask(const TaskHandle_t task)
+{
+    _radioNrf->setLoopTask(task);
+    _radioCmt->setLoopTask(task);
+}
+
 void HoymilesClass::loop()
 {
     std::lock_guard<std::mutex> lock(_mutex);
@@ -77,9 +83,10 @@ void HoymilesClass::loop()
                 const bool force = iv->EventLog()->getLastAlarmRequestSuccess() == CMD_NOK;
                 iv->sendAlarmLogRequest(force);
 
-                // Fetch limit
-                if (((millis() - iv->SystemConfigPara()->getLastUpdateRequest() > HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL)
-                        && (millis() - iv->SystemConfigPara()->getLastUpdateCommand() > HOY_SYSTEM_CONFIG_PARA_POLL_MIN_DURATION))) {
+                // Fetch limit (immediately if it is not known at all)
+                const bool missingLimit = iv->SystemConfigPara()->getLastUpdate() == 0;
+                if (((missingLimit || millis() - iv->SystemConfigPara()->getLastUpdateRequest() > HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL)
+                        && (iv->SystemConfigPara()->getLastUpdateCommand() == 0 || millis() - iv->SystemConfigPara()->getLastUpdateCommand() > HOY_SYSTEM_CONFIG_PARA_POLL_MIN_DURATION))) {
                     _messageOutput->println("Request SystemConfigPara");
                     iv->sendSystemConfigParaRequest();
                 }
@@ -96,8 +103,14 @@ void HoymilesClass::loop()
                     iv->resendPowerControlRequest();
                 }
 
+                // Missing data is fetched as soon as stats were received once.
+                // Data restored from persistence is only refreshed after the
+                // stats have been confirmed by the inverter.
+                const bool hasStats = iv->Statistics()->getLastUpdate() > 0;
+                const bool hasFreshStats = hasStats && !iv->Statistics()->isStale();
+
                 // Fetch dev info (but first fetch stats)
-                if (iv->Statistics()->getLastUpdate() > 0) {
+                if (hasStats) {
                     const bool invalidDevInfo = !iv->DevInfo()->containsValidData()
                         && iv->DevInfo()->getLastUpdateAll() > 0
                         && iv->DevInfo()->getLastUpdateSimple() > 0;
@@ -108,14 +121,18 @@ void HoymilesClass::loop()
 
                     if ((iv->DevInfo()->getLastUpdateAll() == 0)
                         || (iv->DevInfo()->getLastUpdateSimple() == 0)
-                        || invalidDevInfo) {
+                        || invalidDevInfo
+                        || (hasFreshStats && iv->DevInfo()->isStale())) {
                         _messageOutput->println("Request device info");
                         iv->sendDevInfoRequest();
                     }
                 }
 
                 // Fetch grid profile
-                if (iv->Statistics()->getLastUpdate() > 0 && (iv->GridProfile()->getLastUpdate() == 0 || !iv->GridProfile()->containsValidData())) {
+                if (hasStats
+                    && (iv->GridProfile()->getLastUpdate() == 0
+                        || !iv->GridProfile()->containsValidData()
+                        || (hasFreshStats && iv->GridProfile()->isStale()))) {
                     iv->sendGridOnProFileParaRequest();
                 }
 
@@ -255,6 +272,11 @@ bool HoymilesClass::isAllRadioIdle() const
     return _radioNrf.get()->isIdle() && _radioCmt.get()->isIdle();
 }
 
+std::unique_lock<std::mutex> HoymilesClass::lockRadios()
+{
+    return std::unique_lock<std::mutex>(_mutex);
+}
+
 uint32_t HoymilesClass::PollInterval() const
 {
     return _pollInterval;
@@ -8,6 +8,7 @@
 #include <Print.h>
 #include <SPI.h>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #define HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL (2 * 60 * 1000) // 2 minutes
@@ -20,6 +21,9 @@ public:
     void initCMT(const int8_t pin_sdio, const int8_t pin_clk, const int8_t pin_cs, const int8_t pin_fcs, const int8_t pin_gpio2, const int8_t pin_gpio3);
     void loop();
 
+    // Task running loop(). It is woken up by the radio interrupts.
+    void setLoopTask(const TaskHandle_t task);
+
     void setMessageOutput(Print* output);
     Print* getMessageOutput();
 
@@ -38,6 +42,10 @@ public:
 
     bool isAllRadioIdle() const;
 
+    // Keeps loop() from running while another task accesses the radio
+    // hardware, e.g. to change its settings
+    std::unique_lock<std::mutex> lockRadios();
+
 private:
     std::vector<std::shared_ptr<InverterAbstract>> _inverters;
     std::unique_ptr<HoymilesRadio_NRF> _radioNrf;
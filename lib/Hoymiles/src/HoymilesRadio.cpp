@@ -28,20 +28,48 @@ serial_u HoymilesRadio::convertSerialToRadioId(const serial_u serial)
     return radioId;
 }
 
+void HoymilesRadio::setLoopTask(const TaskHandle_t task)
+{
+    _loopTask = task;
+}
+
+void ARDUINO_ISR_ATTR HoymilesRadio::notifyLoopTask()
+{
+    if (_loopTask == nullptr) {
+        return;
+    }
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(_loopTask, &higherPriorityTaskWoken);
+    if (higherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
 bool HoymilesRadio::checkFragmentCrc(const fragment_t& fragment) const
 {
     const uint8_t crc = crc8(fragment.fragment, fragment.len - 1);
     return (crc == fragment.fragment[fragment.len - 1]);
 }
 
-void HoymilesRadio::sendRetransmitPacket(const uint8_t fragment_id)
+void HoymilesRadio::sendRetransmitPackets(const uint16_t fragments)
 {
     CommandAbstract* cmd = _commandQueue.front().get();
 
-    CommandAbstract* requestCmd = cmd->getRequestFrameCommand(fragment_id);
+    // Request all missing fragments back-to-back and wait for the answers
+    // within a single RX period. The request frame command object can be
+    // reused as sendEsbPacket either transmits synchronously (NRF) or copies
+    // the payload into the TX queue (CMT).
+    for (uint8_t i = 0; i < MAX_RF_FRAGMENT_COUNT; i++) {
+        if (!(fragments & (1 << i))) {
+            continue;
+        }
+
+        CommandAbstract* requestCmd = cmd->getRequestFrameCommand(i + 1);
 
-    if (requestCmd != nullptr) {
-        sendEsbPacket(*requestCmd);
+        if (requestCmd != nullptr) {
+            sendEsbPacket(*requestCmd);
+        }
     }
 }
 
@@ -51,17 +79,59 @@ void HoymilesRadio::sendLastPacketAgain()
     sendEsbPacket(*cmd);
 }
 
+void HoymilesRadio::startRxPeriod(CommandAbstract& cmd)
+{
+    CommandAbstract* mainCmd = _commandQueue.front().get();
+
+    // Only periods started by the request itself (not by re-requests of
+    // single fragments) are used to learn the response latency.
+    _rxLatencySample = (&cmd == mainCmd);
+
+    uint32_t timeout = cmd.getTimeout();
+    if (_rxLatencySample && cmd.getSendCount() <= 1) {
+        auto inv = Hoymiles.getInverterBySerial(cmd.getTargetAddress());
+        if (nullptr != inv) {
+            timeout = inv->getRxTimeout(cmd);
+        }
+    }
+
+    _busyFlag = true;
+    _rxComplete = false;
+    _rxPeriodStart = millis();
+    _rxTimeout.set(timeout);
+}
+
+void HoymilesRadio::checkRxComplete(const InverterAbstract& inv)
+{
+    if (_busyFlag && inv.serial() == _commandQueue.front().get()->getTargetAddress()) {
+        _rxComplete = inv.isAllFragmentsReceived();
+    }
+}
+
 void HoymilesRadio::handleReceivedPackage()
 {
-    if (_busyFlag && _rxTimeout.occured()) {
-        Hoymiles.getMessageOutput()->println("RX Period End");
+    if (_busyFlag && (_rxComplete || _rxTimeout.occured())) {
+        Hoymiles.getMessageOutput()->println(_rxComplete ? "RX Complete" : "RX Period End");
         std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterBySerial(_commandQueue.front().get()->getTargetAddress());
 
         if (nullptr != inv) {
             CommandAbstract* cmd = _commandQueue.front().get();
+
+            if (_rxLatencySample) {
+                // If the end marker is missing, the timeout was most likely too short
+                inv->updateRxLatency(*cmd, inv->isLastFragmentReceived()
+                        ? inv->getLastFragmentTime() - _rxPeriodStart
+                        : cmd->getTimeout());
+            }
+
             uint8_t verifyResult = inv->verifyAllFragments(*cmd);
+            if (verifyResult != FRAGMENT_ALL_MISSING_RESEND && verifyResult != FRAGMENT_RETRANSMIT) {
+                updateCommandStats(*inv, *cmd, verifyResult == FRAGMENT_OK);
+            }
+
             if (verifyResult == FRAGMENT_ALL_MISSING_RESEND) {
                 Hoymiles.getMessageOutput()->println("Nothing received, resend whole request");
+                _commandRetransmits++;
                 sendLastPacketAgain();
 
             } else if (verifyResult == FRAGMENT_ALL_MISSING_TIMEOUT) {
@@ -71,8 +141,7 @@ void HoymilesRadio::handleReceivedPackage()
                     inv->RadioStats.RxFailNoAnswer++;
                 }
 
-                _commandQueue.pop();
-                _busyFlag = false;
+                finishCommand();
 
             } else if (verifyResult == FRAGMENT_RETRANSMIT_TIMEOUT) {
                 Hoymiles.getMessageOutput()->println("Retransmit timeout");
@@ -81,8 +150,7 @@ void HoymilesRadio::handleReceivedPackage()
                     inv->RadioStats.RxFailPartialAnswer++;
                 }
 
-                _commandQueue.pop();
-                _busyFlag = false;
+                finishCommand();
 
             } else if (verifyResult == FRAGMENT_HANDLE_ERROR) {
                 Hoymiles.getMessageOutput()->println("Packet handling error");
@@ -91,17 +159,17 @@ void HoymilesRadio::handleReceivedPackage()
                     inv->RadioStats.RxFailCorruptData++;
                 }
 
-                _commandQueue.pop();
-                _busyFlag = false;
+                finishCommand();
 
-            } else if (verifyResult > 0) {
+            } else if (verifyResult == FRAGMENT_RETRANSMIT) {
                 // Perform Retransmit
-                Hoymiles.getMessageOutput()->print("Request retransmit: ");
-                Hoymiles.getMessageOutput()->println(verifyResult);
+                const uint16_t missing = inv->getMissingFragments();
+                Hoymiles.getMessageOutput()->printf("Request retransmit of %d fragments\r\n", __builtin_popcount(missing));
                 // Statistics: Count TX Re-Request Fragment
-                inv->RadioStats.TxReRequestFragment++;
+                inv->RadioStats.TxReRequestFragment += __builtin_popcount(missing);
+                _commandRetransmits += __builtin_popcount(missing);
 
-                sendRetransmitPacket(verifyResult);
+                sendRetransmitPackets(missing);
 
             } else {
                 // Successful received all packages
@@ -109,10 +177,13 @@ void HoymilesRadio::handleReceivedPackage()
                 // Statistics: Count RX Success
                 if (inv->RadioStats.TxRequestData > 0) {
                     inv->RadioStats.RxSuccess++;
+
+                    const uint32_t completeTime = millis() - _commandStartTime;
+                    inv->RadioStats.RxCompleteTimeLast = completeTime;
+                    inv->RadioStats.RxCompleteTimeSum += completeTime;
                 }
 
-                _commandQueue.pop();
-                _busyFlag = false;
+                finishCommand();
             }
         } else {
             // If inverter was not found, assume the command is invalid
@@ -123,21 +194,90 @@ void HoymilesRadio::handleReceivedPackage()
         }
     } else if (!_busyFlag) {
         // Currently in idle mode --> send packet if one is in the queue
-        if (!isQueueEmpty()) {
-            CommandAbstract* cmd = _commandQueue.front().get();
+        sendNextCommand();
+    }
+}
 
-            auto inv = Hoymiles.getInverterBySerial(cmd->getTargetAddress());
-            if (nullptr != inv) {
-                inv->clearRxFragmentBuffer();
-                // Statistics: TX Requests
-                inv->RadioStats.TxRequestData++;
+void HoymilesRadio::sendNextCommand()
+{
+    while (!isQueueEmpty()) {
+        CommandAbstract* cmd = _commandQueue.front().get();
 
-                sendEsbPacket(*cmd);
-            } else {
-                Hoymiles.getMessageOutput()->println("TX: Invalid inverter found");
-                _commandQueue.pop();
-            }
+        auto inv = Hoymiles.getInverterBySerial(cmd->getTargetAddress());
+        if (nullptr != inv) {
+            inv->clearRxFragmentBuffer();
+            // Statistics: TX Requests
+            inv->RadioStats.TxRequestData++;
+
+            _commandStartTime = millis();
+            _commandRetransmits = 0;
+            sendEsbPacket(*cmd);
+            return;
+        }
+
+        Hoymiles.getMessageOutput()->println("TX: Invalid inverter found");
+        _commandQueue.pop();
+    }
+}
+
+void HoymilesRadio::updateCommandStats(const InverterAbstract& inv, const CommandAbstract& cmd, const bool success)
+{
+    if (inv.getFirstFragmentTime() > 0) {
+        RxLatency.add(inv.getFirstFragmentTime() - _commandStartTime);
+    }
+
+    const String name = cmd.getCommandName();
+    const uint8_t count = _commandStatsCount.load(std::memory_order_relaxed);
+
+    CommandStats_t* stats = nullptr;
+    for (uint8_t i = 0; i < count; i++) {
+        if (name == _commandStats[i].Name) {
+            stats = &_commandStats[i];
+            break;
+        }
+    }
+
+    if (stats == nullptr) {
+        if (count >= RF_COMMAND_STATS_SLOTS) {
+            return;
         }
+        stats = &_commandStats[count];
+        strlcpy(stats->Name, name.c_str(), sizeof(stats->Name));
+        _commandStatsCount.store(count + 1, std::memory_order_release);
+    }
+
+    if (success) {
+        stats->CompleteTime.add(millis() - _commandStartTime);
+    }
+    stats->Retransmits.add(_commandRetransmits);
+}
+
+uint8_t HoymilesRadio::getCommandStatsCount() const
+{
+    return _commandStatsCount.load(std::memory_order_acquire);
+}
+
+const HoymilesRadio::CommandStats_t& HoymilesRadio::getCommandStats(const uint8_t index) const
+{
+    return _commandStats[index];
+}
+
+uint64_t HoymilesRadio::getTxAirtime() const
+{
+    return _txAirtime;
+}
+
+void HoymilesRadio::finishCommand()
+{
+    const uint64_t target = _commandQueue.front().get()->getTargetAddress();
+    _commandQueue.pop();
+    _busyFlag = false;
+
+    // Continue the RF session: the next request to the same inverter is sent
+    // immediately while the inverter is still listening on the current
+    // channel instead of waiting for the next loop iteration.
+    if (!isQueueEmpty() && _commandQueue.front().get()->getTargetAddress() == target) {
+        sendNextCommand();
     }
 }
 
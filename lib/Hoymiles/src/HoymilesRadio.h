@@ -1,12 +1,27 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "Histogram.h"
 #include "commands/CommandAbstract.h"
 #include "types.h"
+#include <Arduino.h>
+#include <HeapAccounting.h>
 #include <ThreadSafeQueue.h>
 #include <TimeoutHelper.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
 #include <memory>
 
+#define RF_COMMAND_STATS_SLOTS 12
+#define RF_COMMAND_NAME_LENGTH 24
+
+// Upper bounds of the histogram buckets
+inline constexpr int32_t RF_LATENCY_BOUNDS_MS[] = { 5, 10, 20, 50, 100, 200, 500, 1000, 2000 };
+inline constexpr int32_t RF_COMPLETE_TIME_BOUNDS_MS[] = { 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+inline constexpr int32_t RF_RETRANSMIT_BOUNDS[] = { 0, 1, 2, 3, 5, 8, 13 };
+inline constexpr int32_t RF_RSSI_BOUNDS_DBM[] = { -100, -90, -80, -70, -60, -50, -40, -30 };
+
 class HoymilesRadio {
 public:
     serial_u DtuSerial() const;
@@ -21,10 +36,33 @@ public:
         _commandQueue.push(cmd);
     }
 
+    // Task which is notified if a radio interrupt occurs
+    void setLoopTask(const TaskHandle_t task);
+
+    struct CommandStats_t {
+        char Name[RF_COMMAND_NAME_LENGTH];
+
+        // Time from the first TX until the complete answer was received (ms)
+        Histogram CompleteTime { RF_COMPLETE_TIME_BOUNDS_MS };
+
+        // Resent requests and re-requested fragments per command
+        Histogram Retransmits { RF_RETRANSMIT_BOUNDS };
+    };
+
+    // Statistics of every command type which was sent at least once
+    uint8_t getCommandStatsCount() const;
+    const CommandStats_t& getCommandStats(const uint8_t index) const;
+
+    // Time from sending a request until the first fragment of the answer was received (ms)
+    Histogram RxLatency { RF_LATENCY_BOUNDS_MS };
+
+    // Time the radio was busy transmitting (us)
+    uint64_t getTxAirtime() const;
+
     template <typename T>
     std::shared_ptr<T> prepareCommand(InverterAbstract* inv)
     {
-        return std::make_shared<T>(inv);
+        return std::allocate_shared<T>(HeapTaggedAllocator<T>(HEAP_TAG_RADIO), inv);
     }
 
 protected:
@@ -33,14 +71,31 @@ protected:
 
     bool checkFragmentCrc(const fragment_t& fragment) const;
     virtual void sendEsbPacket(CommandAbstract& cmd) = 0;
-    void sendRetransmitPacket(const uint8_t fragment_id);
+    void sendRetransmitPackets(const uint16_t fragments);
     void sendLastPacketAgain();
     void handleReceivedPackage();
+    void ARDUINO_ISR_ATTR notifyLoopTask();
+    void sendNextCommand();
+    void finishCommand();
+    void startRxPeriod(CommandAbstract& cmd);
+    void checkRxComplete(const InverterAbstract& inv);
+    void updateCommandStats(const InverterAbstract& inv, const CommandAbstract& cmd, const bool success);
 
     serial_u _dtuSerial;
     ThreadSafeQueue<std::shared_ptr<CommandAbstract>> _commandQueue;
     bool _isInitialized = false;
     bool _busyFlag = false;
+    TaskHandle_t _loopTask = nullptr;
 
     TimeoutHelper _rxTimeout;
+    uint32_t _rxPeriodStart = 0;
+    bool _rxComplete = false;
+    bool _rxLatencySample = false;
+    uint32_t _commandStartTime = 0;
+    uint8_t _commandRetransmits = 0;
+
+    uint64_t _txAirtime = 0;
+
+    CommandStats_t _commandStats[RF_COMMAND_STATS_SLOTS] = {};
+    std::atomic<uint8_t> _commandStatsCount = 0; // Published after the name of a new slot was written
 };
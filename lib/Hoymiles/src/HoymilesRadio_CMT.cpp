@@ -6,6 +6,7 @@
 #include "Hoymiles.h"
 #include "crc.h"
 #include <FunctionalInterrupt.h>
+#include <algorithm>
 #include <frozen/map.h>
 
 constexpr CountryFrequencyDefinition_t make_value(FrequencyBand_t Band, uint32_t Freq_Legal_Min, uint32_t Freq_Legal_Max, uint32_t Freq_Default, uint32_t Freq_StartUp)
@@ -119,6 +120,24 @@ void HoymilesRadio_CMT::loop()
         return;
     }
 
+    if (_txPending) {
+        if (_packetSent) {
+            _radio->finishTransmit();
+            finishTransmit(false);
+        } else if (!_gpio2_configured && _radio->isTransmitDone()) {
+            // Without the TX_DONE interrupt the flag is polled on every loop iteration
+            finishTransmit(false);
+        } else if (_txTimeout.occured()) {
+            _radio->finishTransmit();
+            finishTransmit(true);
+        }
+
+        // Nothing can be received and the RX period has not started yet
+        if (_txPending || !_txQueue.empty()) {
+            return;
+        }
+    }
+
     if (!_gpio3_configured) {
         if (_radio->rxFifoAvailable()) { // read INT2, PKT_OK flag
             _packetReceived = true;
@@ -129,18 +148,16 @@ void HoymilesRadio_CMT::loop()
         Hoymiles.getMessageOutput()->println("Interrupt received");
         while (_radio->available()) {
             if (!(_rxBuffer.size() > FRAGMENT_BUFFER_SIZE)) {
-                fragment_t f;
+                // Read directly into the queue slot
+                fragment_t& f = _rxBuffer.emplace();
                 memset(f.fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
                 f.len = _radio->getDynamicPayloadSize();
                 f.channel = _radio->getChannel();
                 f.rssi = _radio->getRssiDBm();
-                f.wasReceived = false;
-                f.mainCmd = 0x00;
                 if (f.len > MAX_RF_PAYLOAD_SIZE) {
                     f.len = MAX_RF_PAYLOAD_SIZE;
                 }
                 _radio->read(f.fragment, f.len);
-                _rxBuffer.push(f);
             } else {
                 Hoymiles.getMessageOutput()->println("CMT: Buffer full");
                 _radio->flush_rx();
@@ -152,7 +169,7 @@ void HoymilesRadio_CMT::loop()
     } else {
         // Perform package parsing only if no packages are received
         if (!_rxBuffer.empty()) {
-            fragment_t f = _rxBuffer.back();
+            const fragment_t& f = _rxBuffer.back();
             if (checkFragmentCrc(f)) {
 
                 const serial_u dtuId = convertSerialToRadioId(_dtuSerial);
@@ -170,6 +187,7 @@ void HoymilesRadio_CMT::loop()
                         Hoymiles.getMessageOutput()->printf("| %" PRId8 " dBm\r\n", f.rssi);
 
                         inv->addRxFragment(f.fragment, f.len, f.rssi);
+                        checkRxComplete(*inv);
                     } else {
                         Hoymiles.getMessageOutput()->println("Inverter Not found!");
                     }
@@ -209,6 +227,11 @@ void HoymilesRadio_CMT::setInverterTargetFrequency(const uint32_t frequency)
     cmtSwitchDtuFreq(_inverterTargetFrequency);
 }
 
+uint32_t HoymilesRadio_CMT::getTxRxTurnaround() const
+{
+    return _txRxTurnaround;
+}
+
 uint32_t HoymilesRadio_CMT::getInverterTargetFrequency() const
 {
     return _inverterTargetFrequency;
@@ -255,11 +278,13 @@ uint32_t HoymilesRadio_CMT::getInvBootFrequency() const
 void ARDUINO_ISR_ATTR HoymilesRadio_CMT::handleInt1()
 {
     _packetSent = true;
+    notifyLoopTask();
 }
 
 void ARDUINO_ISR_ATTR HoymilesRadio_CMT::handleInt2()
 {
     _packetReceived = true;
+    notifyLoopTask();
 }
 
 void HoymilesRadio_CMT::sendEsbPacket(CommandAbstract& cmd)
@@ -268,21 +293,78 @@ void HoymilesRadio_CMT::sendEsbPacket(CommandAbstract& cmd)
 
     cmd.setRouterAddress(DtuSerial().u64);
 
-    _radio->stopListening();
+    const bool isChannelChange = cmd.getDataPayload()[0] == 0x56; // @todo(tbnobody) Bad hack to identify ChannelChange Command
+
+    Hoymiles.getMessageOutput()->printf("TX %s %.2f MHz --> ",
+        cmd.getCommandName().c_str(),
+        (isChannelChange ? getInvBootFrequency() : getInverterTargetFrequency()) / 1000000.0);
+    cmd.dumpDataPayload(Hoymiles.getMessageOutput());
+
+    TxPacket_t packet;
+    packet.len = std::min<uint8_t>(cmd.getDataSize(), MAX_RF_PAYLOAD_SIZE);
+    memcpy(packet.data, cmd.getDataPayload(), packet.len);
+    packet.isChannelChange = isChannelChange;
+    _txQueue.push(packet);
+
+    if (!_txPending) {
+        startNextTransmit();
+    }
+
+    // The RX period is restarted once all queued packets are sent
+    startRxPeriod(cmd);
+}
+
+void HoymilesRadio_CMT::startNextTransmit()
+{
+    const TxPacket_t& packet = _txQueue.front();
 
-    if (cmd.getDataPayload()[0] == 0x56) { // @todo(tbnobody) Bad hack to identify ChannelChange Command
+    // startTransmit() switches directly from RX to standby. Going to sleep mode
+    // first would require a slow wake up of the chip.
+    _txChannelChange = packet.isChannelChange;
+    if (_txChannelChange) {
         cmtSwitchDtuFreq(getInvBootFrequency());
     }
 
-    Hoymiles.getMessageOutput()->printf("TX %s %.2f MHz --> ",
-        cmd.getCommandName().c_str(), getFrequencyFromChannel(_radio->getChannel()) / 1000000.0);
-    cmd.dumpDataPayload(Hoymiles.getMessageOutput());
+    _packetSent = false;
+    _txPending = true;
+    _txStart = micros();
+    _txTimeout.set(CMT_TX_TIMEOUT);
+
+    const bool started = _radio->startTransmit(packet.data, packet.len);
+    _txQueue.pop();
+
+    if (!started) {
+        Hoymiles.getMessageOutput()->println("TX SPI Error");
+        // Nothing will be sent, so there is no need to wait for the TX timeout
+        _radio->finishTransmit();
+        finishTransmit(false);
+    }
+}
+
+void HoymilesRadio_CMT::finishTransmit(const bool timeout)
+{
+    _txPending = false;
+    _packetSent = false;
 
-    if (!_radio->write(cmd.getDataPayload(), cmd.getDataSize())) {
+    if (timeout) {
         Hoymiles.getMessageOutput()->println("TX SPI Timeout");
     }
-    cmtSwitchDtuFreq(_inverterTargetFrequency);
+
+    const uint32_t txDone = micros();
+    _txAirtime += txDone - _txStart;
+    if (_txChannelChange) {
+        cmtSwitchDtuFreq(_inverterTargetFrequency);
+    }
+
+    if (!_txQueue.empty()) {
+        startNextTransmit();
+        return;
+    }
+
     _radio->startListening();
-    _busyFlag = true;
-    _rxTimeout.set(cmd.getTimeout());
+    _txRxTurnaround = micros() - txDone;
+
+    // Answers can only be received from now on
+    _rxPeriodStart = millis();
+    _rxTimeout.reset();
 }
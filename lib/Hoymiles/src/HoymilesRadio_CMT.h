@@ -47,6 +47,9 @@ public:
     void setInverterTargetFrequency(const uint32_t frequency);
     uint32_t getInverterTargetFrequency() const;
 
+    // Time from TX done until the radio is listening again (us)
+    uint32_t getTxRxTurnaround() const;
+
     bool isConnected() const;
 
     uint32_t getMinFrequency() const;
@@ -71,6 +74,8 @@ private:
     void ARDUINO_ISR_ATTR handleInt2();
 
     void sendEsbPacket(CommandAbstract& cmd);
+    void startNextTransmit();
+    void finishTransmit(const bool timeout);
 
     std::unique_ptr<CMT2300A> _radio;
 
@@ -81,9 +86,22 @@ private:
     bool _gpio3_configured = false;
 
     std::queue<fragment_t> _rxBuffer;
+
+    // Packets are sent asynchronously. Further packets (e.g. re-requests of
+    // several fragments) are queued until the current transmission is done.
+    struct TxPacket_t {
+        uint8_t data[MAX_RF_PAYLOAD_SIZE];
+        uint8_t len;
+        bool isChannelChange;
+    };
+    std::queue<TxPacket_t> _txQueue;
+    bool _txPending = false;
+    bool _txChannelChange = false;
     TimeoutHelper _txTimeout;
+    uint32_t _txStart = 0;
 
     uint32_t _inverterTargetFrequency = HOYMILES_CMT_WORK_FREQ;
+    uint32_t _txRxTurnaround = 0;
 
     bool cmtSwitchDtuFreq(const uint32_t to_frequency);
 
@@ -7,6 +7,12 @@
 #include "commands/RequestFrameCommand.h"
 #include <Every.h>
 #include <FunctionalInterrupt.h>
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+// The RX hopping keeps its per channel statistics in the inverter
+static_assert(NRF_CHANNEL_COUNT == MAX_RADIO_CHANNEL_STATS, "RadioChannelStats needs one entry per NRF channel");
 
 void HoymilesRadio_NRF::init(SPIClass* initialisedSpiBus, const uint8_t pinCE, const uint8_t pinIRQ)
 {
@@ -51,7 +57,8 @@ void HoymilesRadio_NRF::loop()
         Hoymiles.getMessageOutput()->println("Interrupt received");
         while (_radio->available()) {
             if (!(_rxBuffer.size() > FRAGMENT_BUFFER_SIZE)) {
-                fragment_t f;
+                // Read directly into the queue slot
+                fragment_t& f = _rxBuffer.emplace();
                 memset(f.fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
                 f.len = _radio->getDynamicPayloadSize();
                 f.channel = _radio->getChannel();
@@ -59,7 +66,6 @@ void HoymilesRadio_NRF::loop()
                 if (f.len > MAX_RF_PAYLOAD_SIZE)
                     f.len = MAX_RF_PAYLOAD_SIZE;
                 _radio->read(f.fragment, f.len);
-                _rxBuffer.push(f);
             } else {
                 Hoymiles.getMessageOutput()->println("NRF: Buffer full");
                 _radio->flush_rx();
@@ -70,7 +76,7 @@ void HoymilesRadio_NRF::loop()
     } else {
         // Perform package parsing only if no packages are received
         if (!_rxBuffer.empty()) {
-            fragment_t f = _rxBuffer.back();
+            const fragment_t& f = _rxBuffer.back();
             if (checkFragmentCrc(f)) {
                 std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterByFragment(f);
 
@@ -81,12 +87,20 @@ void HoymilesRadio_NRF::loop()
                     Hoymiles.getMessageOutput()->printf("| %" PRId8 " dBm\r\n", f.rssi);
 
                     inv->addRxFragment(f.fragment, f.len, f.rssi);
+                    updateChannelStats(f, inv.get(), true);
+                    checkRxComplete(*inv);
                 } else {
                     Hoymiles.getMessageOutput()->println("Inverter Not found!");
                 }
 
             } else {
                 Hoymiles.getMessageOutput()->println("Frame kaputt");
+
+                // Most likely a fragment of the inverter we are waiting for
+                if (_busyFlag) {
+                    auto inv = Hoymiles.getInverterBySerial(_commandQueue.front().get()->getTargetAddress());
+                    updateChannelStats(f, inv.get(), false);
+                }
             }
 
             // Remove paket from buffer even it was corrupted
@@ -146,15 +160,78 @@ void HoymilesRadio_NRF::openWritingPipe(const serial_u serial)
 void ARDUINO_ISR_ATTR HoymilesRadio_NRF::handleIntr()
 {
     _packetReceived = true;
+    notifyLoopTask();
 }
 
 uint8_t HoymilesRadio_NRF::getRxNxtChannel()
 {
-    if (++_rxChIdx >= sizeof(_rxChLst))
-        _rxChIdx = 0;
+    if (++_rxHopIdx >= _rxHopLen)
+        _rxHopIdx = 0;
+    _rxChIdx = _rxHopSeq[_rxHopIdx];
     return _rxChLst[_rxChIdx];
 }
 
+void HoymilesRadio_NRF::buildRxHopSequence(InverterAbstract* inv, const bool decay)
+{
+    uint32_t scoreSum = 0;
+    if (inv != nullptr) {
+        for (uint8_t i = 0; i < NRF_CHANNEL_COUNT; i++) {
+            auto& stats = inv->RadioChannelStats[i];
+            if (decay) {
+                stats.Score -= stats.Score / 8;
+            }
+            scoreSum += stats.Score;
+        }
+    }
+
+    // Start with the best channel right after TX
+    std::array<uint8_t, NRF_CHANNEL_COUNT> order;
+    std::iota(order.begin(), order.end(), 0);
+    if (scoreSum > 0) {
+        std::stable_sort(order.begin(), order.end(), [inv](const uint8_t a, const uint8_t b) {
+            return inv->RadioChannelStats[a].Score > inv->RadioChannelStats[b].Score;
+        });
+    }
+
+    // Every channel gets one slot to keep exploring all channels. The
+    // remaining slots are distributed proportional to the channel scores.
+    _rxHopLen = 0;
+    for (const uint8_t i : order) {
+        uint8_t slots = 1;
+        if (scoreSum > 0) {
+            slots += (NRF_HOP_SLOTS - NRF_CHANNEL_COUNT) * inv->RadioChannelStats[i].Score / scoreSum;
+        }
+        while (slots-- > 0 && _rxHopLen < NRF_HOP_SLOTS) {
+            _rxHopSeq[_rxHopLen++] = i;
+        }
+    }
+    _rxHopIdx = 0;
+}
+
+void HoymilesRadio_NRF::updateChannelStats(const fragment_t& fragment, InverterAbstract* inv, const bool crcValid)
+{
+    if (inv == nullptr) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < NRF_CHANNEL_COUNT; i++) {
+        if (_rxChLst[i] != fragment.channel) {
+            continue;
+        }
+
+        auto& stats = inv->RadioChannelStats[i];
+        stats.Channel = fragment.channel;
+        if (crcValid) {
+            stats.RxFragments++;
+            stats.LastRssi = fragment.rssi;
+            stats.Score = std::min<uint32_t>(stats.Score + NRF_SCORE_HIT, UINT16_MAX);
+        } else {
+            stats.RxCrcErrors++;
+        }
+        return;
+    }
+}
+
 uint8_t HoymilesRadio_NRF::getTxNxtChannel()
 {
     if (++_txChIdx >= sizeof(_txChLst))
@@ -186,12 +263,19 @@ void HoymilesRadio_NRF::sendEsbPacket(CommandAbstract& cmd)
     Hoymiles.getMessageOutput()->printf("TX %s Channel: %" PRId8 " --> ",
         cmd.getCommandName().c_str(), _radio->getChannel());
     cmd.dumpDataPayload(Hoymiles.getMessageOutput());
+    // Includes the automatic retransmissions of the chip
+    const uint32_t txStart = micros();
     _radio->write(cmd.getDataPayload(), cmd.getDataSize());
+    _txAirtime += micros() - txStart;
 
     _radio->setRetries(0, 0);
     openReadingPipe();
-    _radio->setChannel(getRxNxtChannel());
+
+    // Listen preferably on the channels this inverter answered on before.
+    // The scores decay with every new request.
+    const bool isNewRequest = &cmd == _commandQueue.front().get() && cmd.getSendCount() == 1;
+    buildRxHopSequence(Hoymiles.getInverterBySerial(cmd.getTargetAddress()).get(), isNewRequest);
+    _radio->setChannel(_rxChLst[_rxHopSeq[_rxHopIdx]]);
     _radio->startListening();
-    _busyFlag = true;
-    _rxTimeout.set(cmd.getTimeout());
+    startRxPeriod(cmd);
 }
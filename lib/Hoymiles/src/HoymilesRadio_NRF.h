@@ -11,6 +11,10 @@
 // number of fragments hold in buffer
 #define FRAGMENT_BUFFER_SIZE 30
 
+#define NRF_CHANNEL_COUNT 5
+#define NRF_HOP_SLOTS 10 // Length of the rx hop sequence, every channel gets at least one slot
+#define NRF_SCORE_HIT 16 // Score added for each fragment received on a channel
+
 class HoymilesRadio_NRF : public HoymilesRadio {
 public:
     void init(SPIClass* initialisedSpiBus, const uint8_t pinCE, const uint8_t pinIRQ);
@@ -25,6 +29,8 @@ public:
 private:
     void ARDUINO_ISR_ATTR handleIntr();
     uint8_t getRxNxtChannel();
+    void buildRxHopSequence(InverterAbstract* inv, const bool decay);
+    void updateChannelStats(const fragment_t& fragment, InverterAbstract* inv, const bool crcValid);
     uint8_t getTxNxtChannel();
     void switchRxCh();
     void openReadingPipe();
@@ -34,10 +40,16 @@ private:
 
     std::unique_ptr<SPIClass> _spiPtr;
     std::unique_ptr<RF24> _radio;
-    uint8_t _rxChLst[5] = { 3, 23, 40, 61, 75 };
+    uint8_t _rxChLst[NRF_CHANNEL_COUNT] = { 3, 23, 40, 61, 75 };
     uint8_t _rxChIdx = 0;
 
-    uint8_t _txChLst[5] = { 3, 23, 40, 61, 75 };
+    // Indices of _rxChLst. Channels which deliver answers of the current
+    // inverter get multiple consecutive slots (longer dwell time).
+    uint8_t _rxHopSeq[NRF_HOP_SLOTS] = { 0, 1, 2, 3, 4 };
+    uint8_t _rxHopLen = NRF_CHANNEL_COUNT;
+    uint8_t _rxHopIdx = 0;
+
+    uint8_t _txChLst[NRF_CHANNEL_COUNT] = { 3, 23, 40, 61, 75 };
     uint8_t _txChIdx = 0;
 
     volatile bool _packetReceived = false;
@@ -62,9 +62,9 @@ void ActivePowerControlCommand::setActivePowerLimit(const float limit, const Pow
     udpateCRC(CRC_SIZE);
 }
 
-bool ActivePowerControlCommand::handleResponse(const fragment_t fragment[], const uint8_t max_fragment_id)
+bool ActivePowerControlCommand::handleResponse(const FragmentBuffer& fragments)
 {
-    if (!DevControlCommand::handleResponse(fragment, max_fragment_id)) {
+    if (!DevControlCommand::handleResponse(fragments)) {
         return false;
     }
 
@@ -36,21 +36,17 @@ String AlarmDataCommand::getCommandName() const
     return "AlarmData";
 }
 
-bool AlarmDataCommand::handleResponse(const fragment_t fragment[], const uint8_t max_fragment_id)
+bool AlarmDataCommand::handleResponse(const FragmentBuffer& fragments)
 {
     // Check CRC of whole payload
-    if (!MultiDataCommand::handleResponse(fragment, max_fragment_id)) {
+    if (!MultiDataCommand::handleResponse(fragments)) {
         return false;
     }
 
-    // Move all fragments into target buffer
-    uint8_t offs = 0;
+    // Move the reassembled payload into target buffer
     _inv->EventLog()->beginAppendFragment();
     _inv->EventLog()->clearBuffer();
-    for (uint8_t i = 0; i < max_fragment_id; i++) {
-        _inv->EventLog()->appendFragment(offs, fragment[i].fragment, fragment[i].len);
-        offs += (fragment[i].len);
-    }
+    _inv->EventLog()->appendFragment(0, fragments.getData(), fragments.getLength());
     _inv->EventLog()->endAppendFragment();
     _inv->EventLog()->setLastAlarmRequestSuccess(CMD_OK);
     _inv->EventLog()->setLastUpdate(millis());
@@ -15,7 +15,7 @@ public:
 
     void setCountryMode(const CountryModeId_t mode);
 
-    virtual bool handleResponse(const fragment_t fragment[], const uint8_t max_fragment_id);
+    virtual bool handleResponse(const FragmentBuffer& fragments);
 
     virtual uint8_t getMaxResendCount();
 };
@@ -95,6 +95,11 @@ uint32_t CommandAbstract::getTimeout() const
     return _timeout;
 }
 
+uint16_t CommandAbstract::getCommandType() const
+{
+    return (_payload[0] << 8) | _payload[10];
+}
+
 void CommandAbstract::setSendCount(const uint8_t count)
 {
     _sendCount = count;
@@ -9,6 +9,7 @@
 #define MAX_RESEND_COUNT 4 // Used if all packages are missing
 #define MAX_RETRANSMIT_COUNT 5 // Used to send the retransmit package
 
+class FragmentBuffer;
 class InverterAbstract;
 
 class CommandAbstract {
@@ -31,13 +32,16 @@ public:
 
     virtual String getCommandName() const = 0;
 
+    // Identifies the kind of request (main command and sub command) independent of addresses
+    uint16_t getCommandType() const;
+
     void setSendCount(const uint8_t count);
     uint8_t getSendCount() const;
     uint8_t incrementSendCount();
 
     virtual CommandAbstract* getRequestFrameCommand(const uint8_t frame_no);
 
-    virtual bool handleResponse(const fragment_t fragment[], const uint8_t max_fragment_id) = 0;
+    virtual bool handleResponse(const FragmentBuffer& fragments) = 0;
     virtual void gotTimeout();
 
     // Sets the amount how often the specific command is resent if all fragments where missing
@@ -21,6 +21,7 @@ Command structure:
 ID   Target Addr   Source Addr   Cmd  Payload CRC16 CRC8
 */
 #include "DevControlCommand.h"
+#include "FragmentBuffer.h"
 #include "crc.h"
 
 DevControlCommand::DevControlCommand(InverterAbstract* inv, const uint64_t router_address)
@@ -39,13 +40,7 @@ void DevControlCommand::udpateCRC(const uint8_t len)
     _payload[10 + len + 1] = static_cast<uint8_t>(crc);
 }
 
-bool DevControlCommand::handleResponse(const fragment_t fragment[], const uint8_t max_fragment_id)
+bool DevControlCommand::handleResponse(const FragmentBuffer& fragments)
 {
-    for (uint8_t i = 0; i < max_fragment_id; i++) {
-        if (fragment[i].mainCmd != (_payload[0] | 0x80)) {
-            return false;
-        }
-    }
-
-    return true;
+    return fragments.hasMainCmd(_payload[0] | 0x80);
 }
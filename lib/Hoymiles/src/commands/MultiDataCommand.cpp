@@ -26,6 +26,7 @@ Command structure:
 ID   Target Addr   Source Addr   Idx  DT   ?    Time          Gap             Password      CRC16   CRC8
 */
 #include "MultiDataCommand.h"
+#include "FragmentBuffer.h"
 #include "crc.h"
 
 MultiDataCommand::MultiDataCommand(InverterAbstract* inv, const uint64_t router_address, const uint8_t data_type, const time_t time)
@@ -85,28 +86,15 @@ CommandAbstract* MultiDataCommand::getRequestFrameCommand(const uint8_t frame_no
     return &_cmdRequestFrame;
 }
 
-bool MultiDataCommand::handleResponse(const fragment_t fragment[], const uint8_t max_fragment_id)
+bool MultiDataCommand::handleResponse(const FragmentBuffer& fragments)
 {
-    // All fragments are available --> Check CRC
-    uint16_t crc = 0xffff, crcRcv = 0;
-
-    for (uint8_t i = 0; i < max_fragment_id; i++) {
-        // Doublecheck if correct answer package
-        if (fragment[i].mainCmd != (_payload[0] | 0x80)) {
-            return false;
-        }
-
-        if (i == max_fragment_id - 1) {
-            // Last packet
-            crc = crc16(fragment[i].fragment, fragment[i].len - 2, crc);
-            crcRcv = (fragment[i].fragment[fragment[i].len - 2] << 8)
-                | (fragment[i].fragment[fragment[i].len - 1]);
-        } else {
-            crc = crc16(fragment[i].fragment, fragment[i].len, crc);
-        }
+    // Doublecheck if correct answer package
+    if (!fragments.hasMainCmd(_payload[0] | 0x80)) {
+        return false;
     }
 
-    return crc == crcRcv;
+    // All fragments are available --> CRC was calculated while receiving
+    return fragments.isCrcValid();
 }
 
 void MultiDataCommand::udpateCRC()
@@ -115,12 +103,3 @@ void MultiDataCommand::udpateCRC()
     _payload[24] = static_cast<uint8_t>(crc >> 8);
     _payload[25] = static_cast<uint8_t>(crc);
 }
-
-uint8_t MultiDataCommand::getTotalFragmentSize(const fragment_t fragment[], const uint8_t max_fragment_id)
-{
-    uint8_t fragmentSize = 0;
-    for (uint8_t i = 0; i < max_fragment_id; i++) {
-        fragmentSize += fragment[i].len;
-    }
-    return fragmentSize;
-}
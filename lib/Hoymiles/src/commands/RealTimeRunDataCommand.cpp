@@ -35,17 +35,17 @@ String RealTimeRunDataCommand::getCommandName() const
     return "RealTimeRunData";
 }
 
-bool RealTimeRunDataCommand::handleResponse(const fragment_t fragment[], const uint8_t max_fragment_id)
+bool RealTimeRunDataCommand::handleResponse(const FragmentBuffer& fragments)
 {
     // Check CRC of whole payload
-    if (!MultiDataCommand::handleResponse(fragment, max_fragment_id)) {
+    if (!MultiDataCommand::handleResponse(fragments)) {
         return false;
     }
 
     // Check if at least all required bytes are received
     // In case of low power in the inverter it occours that some incomplete fragments
     // with a valid CRC are received.
-    const uint8_t fragmentsSize = getTotalFragmentSize(fragment, max_fragment_id);
+    const uint8_t fragmentsSize = fragments.getLength();
     const uint8_t expectedSize = _inv->Statistics()->getExpectedByteCount();
     if (fragmentsSize < expectedSize) {
         Hoymiles.getMessageOutput()->printf("ERROR in %s: Received fragment size: %" PRId8 ", min expected size: %" PRId8 "\r\n",
@@ -54,14 +54,10 @@ bool RealTimeRunDataCommand::handleResponse(const fragment_t fragment[], const u
         return false;
     }
 
-    // Move all fragments into target buffer
-    uint8_t offs = 0;
+    // Move the reassembled payload into target buffer
     _inv->Statistics()->beginAppendFragment();
     _inv->Statistics()->clearBuffer();
-    for (uint8_t i = 0; i < max_fragment_id; i++) {
-        _inv->Statistics()->appendFragment(offs, fragment[i].fragment, fragment[i].len);
-        offs += (fragment[i].len);
-    }
+    _inv->Statistics()->appendFragment(0, fragments.getData(), fragments.getLength());
     _inv->Statistics()->endAppendFragment();
     _inv->Statistics()->resetRxFailureCount();
     _inv->Statistics()->setLastUpdate(millis());
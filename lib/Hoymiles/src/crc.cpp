@@ -1,17 +1,65 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 /*
- * Copyright (C) 2022 Thomas Basler and others
+ * Copyright (C) 2022 - 2024 Thomas Basler and others
  */
 #include "crc.h"
+#include <array>
 
-uint8_t crc8(const uint8_t buf[], const uint8_t len)
+/*
+The CRCs are calculated byte wise using lookup tables which are generated at
+compile time. As they are const they are placed in flash. The payloads are
+short (< 200 bytes), therefore slicing variants with multiple tables would
+only increase the flash and cache footprint without a measurable gain.
+*/
+
+static constexpr std::array<uint8_t, 256> generateCrc8Table()
 {
-    uint8_t crc = CRC8_INIT;
-    for (uint8_t i = 0; i < len; i++) {
-        crc ^= buf[i];
+    std::array<uint8_t, 256> table {};
+    for (uint16_t i = 0; i < 256; i++) {
+        uint8_t crc = i;
         for (uint8_t b = 0; b < 8; b++) {
             crc = (crc << 1) ^ ((crc & 0x80) ? CRC8_POLY : 0x00);
         }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static constexpr std::array<uint16_t, 256> generateCrc16Table()
+{
+    std::array<uint16_t, 256> table {};
+    for (uint16_t i = 0; i < 256; i++) {
+        uint16_t crc = i;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x0001) ? ((crc >> 1) ^ CRC16_MODBUS_POLYNOM) : (crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static constexpr std::array<uint16_t, 256> generateCrc16Nrf24Table()
+{
+    std::array<uint16_t, 256> table {};
+    for (uint16_t i = 0; i < 256; i++) {
+        uint16_t crc = i << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ CRC16_NRF24_POLYNOM) : (crc << 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static constexpr auto crc8Table = generateCrc8Table();
+static constexpr auto crc16Table = generateCrc16Table();
+static constexpr auto crc16Nrf24Table = generateCrc16Nrf24Table();
+
+uint8_t crc8(const uint8_t buf[], const uint8_t len)
+{
+    uint8_t crc = CRC8_INIT;
+    for (uint8_t i = 0; i < len; i++) {
+        crc = crc8Table[crc ^ buf[i]];
     }
     return crc;
 }
@@ -19,32 +67,37 @@ uint8_t crc8(const uint8_t buf[], const uint8_t len)
 uint16_t crc16(const uint8_t buf[], const uint8_t len, const uint16_t start)
 {
     uint16_t crc = start;
-    uint8_t shift = 0;
-
     for (uint8_t i = 0; i < len; i++) {
-        crc = crc ^ buf[i];
-        for (uint8_t bit = 0; bit < 8; bit++) {
-            shift = (crc & 0x0001);
-            crc = crc >> 1;
-            if (shift != 0)
-                crc = crc ^ 0xA001;
-        }
+        crc = (crc >> 8) ^ crc16Table[(crc ^ buf[i]) & 0xff];
     }
     return crc;
 }
 
+static inline uint16_t crc16nrf24Bit(const uint16_t crc, const uint8_t val, const uint8_t idx)
+{
+    const uint16_t c = crc ^ (0x8000 & (val << (8 + idx)));
+    return (c & 0x8000) ? ((c << 1) ^ CRC16_NRF24_POLYNOM) : (c << 1);
+}
+
 uint16_t crc16nrf24(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit, const uint16_t crcIn)
 {
     uint16_t crc = crcIn;
-    uint8_t idx, val = buf[(startBit >> 3)];
+    uint16_t bit = startBit;
+
+    // Leading bits until the next byte boundary
+    for (; bit < lenBits && (bit & 0x07); bit++) {
+        crc = crc16nrf24Bit(crc, buf[bit >> 3], bit & 0x07);
+    }
+
+    // Whole bytes
+    for (; bit + 8 <= lenBits; bit += 8) {
+        crc = (crc << 8) ^ crc16Nrf24Table[((crc >> 8) ^ buf[bit >> 3]) & 0xff];
+    }
 
-    for (uint16_t bit = startBit; bit < lenBits; bit++) {
-        idx = bit & 0x07;
-        if (0 == idx)
-            val = buf[(bit >> 3)];
-        crc ^= 0x8000 & (val << (8 + idx));
-        crc = (crc & 0x8000) ? ((crc << 1) ^ CRC16_NRF24_POLYNOM) : (crc << 1);
+    // Remaining bits of the last byte
+    for (; bit < lenBits; bit++) {
+        crc = crc16nrf24Bit(crc, buf[bit >> 3], bit & 0x07);
     }
 
     return crc;
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #include "InverterAbstract.h"
 #include "../Hoymiles.h"
 #include "crc.h"
+#include <algorithm>
 #include <cstring>
 
 InverterAbstract::InverterAbstract(HoymilesRadio* radio, const uint64_t serial)
@@ -184,61 +185,32 @@ SystemConfigParaParser* InverterAbstract::SystemConfigPara()
 
 void InverterAbstract::clearRxFragmentBuffer()
 {
-    memset(_rxFragmentBuffer, 0, MAX_RF_FRAGMENT_COUNT * sizeof(fragment_t));
-    _rxFragmentMaxPacketId = 0;
-    _rxFragmentLastPacketId = 0;
+    _rxFragments.clear();
     _rxFragmentRetransmitCnt = 0;
+    _rxFragmentMissing = 0;
+    _rxFragmentFirstTime = 0;
 }
 
 void InverterAbstract::addRxFragment(const uint8_t fragment[], const uint8_t len, const int8_t rssi)
 {
     _lastRssi = rssi;
-
-    if (len < 11) {
-        Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) fragment too short\r\n", __FILE__, __LINE__);
-        return;
-    }
-
-    if (len - 11 > MAX_RF_PAYLOAD_SIZE) {
-        Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) fragment too large\r\n", __FILE__, __LINE__);
-        return;
-    }
-
-    const uint8_t fragmentCount = fragment[9];
-
-    // Packets with 0x81 will be seen as 1
-    const uint8_t fragmentId = fragmentCount & 0b01111111; // fragmentId is 1 based
-
-    if (fragmentId == 0) {
-        Hoymiles.getMessageOutput()->println("ERROR: fragment id zero received and ignored");
-        return;
+    _rxFragmentLastTime = millis();
+    if (_rxFragmentFirstTime == 0) {
+        _rxFragmentFirstTime = _rxFragmentLastTime;
     }
+    RssiHistogram.add(rssi);
 
-    if (fragmentId >= MAX_RF_FRAGMENT_COUNT) {
-        Hoymiles.getMessageOutput()->printf("ERROR: fragment id %" PRId8 " is too large for buffer and ignored\r\n", fragmentId);
-        return;
-    }
-
-    memcpy(_rxFragmentBuffer[fragmentId - 1].fragment, &fragment[10], len - 11);
-    _rxFragmentBuffer[fragmentId - 1].len = len - 11;
-    _rxFragmentBuffer[fragmentId - 1].mainCmd = fragment[0];
-    _rxFragmentBuffer[fragmentId - 1].wasReceived = true;
-
-    if (fragmentId > _rxFragmentLastPacketId) {
-        _rxFragmentLastPacketId = fragmentId;
-    }
-
-    // 0b10000000 == 0x80
-    if ((fragmentCount & 0b10000000) == 0b10000000) {
-        _rxFragmentMaxPacketId = fragmentId;
-    }
+    _rxFragments.add(fragment, len);
 }
 
-// Returns Zero on Success or the Fragment ID for retransmit or error code
+// Returns Zero on Success, FRAGMENT_RETRANSMIT if fragments have to be re-requested or an error code.
+// All missing fragment ids are available using getMissingFragments() afterwards.
 uint8_t InverterAbstract::verifyAllFragments(CommandAbstract& cmd)
 {
+    _rxFragmentMissing = 0;
+
     // All missing
-    if (_rxFragmentLastPacketId == 0) {
+    if (_rxFragments.getLastId() == 0) {
         Hoymiles.getMessageOutput()->println("All missing");
         if (cmd.getSendCount() <= cmd.getMaxResendCount()) {
             return FRAGMENT_ALL_MISSING_RESEND;
@@ -248,31 +220,34 @@ uint8_t InverterAbstract::verifyAllFragments(CommandAbstract& cmd)
         }
     }
 
-    // Last fragment is missing (the one with 0x80)
-    if (_rxFragmentMaxPacketId == 0) {
+    // Last fragment is missing (the one with 0x80). Request the one after
+    // the highest received id, the inverter will answer with the end marker.
+    uint8_t lastFragmentId = _rxFragments.getMaxId();
+    if (lastFragmentId == 0) {
         Hoymiles.getMessageOutput()->println("Last missing");
+        lastFragmentId = _rxFragments.getLastId() + 1;
+        _rxFragmentMissing |= 1 << (lastFragmentId - 1);
+    }
+
+    // Middle fragments are missing
+    for (uint8_t i = 0; i < lastFragmentId - 1; i++) {
+        if (!_rxFragments.wasReceived(i + 1)) {
+            _rxFragmentMissing |= 1 << i;
+        }
+    }
+
+    if (_rxFragmentMissing != 0) {
+        Hoymiles.getMessageOutput()->printf("Missing fragments: 0x%04" PRIX16 "\r\n", _rxFragmentMissing);
         if (_rxFragmentRetransmitCnt++ < cmd.getMaxRetransmitCount()) {
-            return _rxFragmentLastPacketId + 1;
+            return FRAGMENT_RETRANSMIT;
         } else {
             cmd.gotTimeout();
             return FRAGMENT_RETRANSMIT_TIMEOUT;
         }
     }
 
-    // Middle fragment is missing
-    for (uint8_t i = 0; i < _rxFragmentMaxPacketId - 1; i++) {
-        if (!_rxFragmentBuffer[i].wasReceived) {
-            Hoymiles.getMessageOutput()->println("Middle missing");
-            if (_rxFragmentRetransmitCnt++ < cmd.getMaxRetransmitCount()) {
-                return i + 1;
-            } else {
-                cmd.gotTimeout();
-                return FRAGMENT_RETRANSMIT_TIMEOUT;
-            }
-        }
-    }
-
-    if (!cmd.handleResponse(_rxFragmentBuffer, _rxFragmentMaxPacketId)) {
+    _rxFragments.finish();
+    if (!cmd.handleResponse(_rxFragments)) {
         cmd.gotTimeout();
         return FRAGMENT_HANDLE_ERROR;
     }
@@ -280,6 +255,79 @@ uint8_t InverterAbstract::verifyAllFragments(CommandAbstract& cmd)
     return FRAGMENT_OK;
 }
 
+uint16_t InverterAbstract::getMissingFragments() const
+{
+    return _rxFragmentMissing;
+}
+
+bool InverterAbstract::isAllFragmentsReceived() const
+{
+    if (_rxFragments.getMaxId() == 0) {
+        return false;
+    }
+
+    for (uint8_t i = 1; i <= _rxFragments.getMaxId(); i++) {
+        if (!_rxFragments.wasReceived(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool InverterAbstract::isLastFragmentReceived() const
+{
+    return _rxFragments.getMaxId() != 0;
+}
+
+uint32_t InverterAbstract::getLastFragmentTime() const
+{
+    return _rxFragmentLastTime;
+}
+
+uint32_t InverterAbstract::getFirstFragmentTime() const
+{
+    return _rxFragmentFirstTime;
+}
+
+uint32_t InverterAbstract::getRxTimeout(const CommandAbstract& cmd) const
+{
+    const uint32_t ceiling = cmd.getTimeout();
+    const uint16_t type = cmd.getCommandType();
+
+    for (auto& slot : _rxLatency) {
+        if (slot.Latency > 0 && slot.CommandType == type) {
+            const uint32_t latency = slot.Latency / 8;
+            const uint32_t timeout = latency + std::max<uint32_t>(latency / 2, RX_TIMEOUT_MARGIN);
+            return std::min(std::max<uint32_t>(timeout, RX_TIMEOUT_MIN), ceiling);
+        }
+    }
+
+    // Nothing learned yet
+    return ceiling;
+}
+
+void InverterAbstract::updateRxLatency(const CommandAbstract& cmd, const uint32_t latency)
+{
+    const uint16_t type = cmd.getCommandType();
+    const uint32_t sample = std::min<uint32_t>(latency, UINT16_MAX / 8) * 8;
+
+    for (auto& slot : _rxLatency) {
+        if (slot.Latency > 0 && slot.CommandType == type) {
+            // Exponentially weighted moving average with alpha = 1/4
+            slot.Latency = std::max<int32_t>(1, slot.Latency + (static_cast<int32_t>(sample) - slot.Latency) / 4);
+            return;
+        }
+    }
+
+    for (auto& slot : _rxLatency) {
+        if (slot.Latency == 0) {
+            slot.CommandType = type;
+            slot.Latency = std::max<uint32_t>(1, sample);
+            return;
+        }
+    }
+}
+
 void InverterAbstract::performDailyTask()
 {
     // Have to reset the offets first, otherwise it will
@@ -289,7 +337,9 @@ void InverterAbstract::performDailyTask()
         Statistics()->zeroDailyData();
     }
     if (getClearEventlogOnMidnight()) {
+        EventLog()->beginAppendFragment();
         EventLog()->clearBuffer();
+        EventLog()->endAppendFragment();
     }
     resetRadioStats();
 }
@@ -297,4 +347,11 @@ void InverterAbstract::performDailyTask()
 void InverterAbstract::resetRadioStats()
 {
     RadioStats = {};
+    RssiHistogram.reset();
+
+    // Keep the channel scores, they are required for channel selection
+    for (auto& channel : RadioChannelStats) {
+        channel.RxFragments = 0;
+        channel.RxCrcErrors = 0;
+    }
 }
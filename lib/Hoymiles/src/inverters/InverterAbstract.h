@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "../FragmentBuffer.h"
 #include "../commands/ActivePowerControlCommand.h"
 #include "../parser/AlarmLogParser.h"
 #include "../parser/DevInfoParser.h"
@@ -21,10 +22,15 @@ enum {
     FRAGMENT_ALL_MISSING_TIMEOUT = 254,
     FRAGMENT_RETRANSMIT_TIMEOUT = 253,
     FRAGMENT_HANDLE_ERROR = 252,
+    FRAGMENT_RETRANSMIT = 251,
     FRAGMENT_OK = 0
 };
 
-#define MAX_RF_FRAGMENT_COUNT 13
+#define MAX_RADIO_CHANNEL_STATS 5
+
+#define RX_LATENCY_SLOTS 12 // Amount of different command types with learned response latency
+#define RX_TIMEOUT_MIN 50 // Lower bound of the learned rx timeout (ms)
+#define RX_TIMEOUT_MARGIN 20 // Added to the learned response latency (ms)
 
 class CommandAbstract;
 
@@ -66,6 +72,16 @@ public:
     void clearRxFragmentBuffer();
     void addRxFragment(const uint8_t fragment[], const uint8_t len, const int8_t rssi);
     uint8_t verifyAllFragments(CommandAbstract& cmd);
+    uint16_t getMissingFragments() const;
+    bool isAllFragmentsReceived() const;
+    bool isLastFragmentReceived() const;
+    uint32_t getLastFragmentTime() const;
+    uint32_t getFirstFragmentTime() const; // Zero if nothing was received yet
+
+    // Returns the rx timeout based on the learned response latency of this command type.
+    // The timeout configured in the command is used as upper bound.
+    uint32_t getRxTimeout(const CommandAbstract& cmd) const;
+    void updateRxLatency(const CommandAbstract& cmd, const uint32_t latency);
 
     void performDailyTask();
 
@@ -89,8 +105,34 @@ public:
 
         // RX Fail Corrupt Data
         uint32_t RxFailCorruptData;
+
+        // Time from first TX until complete response of the last successful command (ms)
+        uint32_t RxCompleteTimeLast;
+
+        // Sum of the time to complete of all successful commands (ms)
+        uint32_t RxCompleteTimeSum;
     } RadioStats = {};
 
+    struct {
+        // RF channel, zero if unused
+        uint8_t Channel;
+
+        // RX fragments with valid CRC
+        uint32_t RxFragments;
+
+        // RX fragments with invalid CRC received while waiting for this inverter
+        uint32_t RxCrcErrors;
+
+        // RSSI of the last fragment received on this channel
+        int8_t LastRssi;
+
+        // Decaying success score used to rank the channels
+        uint16_t Score;
+    } RadioChannelStats[MAX_RADIO_CHANNEL_STATS] = {};
+
+    // RSSI of all received fragments (dBm)
+    Histogram RssiHistogram { RF_RSSI_BOUNDS_DBM };
+
     virtual bool sendStatsRequest() = 0;
     virtual bool sendAlarmLogRequest(const bool force = false) = 0;
     virtual bool sendDevInfoRequest() = 0;
@@ -119,10 +161,16 @@ private:
     serial_u _serial;
     String _serialString;
     char _name[MAX_NAME_LENGTH] = "";
-    fragment_t _rxFragmentBuffer[MAX_RF_FRAGMENT_COUNT];
-    uint8_t _rxFragmentMaxPacketId = 0;
-    uint8_t _rxFragmentLastPacketId = 0;
+    FragmentBuffer _rxFragments;
     uint8_t _rxFragmentRetransmitCnt = 0;
+    uint16_t _rxFragmentMissing = 0; // Bit n represents fragment id n + 1
+    uint32_t _rxFragmentLastTime = 0;
+    uint32_t _rxFragmentFirstTime = 0;
+
+    struct {
+        uint16_t CommandType;
+        uint16_t Latency; // EWMA in 1/8 ms
+    } _rxLatency[RX_LATENCY_SLOTS] = {};
 
     bool _enablePolling = true;
     bool _enableCommands = true;
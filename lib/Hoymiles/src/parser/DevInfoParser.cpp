@@ -87,16 +87,15 @@ const devInfo_t devInfo[] = {
 };
 
 DevInfoParser::DevInfoParser()
-    : Parser()
+    : PayloadParser()
 {
-    clearBufferSimple();
-    clearBufferAll();
 }
 
 void DevInfoParser::clearBufferAll()
 {
-    memset(_payloadDevInfoAll, 0, DEV_INFO_SIZE);
-    _devInfoAllLength = 0;
+    DevInfoPayload_t& payload = back();
+    memset(payload.All, 0, DEV_INFO_SIZE);
+    payload.AllLength = 0;
 }
 
 void DevInfoParser::appendFragmentAll(const uint8_t offset, const uint8_t* payload, const uint8_t len)
@@ -105,14 +104,15 @@ void DevInfoParser::appendFragmentAll(const uint8_t offset, const uint8_t* paylo
         Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) dev info all packet too large for buffer\r\n", __FILE__, __LINE__);
         return;
     }
-    memcpy(&_payloadDevInfoAll[offset], payload, len);
-    _devInfoAllLength += len;
+    memcpy(&back().All[offset], payload, len);
+    back().AllLength += len;
 }
 
 void DevInfoParser::clearBufferSimple()
 {
-    memset(_payloadDevInfoSimple, 0, DEV_INFO_SIZE);
-    _devInfoSimpleLength = 0;
+    DevInfoPayload_t& payload = back();
+    memset(payload.Simple, 0, DEV_INFO_SIZE);
+    payload.SimpleLength = 0;
 }
 
 void DevInfoParser::appendFragmentSimple(const uint8_t offset, const uint8_t* payload, const uint8_t len)
@@ -121,8 +121,8 @@ void DevInfoParser::appendFragmentSimple(const uint8_t offset, const uint8_t* pa
         Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) dev info Simple packet too large for buffer\r\n", __FILE__, __LINE__);
         return;
     }
-    memcpy(&_payloadDevInfoSimple[offset], payload, len);
-    _devInfoSimpleLength += len;
+    memcpy(&back().Simple[offset], payload, len);
+    back().SimpleLength += len;
 }
 
 uint32_t DevInfoParser::getLastUpdateAll() const
@@ -147,26 +147,40 @@ void DevInfoParser::setLastUpdateSimple(const uint32_t lastUpdate)
     setLastUpdate(lastUpdate);
 }
 
+std::vector<uint8_t> DevInfoParser::getRawDataAll() const
+{
+    return read([](const DevInfoPayload_t& p) {
+        return std::vector<uint8_t>(p.All, p.All + p.AllLength);
+    });
+}
+
+std::vector<uint8_t> DevInfoParser::getRawDataSimple() const
+{
+    return read([](const DevInfoPayload_t& p) {
+        return std::vector<uint8_t>(p.Simple, p.Simple + p.SimpleLength);
+    });
+}
+
 uint16_t DevInfoParser::getFwBuildVersion() const
 {
-    HOY_SEMAPHORE_TAKE();
-    const uint16_t ret = (static_cast<uint16_t>(_payloadDevInfoAll[0]) << 8) | _payloadDevInfoAll[1];
-    HOY_SEMAPHORE_GIVE();
-    return ret;
+    return read([](const DevInfoPayload_t& p) {
+        return static_cast<uint16_t>((static_cast<uint16_t>(p.All[0]) << 8) | p.All[1]);
+    });
 }
 
 time_t DevInfoParser::getFwBuildDateTime() const
 {
-    struct tm timeinfo = {};
-    HOY_SEMAPHORE_TAKE();
-    timeinfo.tm_year = ((static_cast<uint16_t>(_payloadDevInfoAll[2]) << 8) | _payloadDevInfoAll[3]) - 1900;
+    struct tm timeinfo = read([](const DevInfoPayload_t& p) {
+        struct tm t = {};
+        t.tm_year = ((static_cast<uint16_t>(p.All[2]) << 8) | p.All[3]) - 1900;
 
-    timeinfo.tm_mon = ((static_cast<uint16_t>(_payloadDevInfoAll[4]) << 8) | _payloadDevInfoAll[5]) / 100 - 1;
-    timeinfo.tm_mday = ((static_cast<uint16_t>(_payloadDevInfoAll[4]) << 8) | _payloadDevInfoAll[5]) % 100;
+        t.tm_mon = ((static_cast<uint16_t>(p.All[4]) << 8) | p.All[5]) / 100 - 1;
+        t.tm_mday = ((static_cast<uint16_t>(p.All[4]) << 8) | p.All[5]) % 100;
 
-    timeinfo.tm_hour = ((static_cast<uint16_t>(_payloadDevInfoAll[6]) << 8) | _payloadDevInfoAll[7]) / 100;
-    timeinfo.tm_min = ((static_cast<uint16_t>(_payloadDevInfoAll[6]) << 8) | _payloadDevInfoAll[7]) % 100;
-    HOY_SEMAPHORE_GIVE();
+        t.tm_hour = ((static_cast<uint16_t>(p.All[6]) << 8) | p.All[7]) / 100;
+        t.tm_min = ((static_cast<uint16_t>(p.All[6]) << 8) | p.All[7]) % 100;
+        return t;
+    });
 
     return timegm(&timeinfo);
 }
@@ -181,28 +195,28 @@ String DevInfoParser::getFwBuildDateTimeStr() const
 
 uint16_t DevInfoParser::getFwBootloaderVersion() const
 {
-    HOY_SEMAPHORE_TAKE();
-    const uint16_t ret = (static_cast<uint16_t>(_payloadDevInfoAll[8]) << 8) | _payloadDevInfoAll[9];
-    HOY_SEMAPHORE_GIVE();
-    return ret;
+    return read([](const DevInfoPayload_t& p) {
+        return static_cast<uint16_t>((static_cast<uint16_t>(p.All[8]) << 8) | p.All[9]);
+    });
 }
 
 uint32_t DevInfoParser::getHwPartNumber() const
 {
-    HOY_SEMAPHORE_TAKE();
-    const uint16_t hwpn_h = (static_cast<uint16_t>(_payloadDevInfoSimple[2]) << 8) | _payloadDevInfoSimple[3];
-    const uint16_t hwpn_l = (static_cast<uint16_t>(_payloadDevInfoSimple[4]) << 8) | _payloadDevInfoSimple[5];
-    HOY_SEMAPHORE_GIVE();
+    return read([](const DevInfoPayload_t& p) {
+        const uint16_t hwpn_h = (static_cast<uint16_t>(p.Simple[2]) << 8) | p.Simple[3];
+        const uint16_t hwpn_l = (static_cast<uint16_t>(p.Simple[4]) << 8) | p.Simple[5];
 
-    return (static_cast<uint32_t>(hwpn_h) << 16) | static_cast<uint32_t>(hwpn_l);
+        return (static_cast<uint32_t>(hwpn_h) << 16) | static_cast<uint32_t>(hwpn_l);
+    });
 }
 
 String DevInfoParser::getHwVersion() const
 {
     char buf[8];
-    HOY_SEMAPHORE_TAKE();
-    snprintf(buf, sizeof(buf), "%02d.%02d", _payloadDevInfoSimple[6], _payloadDevInfoSimple[7]);
-    HOY_SEMAPHORE_GIVE();
+    const auto [major, minor] = read([](const DevInfoPayload_t& p) {
+        return std::make_pair(p.Simple[6], p.Simple[7]);
+    });
+    snprintf(buf, sizeof(buf), "%02d.%02d", major, minor);
     return buf;
 }
 
@@ -235,18 +249,21 @@ bool DevInfoParser::containsValidData() const
 }
 
 uint8_t DevInfoParser::getDevIdx() const
+{
+    return read([](const DevInfoPayload_t& p) { return getDevIdx(p); });
+}
+
+uint8_t DevInfoParser::getDevIdx(const DevInfoPayload_t& payload)
 {
     uint8_t ret = 0xff;
     uint8_t pos;
 
-    HOY_SEMAPHORE_TAKE();
-
     // Check for all 4 bytes first
     for (pos = 0; pos < sizeof(devInfo) / sizeof(devInfo_t); pos++) {
-        if (devInfo[pos].hwPart[0] == _payloadDevInfoSimple[2]
-            && devInfo[pos].hwPart[1] == _payloadDevInfoSimple[3]
-            && devInfo[pos].hwPart[2] == _payloadDevInfoSimple[4]
-            && devInfo[pos].hwPart[3] == _payloadDevInfoSimple[5]) {
+        if (devInfo[pos].hwPart[0] == payload.Simple[2]
+            && devInfo[pos].hwPart[1] == payload.Simple[3]
+            && devInfo[pos].hwPart[2] == payload.Simple[4]
+            && devInfo[pos].hwPart[3] == payload.Simple[5]) {
             ret = pos;
             break;
         }
@@ -255,17 +272,15 @@ uint8_t DevInfoParser::getDevIdx() const
     // Then only for 3 bytes but only if not already found
     if (ret == 0xff) {
         for (pos = 0; pos < sizeof(devInfo) / sizeof(devInfo_t); pos++) {
-            if (devInfo[pos].hwPart[0] == _payloadDevInfoSimple[2]
-                && devInfo[pos].hwPart[1] == _payloadDevInfoSimple[3]
-                && devInfo[pos].hwPart[2] == _payloadDevInfoSimple[4]) {
+            if (devInfo[pos].hwPart[0] == payload.Simple[2]
+                && devInfo[pos].hwPart[1] == payload.Simple[3]
+                && devInfo[pos].hwPart[2] == payload.Simple[4]) {
                 ret = pos;
                 break;
             }
         }
     }
 
-    HOY_SEMAPHORE_GIVE();
-
     return ret;
 }
 
@@ -273,17 +288,24 @@ uint8_t DevInfoParser::getDevIdx() const
 time_t DevInfoParser::timegm(const struct tm* t)
 {
     uint32_t year;
+    int month;
     time_t result;
 #define MONTHSPERYEAR 12 /* months per calendar year */
     static const int cumdays[MONTHSPERYEAR] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
 
     /*@ +matchanyintegral @*/
     year = 1900 + t->tm_year + t->tm_mon / MONTHSPERYEAR;
-    result = (year - 1970) * 365 + cumdays[t->tm_mon % MONTHSPERYEAR];
+    month = t->tm_mon % MONTHSPERYEAR;
+    // Month 0 is received as -1 (e.g. before the device info was read)
+    if (month < 0) {
+        month += MONTHSPERYEAR;
+        year--;
+    }
+    result = (year - 1970) * 365 + cumdays[month];
     result += (year - 1968) / 4;
     result -= (year - 1900) / 100;
     result += (year - 1600) / 400;
-    if ((year % 4) == 0 && ((year % 100) != 0 || (year % 400) == 0) && (t->tm_mon % MONTHSPERYEAR) < 2)
+    if ((year % 4) == 0 && ((year % 100) != 0 || (year % 400) == 0) && month < 2)
         result--;
     result += t->tm_mday - 1;
     result *= 24;
@@ -1,10 +1,19 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 #include "Parser.h"
+#include <vector>
 
 #define DEV_INFO_SIZE 20
 
-class DevInfoParser : public Parser {
+struct DevInfoPayload_t {
+    uint8_t All[DEV_INFO_SIZE];
+    uint8_t AllLength;
+
+    uint8_t Simple[DEV_INFO_SIZE];
+    uint8_t SimpleLength;
+};
+
+class DevInfoParser : public PayloadParser<DevInfoPayload_t> {
 public:
     DevInfoParser();
     void clearBufferAll();
@@ -19,6 +28,9 @@ public:
     uint32_t getLastUpdateSimple() const;
     void setLastUpdateSimple(const uint32_t lastUpdate);
 
+    std::vector<uint8_t> getRawDataAll() const;
+    std::vector<uint8_t> getRawDataSimple() const;
+
     uint16_t getFwBuildVersion() const;
     time_t getFwBuildDateTime() const;
     String getFwBuildDateTimeStr() const;
@@ -35,13 +47,8 @@ public:
 private:
     static time_t timegm(const struct tm* tm);
     uint8_t getDevIdx() const;
+    static uint8_t getDevIdx(const DevInfoPayload_t& payload);
 
     uint32_t _lastUpdateAll = 0;
     uint32_t _lastUpdateSimple = 0;
-
-    uint8_t _payloadDevInfoAll[DEV_INFO_SIZE] = {};
-    uint8_t _devInfoAllLength = 0;
-
-    uint8_t _payloadDevInfoSimple[DEV_INFO_SIZE] = {};
-    uint8_t _devInfoSimpleLength = 0;
 };
@@ -134,7 +134,7 @@ constexpr frozen::map<uint8_t, GridProfileItemDefinition_t, 0x42> itemDefinition
     { 0xff, make_value("Unkown Value", "", 1) },
 };
 
-const std::array<const GridProfileValue_t, SECTION_VALUE_COUNT> GridProfileParser::_profileValues = { {
+constexpr std::array<GridProfileValue_t, SECTION_VALUE_COUNT> profileValues = { {
     // Voltage (H/LVRT)
     // Version 0x00
     { 0x00, 0x00, 0x01 },
@@ -362,16 +362,48 @@ const std::array<const GridProfileValue_t, SECTION_VALUE_COUNT> GridProfileParse
     { 0xb0, 0x00, 0x38 },
 } };
 
+// Index of the first entry and the number of entries in profileValues for every section/version combination
+struct GridProfileSectionIndex_t {
+    uint8_t Section;
+    uint8_t Version;
+    uint8_t Start;
+    uint8_t Size;
+};
+
+constexpr size_t countProfileSections()
+{
+    size_t count = 0;
+    for (size_t i = 0; i < profileValues.size(); i++) {
+        if (i == 0 || profileValues[i].Section != profileValues[i - 1].Section || profileValues[i].Version != profileValues[i - 1].Version) {
+            count++;
+        }
+    }
+    return count;
+}
+
+constexpr auto buildProfileSectionIndex()
+{
+    std::array<GridProfileSectionIndex_t, countProfileSections()> index {};
+    size_t count = 0;
+    for (size_t i = 0; i < profileValues.size(); i++) {
+        if (i == 0 || profileValues[i].Section != profileValues[i - 1].Section || profileValues[i].Version != profileValues[i - 1].Version) {
+            index[count++] = { profileValues[i].Section, profileValues[i].Version, static_cast<uint8_t>(i), 0 };
+        }
+        index[count - 1].Size++;
+    }
+    return index;
+}
+
+constexpr auto profileSectionIndex = buildProfileSectionIndex();
+
 GridProfileParser::GridProfileParser()
-    : Parser()
+    : PayloadParser()
 {
-    clearBuffer();
 }
 
 void GridProfileParser::clearBuffer()
 {
-    memset(_payloadGridProfile, 0, GRID_PROFILE_SIZE);
-    _gridProfileLength = 0;
+    back() = {};
 }
 
 void GridProfileParser::appendFragment(const uint8_t offset, const uint8_t* payload, const uint8_t len)
@@ -380,14 +412,18 @@ void GridProfileParser::appendFragment(const uint8_t offset, const uint8_t* payl
         Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) grid profile packet too large for buffer\r\n", __FILE__, __LINE__);
         return;
     }
-    memcpy(&_payloadGridProfile[offset], payload, len);
-    _gridProfileLength += len;
+    memcpy(&back().Data[offset], payload, len);
+    back().Length += len;
 }
 
 String GridProfileParser::getProfileName() const
 {
+    const auto [lIdx, hIdx] = read([](const GridProfilePayload_t& p) {
+        return std::make_pair(p.Data[0], p.Data[1]);
+    });
+
     for (auto& ptype : _profileTypes) {
-        if (ptype.lIdx == _payloadGridProfile[0] && ptype.hIdx == _payloadGridProfile[1]) {
+        if (ptype.lIdx == lIdx && ptype.hIdx == hIdx) {
             return ptype.Name;
         }
     }
@@ -397,96 +433,65 @@ String GridProfileParser::getProfileName() const
 String GridProfileParser::getProfileVersion() const
 {
     char buffer[10];
-    HOY_SEMAPHORE_TAKE();
-    snprintf(buffer, sizeof(buffer), "%d.%d.%d", (_payloadGridProfile[2] >> 4) & 0x0f, _payloadGridProfile[2] & 0x0f, _payloadGridProfile[3]);
-    HOY_SEMAPHORE_GIVE();
+    const auto [major, patch] = read([](const GridProfilePayload_t& p) {
+        return std::make_pair(p.Data[2], p.Data[3]);
+    });
+    snprintf(buffer, sizeof(buffer), "%d.%d.%d", (major >> 4) & 0x0f, major & 0x0f, patch);
     return buffer;
 }
 
 std::vector<uint8_t> GridProfileParser::getRawData() const
 {
-    std::vector<uint8_t> ret;
-    HOY_SEMAPHORE_TAKE();
-    for (uint8_t i = 0; i < _gridProfileLength; i++) {
-        ret.push_back(_payloadGridProfile[i]);
-    }
-    HOY_SEMAPHORE_GIVE();
-    return ret;
+    return read([](const GridProfilePayload_t& p) {
+        return std::vector<uint8_t>(p.Data, p.Data + p.Length);
+    });
 }
 
-std::list<GridProfileSection_t> GridProfileParser::getProfile() const
+void GridProfileParser::visitProfile(const GridProfileSectionFunc& onSection, const GridProfileItemFunc& onItem) const
 {
-    std::list<GridProfileSection_t> l;
-
-    if (_gridProfileLength > 4) {
-        uint16_t pos = 4;
-        do {
-            const uint8_t section_id = _payloadGridProfile[pos];
-            const uint8_t section_version = _payloadGridProfile[pos + 1];
-            const int16_t section_start = getSectionStart(section_id, section_version);
-            const uint8_t section_size = getSectionSize(section_id, section_version);
-            pos += 2;
-
-            GridProfileSection_t section;
-            try {
-                section.SectionName = profileSection.at(section_id).data();
-            } catch (const std::out_of_range&) {
-                section.SectionName = "Unknown";
-                break;
-            }
-
-            if (section_start == -1) {
-                section.SectionName = "Unknown";
-                break;
-            }
-
-            for (uint8_t val_id = 0; val_id < section_size; val_id++) {
-                auto itemDefinition = itemDefinitions.at(_profileValues[section_start + val_id].ItemDefinition);
+    // Work on a copy as the callbacks may take their time
+    const GridProfilePayload_t profile = read([](const GridProfilePayload_t& p) { return p; });
+    const uint8_t* payload = profile.Data;
+    const uint8_t length = profile.Length;
+
+    uint16_t pos = 4;
+    while (pos + 1 < length) {
+        const uint8_t section_id = payload[pos];
+        const uint8_t section_version = payload[pos + 1];
+        pos += 2;
+
+        const auto sectionName = profileSection.find(section_id);
+        const GridProfileSectionIndex_t* section = getSectionIndex(section_id, section_version);
+        if (sectionName == profileSection.end() || section == nullptr) {
+            break;
+        }
 
-                float value = static_cast<int16_t>((_payloadGridProfile[pos] << 8) | _payloadGridProfile[pos + 1]);
-                value /= itemDefinition.Divider;
+        onSection(sectionName->second.data());
 
-                GridProfileItem_t v;
-                v.Name = itemDefinition.Name.data();
-                v.Unit = itemDefinition.Unit.data();
-                v.Value = value;
-                section.items.push_back(v);
+        for (uint8_t val_id = 0; val_id < section->Size && pos + 1 < length; val_id++) {
+            const auto& itemDefinition = itemDefinitions.at(profileValues[section->Start + val_id].ItemDefinition);
 
-                pos += 2;
-            }
+            float value = static_cast<int16_t>((payload[pos] << 8) | payload[pos + 1]);
+            value /= itemDefinition.Divider;
 
-            l.push_back(section);
+            onItem(itemDefinition.Name.data(), itemDefinition.Unit.data(), value);
 
-        } while (pos < _gridProfileLength);
+            pos += 2;
+        }
     }
-
-    return l;
 }
 
 bool GridProfileParser::containsValidData() const
 {
-    return _gridProfileLength > 6;
+    return read([](const GridProfilePayload_t& p) { return p.Length > 6; });
 }
 
-uint8_t GridProfileParser::getSectionSize(const uint8_t section_id, const uint8_t section_version)
+const GridProfileSectionIndex_t* GridProfileParser::getSectionIndex(const uint8_t section_id, const uint8_t section_version)
 {
-    uint8_t count = 0;
-    for (auto& values : _profileValues) {
-        if (values.Section == section_id && values.Version == section_version) {
-            count++;
+    for (auto& section : profileSectionIndex) {
+        if (section.Section == section_id && section.Version == section_version) {
+            return &section;
         }
     }
-    return count;
-}
-
-int16_t GridProfileParser::getSectionStart(const uint8_t section_id, const uint8_t section_version)
-{
-    int16_t count = -1;
-    for (auto& values : _profileValues) {
-        count++;
-        if (values.Section == section_id && values.Version == section_version) {
-            break;
-        }
-    }
-    return count;
+    return nullptr;
 }
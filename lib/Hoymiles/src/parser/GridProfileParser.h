@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 #include "Parser.h"
-#include <list>
+#include <functional>
 
 #define GRID_PROFILE_SIZE 141
 #define PROFILE_TYPE_COUNT 10
@@ -19,18 +19,17 @@ struct GridProfileValue_t {
     uint8_t ItemDefinition;
 };
 
-struct GridProfileItem_t {
-    String Name;
-    String Unit;
-    float Value;
-};
+struct GridProfileSectionIndex_t;
 
-struct GridProfileSection_t {
-    String SectionName;
-    std::list<GridProfileItem_t> items;
+struct GridProfilePayload_t {
+    uint8_t Data[GRID_PROFILE_SIZE];
+    uint8_t Length;
 };
 
-class GridProfileParser : public Parser {
+using GridProfileSectionFunc = std::function<void(const char* name)>;
+using GridProfileItemFunc = std::function<void(const char* name, const char* unit, const float value)>;
+
+class GridProfileParser : public PayloadParser<GridProfilePayload_t> {
 public:
     GridProfileParser();
     void clearBuffer();
@@ -41,17 +40,14 @@ public:
 
     std::vector<uint8_t> getRawData() const;
 
-    std::list<GridProfileSection_t> getProfile() const;
+    // Walks through the raw profile and calls onSection for every section
+    // followed by onItem for each of its values
+    void visitProfile(const GridProfileSectionFunc& onSection, const GridProfileItemFunc& onItem) const;
 
     bool containsValidData() const;
 
 private:
-    static uint8_t getSectionSize(const uint8_t section_id, const uint8_t section_version);
-    static int16_t getSectionStart(const uint8_t section_id, const uint8_t section_version);
-
-    uint8_t _payloadGridProfile[GRID_PROFILE_SIZE] = {};
-    uint8_t _gridProfileLength = 0;
+    static const GridProfileSectionIndex_t* getSectionIndex(const uint8_t section_id, const uint8_t section_version);
 
     static const std::array<const ProfileType_t, PROFILE_TYPE_COUNT> _profileTypes;
-    static const std::array<const GridProfileValue_t, SECTION_VALUE_COUNT> _profileValues;
 };
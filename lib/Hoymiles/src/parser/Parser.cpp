@@ -10,6 +10,11 @@ Parser::Parser()
     HOY_SEMAPHORE_GIVE(); // release before first use
 }
 
+Parser::~Parser()
+{
+    vSemaphoreDelete(_xSemaphore);
+}
+
 uint32_t Parser::getLastUpdate() const
 {
     return _lastUpdate;
@@ -18,6 +23,17 @@ uint32_t Parser::getLastUpdate() const
 void Parser::setLastUpdate(const uint32_t lastUpdate)
 {
     _lastUpdate = lastUpdate;
+    _stale = false;
+}
+
+bool Parser::isStale() const
+{
+    return _stale;
+}
+
+void Parser::setStale(const bool stale)
+{
+    _stale = stale;
 }
 
 void Parser::beginAppendFragment()
@@ -28,4 +44,18 @@ void Parser::beginAppendFragment()
 void Parser::endAppendFragment()
 {
     HOY_SEMAPHORE_GIVE();
+}
+
+void* Parser::operator new(size_t size)
+{
+    void* ptr = HeapAccounting.allocate(HEAP_TAG_PARSER, size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void Parser::operator delete(void* ptr)
+{
+    HeapAccounting.deallocate(HEAP_TAG_PARSER, ptr);
 }
\ No newline at end of file
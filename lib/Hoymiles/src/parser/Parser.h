@@ -1,7 +1,10 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 #include <Arduino.h>
+#include <HeapAccounting.h>
+#include <atomic>
 #include <cstdint>
+#include <utility>
 
 #define HOY_SEMAPHORE_TAKE() \
     do {                     \
@@ -17,15 +20,80 @@ typedef enum {
 class Parser {
 public:
     Parser();
+    ~Parser();
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+
     uint32_t getLastUpdate() const;
     void setLastUpdate(const uint32_t lastUpdate);
 
+    // Data was restored from a persisted snapshot and not yet confirmed by the inverter
+    bool isStale() const;
+    void setStale(const bool stale);
+
     void beginAppendFragment();
     void endAppendFragment();
 
+    // Parsers are allocated once per inverter and accounted as a whole
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+
 protected:
+    // Serializes all writers of the payload. Readers never take it.
     SemaphoreHandle_t _xSemaphore;
 
 private:
     uint32_t _lastUpdate = 0;
+    bool _stale = false;
+};
+
+// Parser with a double buffered payload of type T. Writers assemble the
+// payload between beginAppendFragment() and endAppendFragment() in the back
+// buffer which is published atomically afterwards. Readers always access the
+// last published payload without any lock and simply repeat their read if a
+// new payload was published meanwhile.
+template <typename T>
+class PayloadParser : public Parser {
+public:
+    void beginAppendFragment()
+    {
+        Parser::beginAppendFragment();
+
+        // Start with the published content as some writers only update parts of it
+        back() = _buffers[_published.load(std::memory_order_relaxed) & 1];
+    }
+
+    void endAppendFragment()
+    {
+        _published.fetch_add(1, std::memory_order_release);
+        Parser::endAppendFragment();
+    }
+
+protected:
+    // Payload which is currently assembled. Only valid between
+    // beginAppendFragment() and endAppendFragment().
+    T& back()
+    {
+        return _buffers[(_published.load(std::memory_order_relaxed) + 1) & 1];
+    }
+
+    // Calls reader with the last published payload and returns its result
+    template <typename F>
+    auto read(F&& reader) const -> decltype(reader(std::declval<const T&>()))
+    {
+        for (;;) {
+            const uint32_t published = _published.load(std::memory_order_acquire);
+            auto result = reader(_buffers[published & 1]);
+
+            // The buffer can only be reused by a writer after the next publish
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_published.load(std::memory_order_relaxed) == published) {
+                return result;
+            }
+        }
+    }
+
+private:
+    T _buffers[2] = {};
+    std::atomic<uint32_t> _published { 0 };
 };
\ No newline at end of file
@@ -57,9 +57,8 @@ const FieldId_t dailyProductionFields[] = {
 };
 
 StatisticsParser::StatisticsParser()
-    : Parser()
+    : PayloadParser()
 {
-    clearBuffer();
 }
 
 void StatisticsParser::setByteAssignment(const byteAssign_t* byteAssignment, const uint8_t size)
@@ -82,8 +81,7 @@ uint8_t StatisticsParser::getExpectedByteCount()
 
 void StatisticsParser::clearBuffer()
 {
-    memset(_payloadStatistic, 0, STATISTIC_PACKET_SIZE);
-    _statisticLength = 0;
+    back() = {};
 }
 
 void StatisticsParser::appendFragment(const uint8_t offset, const uint8_t* payload, const uint8_t len)
@@ -92,13 +90,13 @@ void StatisticsParser::appendFragment(const uint8_t offset, const uint8_t* paylo
         Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) stats packet too large for buffer\r\n", __FILE__, __LINE__);
         return;
     }
-    memcpy(&_payloadStatistic[offset], payload, len);
-    _statisticLength += len;
+    memcpy(&back().Data[offset], payload, len);
+    back().Length += len;
 }
 
 void StatisticsParser::endAppendFragment()
 {
-    Parser::endAppendFragment();
+    PayloadParser::endAppendFragment();
 
     if (!_enableYieldDayCorrection) {
         resetYieldDayCorrection();
@@ -120,6 +118,13 @@ void StatisticsParser::endAppendFragment()
     }
 }
 
+std::vector<uint8_t> StatisticsParser::getRawData() const
+{
+    return read([](const StatisticsPayload_t& p) {
+        return std::vector<uint8_t>(p.Data, p.Data + p.Length);
+    });
+}
+
 const byteAssign_t* StatisticsParser::getAssignmentByChannelField(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
 {
     for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
@@ -153,13 +158,14 @@ float StatisticsParser::getChannelFieldValue(const ChannelType_t type, const Cha
 
     if (CMD_CALC != div) {
         // Value is a static value
-        uint32_t val = 0;
-        HOY_SEMAPHORE_TAKE();
-        do {
-            val <<= 8;
-            val |= _payloadStatistic[ptr];
-        } while (++ptr != end);
-        HOY_SEMAPHORE_GIVE();
+        const auto [val, hasData] = read([ptr, end](const StatisticsPayload_t& p) {
+            uint32_t v = 0;
+            for (uint8_t i = ptr; i != end; i++) {
+                v <<= 8;
+                v |= p.Data[i];
+            }
+            return std::make_pair(v, p.Length > 0);
+        });
 
         float result;
         if (pos->isSigned && pos->num == 2) {
@@ -173,7 +179,7 @@ float StatisticsParser::getChannelFieldValue(const ChannelType_t type, const Cha
         result /= static_cast<float>(div);
 
         const fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
-        if (setting != nullptr && _statisticLength > 0) {
+        if (setting != nullptr && hasData) {
             result += setting->offset;
         }
         return result;
@@ -186,6 +192,14 @@ float StatisticsParser::getChannelFieldValue(const ChannelType_t type, const Cha
 }
 
 bool StatisticsParser::setChannelFieldValue(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, float value)
+{
+    PayloadParser::beginAppendFragment();
+    const bool ret = writeChannelFieldValue(back(), type, channel, fieldId, value);
+    PayloadParser::endAppendFragment();
+    return ret;
+}
+
+bool StatisticsParser::writeChannelFieldValue(StatisticsPayload_t& payload, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, float value)
 {
     const byteAssign_t* pos = getAssignmentByChannelField(type, channel, fieldId);
     if (pos == nullptr) {
@@ -215,12 +229,10 @@ bool StatisticsParser::setChannelFieldValue(const ChannelType_t type, const Chan
         val = static_cast<uint32_t>(value);
     }
 
-    HOY_SEMAPHORE_TAKE();
     do {
-        _payloadStatistic[ptr] = val;
+        payload.Data[ptr] = val;
         val >>= 8;
     } while (--ptr >= end);
-    HOY_SEMAPHORE_GIVE();
 
     return true;
 }
@@ -366,16 +378,21 @@ void StatisticsParser::setYieldDayCorrection(const bool enabled)
 
 void StatisticsParser::zeroFields(const FieldId_t* fields)
 {
+    // Publish all fields at once
+    PayloadParser::beginAppendFragment();
+
     // Loop all channels
     for (auto& t : getChannelTypes()) {
         for (auto& c : getChannelsByType(t)) {
             for (uint8_t i = 0; i < (sizeof(runtimeFields) / sizeof(runtimeFields[0])); i++) {
                 if (hasChannelFieldValue(t, c, fields[i])) {
-                    setChannelFieldValue(t, c, fields[i], 0);
+                    writeChannelFieldValue(back(), t, c, fields[i], 0);
                 }
             }
         }
     }
+
+    PayloadParser::endAppendFragment();
     setLastUpdateFromInternal(millis());
 }
 
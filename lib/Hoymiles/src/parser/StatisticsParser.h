@@ -3,6 +3,7 @@
 #include "Parser.h"
 #include <cstdint>
 #include <list>
+#include <vector>
 
 #define STATISTIC_PACKET_SIZE (7 * 16)
 
@@ -102,13 +103,20 @@ typedef struct {
     float offset; // offset (positive/negative) to be applied on the fetched value
 } fieldSettings_t;
 
-class StatisticsParser : public Parser {
+struct StatisticsPayload_t {
+    uint8_t Data[STATISTIC_PACKET_SIZE];
+    uint8_t Length;
+};
+
+class StatisticsParser : public PayloadParser<StatisticsPayload_t> {
 public:
     StatisticsParser();
     void clearBuffer();
     void appendFragment(const uint8_t offset, const uint8_t* payload, const uint8_t len);
     void endAppendFragment();
 
+    std::vector<uint8_t> getRawData() const;
+
     void setByteAssignment(const byteAssign_t* byteAssignment, const uint8_t size);
 
     // Returns 1 based amount of expected bytes of statistic data
@@ -155,10 +163,9 @@ public:
     void setYieldDayCorrection(const bool enabled);
 private:
     void zeroFields(const FieldId_t* fields);
+    bool writeChannelFieldValue(StatisticsPayload_t& payload, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, float value);
 
-    uint8_t _payloadStatistic[STATISTIC_PACKET_SIZE] = {};
-    uint8_t _statisticLength = 0;
-    uint16_t _stringMaxPower[CH_CNT];
+    uint16_t _stringMaxPower[CH_CNT] = {};
 
     const byteAssign_t* _byteAssignment;
     uint8_t _byteAssignmentSize;
@@ -21,15 +21,13 @@ ID   Source Addr   Target Addr   Idx  ?       Limit percent   ?       ?       ?
 #include <cstring>
 
 SystemConfigParaParser::SystemConfigParaParser()
-    : Parser()
+    : PayloadParser()
 {
-    clearBuffer();
 }
 
 void SystemConfigParaParser::clearBuffer()
 {
-    memset(_payload, 0, SYSTEM_CONFIG_PARA_SIZE);
-    _payloadLength = 0;
+    back() = {};
 }
 
 void SystemConfigParaParser::appendFragment(const uint8_t offset, const uint8_t* payload, const uint8_t len)
@@ -38,24 +36,23 @@ void SystemConfigParaParser::appendFragment(const uint8_t offset, const uint8_t*
         Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) stats packet too large for buffer\r\n", __FILE__, __LINE__);
         return;
     }
-    memcpy(&_payload[offset], payload, len);
-    _payloadLength += len;
+    memcpy(&back().Data[offset], payload, len);
+    back().Length += len;
 }
 
 float SystemConfigParaParser::getLimitPercent() const
 {
-    HOY_SEMAPHORE_TAKE();
-    const float ret = ((static_cast<uint16_t>(_payload[2]) << 8) | _payload[3]) / 10.0;
-    HOY_SEMAPHORE_GIVE();
-    return ret;
+    return read([](const SystemConfigParaPayload_t& p) {
+        return ((static_cast<uint16_t>(p.Data[2]) << 8) | p.Data[3]) / 10.0f;
+    });
 }
 
 void SystemConfigParaParser::setLimitPercent(const float value)
 {
-    HOY_SEMAPHORE_TAKE();
-    _payload[2] = static_cast<uint16_t>(value * 10) >> 8;
-    _payload[3] = static_cast<uint16_t>(value * 10);
-    HOY_SEMAPHORE_GIVE();
+    beginAppendFragment();
+    back().Data[2] = static_cast<uint16_t>(value * 10) >> 8;
+    back().Data[3] = static_cast<uint16_t>(value * 10);
+    endAppendFragment();
 }
 
 void SystemConfigParaParser::setLastLimitCommandSuccess(const LastCommandSuccess status)
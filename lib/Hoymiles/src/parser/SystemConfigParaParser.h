@@ -4,7 +4,12 @@
 
 #define SYSTEM_CONFIG_PARA_SIZE 16
 
-class SystemConfigParaParser : public Parser {
+struct SystemConfigParaPayload_t {
+    uint8_t Data[SYSTEM_CONFIG_PARA_SIZE];
+    uint8_t Length;
+};
+
+class SystemConfigParaParser : public PayloadParser<SystemConfigParaPayload_t> {
 public:
     SystemConfigParaParser();
     void clearBuffer();
@@ -27,9 +32,6 @@ public:
     uint8_t getExpectedByteCount() const;
 
 private:
-    uint8_t _payload[SYSTEM_CONFIG_PARA_SIZE];
-    uint8_t _payloadLength;
-
     LastCommandSuccess _lastLimitCommandSuccess = CMD_OK; // Set to OK because we have to assume nothing is done at startup
     LastCommandSuccess _lastLimitRequestSuccess = CMD_NOK; // Set to NOK to fetch at startup
 
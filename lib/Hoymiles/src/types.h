@@ -12,10 +12,8 @@ union serial_u {
 #define MAX_RF_PAYLOAD_SIZE 32
 
 typedef struct {
-    uint8_t mainCmd;
     uint8_t fragment[MAX_RF_PAYLOAD_SIZE];
     uint8_t len;
     uint8_t channel;
     int8_t rssi;
-    bool wasReceived;
 } fragment_t;
@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <utility>
+
+// Fixed capacity queue without locks and without any heap allocation.
+// Elements are constructed in place and can be move only.
+//
+// The generic variant supports multiple producers and consumers. Every slot
+// carries a sequence number which tells producers and consumers whether the
+// slot is free or filled (bounded queue as described by Dmitry Vyukov).
+//
+// The variant with SingleProducerSingleConsumer set only uses two indices
+// and never retries. It can be used between an ISR and a task as long as
+// only one context pushes and only one context pops. Please note that the
+// methods are not placed in IRAM.
+//
+// Differences to ThreadSafeQueue, which can be replaced by this queue:
+// - push(), try_push() and emplace() return false if the queue is full.
+//   ThreadSafeQueue has the same signatures but always returns true.
+// - front() is only provided by the single consumer variant and returns a
+//   pointer (nullptr if empty) instead of a copy. The generic variant has
+//   no front() as another consumer could pop the element meanwhile.
+// - size() of the generic variant is only a snapshot.
+// - The queue can neither be copied nor moved.
+//
+// test/native/queue/QueueBenchmark.cpp compares the throughput and latency
+// with ThreadSafeQueue on the host.
+template <typename T, size_t Capacity, bool SingleProducerSingleConsumer = false>
+class BoundedQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+public:
+    BoundedQueue()
+    {
+        for (size_t i = 0; i < Capacity; i++) {
+            _cells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    ~BoundedQueue()
+    {
+        while (consume([](T&&) {})) { }
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Approximate amount of elements as other contexts might modify the queue meanwhile
+    unsigned long size() const
+    {
+        const size_t head = _enqueuePos.load(std::memory_order_relaxed);
+        const size_t tail = _dequeuePos.load(std::memory_order_relaxed);
+        return head - tail;
+    }
+
+    // Returns false if the queue is full
+    template <typename... Args>
+    bool emplace(Args&&... args)
+    {
+        Cell* cell;
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &_cells[pos & (Capacity - 1)];
+            const size_t seq = cell->Sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->Data) T(std::forward<Args>(args)...);
+        cell->Sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item) { return emplace(item); }
+    bool try_push(T&& item) { return emplace(std::move(item)); }
+    bool push(const T& item) { return emplace(item); }
+    bool push(T&& item) { return emplace(std::move(item)); }
+
+    // Returns false if the queue is empty
+    bool try_pop(T& item)
+    {
+        return consume([&item](T&& elem) { item = std::move(elem); });
+    }
+
+    std::optional<T> pop()
+    {
+        std::optional<T> ret;
+        consume([&ret](T&& item) { ret.emplace(std::move(item)); });
+        return ret;
+    }
+
+private:
+    template <typename F>
+    bool consume(F&& onItem)
+    {
+        Cell* cell;
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &_cells[pos & (Capacity - 1)];
+            const size_t seq = cell->Sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* elem = std::launder(reinterpret_cast<T*>(cell->Data));
+        onItem(std::move(*elem));
+        elem->~T();
+        cell->Sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    struct Cell {
+        std::atomic<size_t> Sequence;
+        alignas(T) unsigned char Data[sizeof(T)];
+    };
+
+    Cell _cells[Capacity];
+    std::atomic<size_t> _enqueuePos { 0 };
+    std::atomic<size_t> _dequeuePos { 0 };
+};
+
+template <typename T, size_t Capacity>
+class BoundedQueue<T, Capacity, true> {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+public:
+    BoundedQueue() = default;
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    ~BoundedQueue()
+    {
+        while (consume([](T&&) {})) { }
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    unsigned long size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    // Must only be called by the producer. Returns false if the queue is full.
+    template <typename... Args>
+    bool emplace(Args&&... args)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        new (_data[head & (Capacity - 1)]) T(std::forward<Args>(args)...);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item) { return emplace(item); }
+    bool try_push(T&& item) { return emplace(std::move(item)); }
+    bool push(const T& item) { return emplace(item); }
+    bool push(T&& item) { return emplace(std::move(item)); }
+
+    // Must only be called by the consumer. Returns nullptr if the queue is empty.
+    // The element stays valid until it is popped.
+    T* front()
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (_head.load(std::memory_order_acquire) == tail) {
+            return nullptr;
+        }
+        return std::launder(reinterpret_cast<T*>(_data[tail & (Capacity - 1)]));
+    }
+
+    // Must only be called by the consumer. Returns false if the queue is empty.
+    bool try_pop(T& item)
+    {
+        return consume([&item](T&& elem) { item = std::move(elem); });
+    }
+
+    std::optional<T> pop()
+    {
+        std::optional<T> ret;
+        consume([&ret](T&& item) { ret.emplace(std::move(item)); });
+        return ret;
+    }
+
+private:
+    template <typename F>
+    bool consume(F&& onItem)
+    {
+        T* elem = front();
+        if (elem == nullptr) {
+            return false;
+        }
+
+        onItem(std::move(*elem));
+        elem->~T();
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    alignas(T) unsigned char _data[Capacity][sizeof(T)];
+    std::atomic<size_t> _head { 0 }; // Next slot to write, only modified by the producer
+    std::atomic<size_t> _tail { 0 }; // Next slot to read, only modified by the consumer
+};
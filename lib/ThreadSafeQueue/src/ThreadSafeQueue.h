@@ -4,6 +4,7 @@
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <utility>
 
 template <typename T>
 class ThreadSafeQueue {
@@ -32,15 +33,47 @@ public:
         if (_queue.empty()) {
             return {};
         }
-        T tmp = _queue.front();
+        T tmp = std::move(_queue.front());
         _queue.pop();
         return tmp;
     }
 
-    void push(const T& item)
+    bool try_pop(T& item)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queue.empty()) {
+            return false;
+        }
+        item = std::move(_queue.front());
+        _queue.pop();
+        return true;
+    }
+
+    // The queue is never full. The result is only returned to be
+    // interchangeable with BoundedQueue.
+    bool push(const T& item)
     {
         std::lock_guard<std::mutex> lock(_mutex);
         _queue.push(item);
+        return true;
+    }
+
+    bool push(T&& item)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push(std::move(item));
+        return true;
+    }
+
+    bool try_push(const T& item) { return push(item); }
+    bool try_push(T&& item) { return push(std::move(item)); }
+
+    template <typename... Args>
+    bool emplace(Args&&... args)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.emplace(std::forward<Args>(args)...);
+        return true;
     }
 
     T front()
@@ -0,0 +1,51 @@
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+# Copyright (C) 2024 Thomas Basler and others
+#
+import hashlib
+import os
+import re
+
+Import("env")
+
+
+def updateFileIfChanged(filename, content):
+    mustUpdate = True
+    try:
+        with open(filename, "rb") as fp:
+            if fp.read() == content:
+                mustUpdate = False
+    except:
+        pass
+    if mustUpdate:
+        with open(filename, "wb") as fp:
+            fp.write(content)
+    return mustUpdate
+
+
+def get_embed_files():
+    files = env.GetProjectOption("board_build.embed_files", "")
+    if isinstance(files, str):
+        files = files.split()
+    return [f.strip() for f in files if f.strip()]
+
+
+def do_main():
+    # For every embedded file an ETag is generated. The symbol name matches the
+    # _start/_end symbols created by the linker with an _etag suffix.
+    targetfile = os.path.join(env.subst("$BUILD_DIR"), "__compiled_webapp_etags.c")
+    lines = ""
+    lines += "/* Generated file within build process - Do NOT edit */\n"
+
+    for file in get_embed_files():
+        with open(os.path.join(env.subst("$PROJECT_DIR"), file), "rb") as fp:
+            md5 = hashlib.md5(fp.read()).hexdigest()
+        symbol = "_binary_" + re.sub(r"[^A-Za-z0-9]", "_", file) + "_etag"
+        lines += 'const char %s[] = "\\"%s\\"";\n' % (symbol, md5)
+
+    updateFileIfChanged(targetfile, bytes(lines, "utf-8"))
+
+    # Add the created file to the buildfiles - platformio knows how to handle *.c files
+    env.AppendUnique(PIOBUILDFILES=[targetfile])
+
+do_main()
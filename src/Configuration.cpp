@@ -5,10 +5,19 @@
 #include "Configuration.h"
 #include "MessageOutput.h"
 #include "NetworkSettings.h"
+#include "StallDetector.h"
+#include "TaskProfiler.h"
 #include "Utils.h"
 #include "defaults.h"
 #include <ArduinoJson.h>
+#include <HeapTaggedJsonAllocator.h>
 #include <LittleFS.h>
+#include <algorithm>
+#include <esp_rom_crc.h>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
 #include <nvs_flash.h>
 
 CONFIG_T config;
@@ -17,10 +26,93 @@ static std::condition_variable sWriterCv;
 static std::mutex sWriterMutex;
 static unsigned sWriterCount = 0;
 
+struct CONFIG_BINARY_HEADER_T {
+    uint32_t Magic;
+    uint16_t Format;
+    uint16_t SectionCount;
+    uint32_t Length;
+    uint32_t Crc;
+};
+
+struct CONFIG_SECTION_HEADER_T {
+    uint16_t Id;
+    uint16_t Layout;
+    uint16_t Length;
+};
+
+// Section header of CONFIG_BINARY_FORMAT 1, which implies layout 1
+struct CONFIG_SECTION_HEADER_V1_T {
+    uint16_t Id;
+    uint16_t Length;
+};
+
+struct ConfigSection {
+    uint16_t id;
+    uint16_t layout;
+    void* data;
+    uint16_t size;
+
+    // Converts a section stored with an older layout. Returns false if the
+    // layout is unknown. Optional, the section keeps its defaults otherwise.
+    bool (*upgrade)(const uint16_t layout, const uint8_t* data, const uint16_t length);
+};
+
+// Section ids must never be reused. Members may be appended to the end of a
+// section without changing its layout: a shorter stored section is copied and
+// the new members keep their defaults. The layout has to be increased
+// whenever existing members change, even if the size stays the same.
+static const ConfigSection sConfigSections[] = {
+    { 1, 1, &config.Cfg, sizeof(config.Cfg), nullptr },
+    { 2, 1, &config.WiFi, sizeof(config.WiFi), nullptr },
+    { 3, 1, &config.Mdns, sizeof(config.Mdns), nullptr },
+    { 4, 1, &config.Ntp, sizeof(config.Ntp), nullptr },
+    { 5, 1, &config.Modbus, sizeof(config.Modbus), nullptr },
+    { 6, 1, &config.Mqtt, sizeof(config.Mqtt), nullptr },
+    { 7, 1, &config.Dtu, sizeof(config.Dtu), nullptr },
+    { 8, 1, &config.Security, sizeof(config.Security), nullptr },
+    { 9, 1, &config.Display, sizeof(config.Display), nullptr },
+    { 10, 1, &config.Led_Single, sizeof(config.Led_Single), nullptr },
+    { 11, 1, &config.Inverter, sizeof(config.Inverter), nullptr },
+    { 12, 1, &config.Dev_PinMapping, sizeof(config.Dev_PinMapping), nullptr },
+};
+
+struct ConfigBlobInfo {
+    const char* filename;
+    const char* defaultValue;
+};
+
+// Indexed by ConfigBlob
+static const ConfigBlobInfo sConfigBlobs[] = {
+    { "/mqtt_root_ca.pem", MQTT_ROOT_CA_CERT },
+    { "/mqtt_client_cert.pem", MQTT_TLSCLIENTCERT },
+    { "/mqtt_client_key.pem", MQTT_TLSCLIENTKEY },
+};
+static_assert(std::size(sConfigBlobs) == CONFIG_BLOB_COUNT);
+
+static bool writeFileAtomic(const char* filename, const std::function<bool(File&)>& writer)
+{
+    const String tmpFilename = String(filename) + ".tmp";
+
+    File f = LittleFS.open(tmpFilename, "w");
+    if (!f) {
+        return false;
+    }
+    const bool success = writer(f);
+    f.close();
+
+    if (!success) {
+        LittleFS.remove(tmpFilename);
+        return false;
+    }
+
+    // LittleFS replaces an existing target within a single metadata commit
+    return LittleFS.rename(tmpFilename, filename);
+}
+
 void ConfigurationClass::init(Scheduler& scheduler)
 {
     scheduler.addTask(_loopTask);
-    _loopTask.setCallback(std::bind(&ConfigurationClass::loop, this));
+    _loopTask.setCallback(TaskProfiler.wrap("Configuration", std::bind(&ConfigurationClass::loop, this)));
     _loopTask.setIterations(TASK_FOREVER);
     _loopTask.enable();
 
@@ -29,14 +121,62 @@ void ConfigurationClass::init(Scheduler& scheduler)
 
 bool ConfigurationClass::write()
 {
-    File f = LittleFS.open(CONFIG_FILENAME, "w");
-    if (!f) {
+    StallDetectorClass::Scope stallScope("ConfigWrite");
+
+    const bool blobsWritten = writePendingBlobs();
+
+    config.Cfg.SaveCount++;
+
+    CONFIG_BINARY_HEADER_T header = {};
+    header.Magic = CONFIG_BINARY_MAGIC;
+    header.Format = CONFIG_BINARY_FORMAT;
+    header.SectionCount = std::size(sConfigSections);
+
+    for (const auto& section : sConfigSections) {
+        const CONFIG_SECTION_HEADER_T sectionHeader = { section.id, section.layout, section.size };
+        header.Crc = esp_rom_crc32_le(header.Crc, reinterpret_cast<const uint8_t*>(&sectionHeader), sizeof(sectionHeader));
+        header.Crc = esp_rom_crc32_le(header.Crc, static_cast<const uint8_t*>(section.data), section.size);
+        header.Length += sizeof(sectionHeader) + section.size;
+    }
+
+    const bool success = writeFileAtomic(CONFIG_BINARY_FILENAME, [&header](File& f) {
+        if (f.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+            return false;
+        }
+        for (const auto& section : sConfigSections) {
+            const CONFIG_SECTION_HEADER_T sectionHeader = { section.id, section.layout, section.size };
+            if (f.write(reinterpret_cast<const uint8_t*>(&sectionHeader), sizeof(sectionHeader)) != sizeof(sectionHeader)
+                || f.write(static_cast<const uint8_t*>(section.data), section.size) != section.size) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    if (!success) {
+        MessageOutput.println("Failed to write file");
         return false;
     }
-    config.Cfg.SaveCount++;
 
-    JsonDocument doc;
+    return blobsWritten;
+}
 
+void ConfigurationClass::writeFallback()
+{
+    // The certificates are stored in their own files independent of the layout
+    const bool success = writeFileAtomic(CONFIG_FALLBACK_FILENAME, [this](File& f) {
+        JsonDocument doc(HeapTaggedJsonAllocator::get(HEAP_TAG_CONFIG));
+        toJson(doc, false);
+        return Utils::checkJsonAlloc(doc, __FUNCTION__, __LINE__) && serializeJson(doc, f) > 0;
+    });
+
+    if (!success) {
+        MessageOutput.println("Failed to write fallback file");
+    }
+}
+
+void ConfigurationClass::toJson(JsonDocument& doc, const bool includeBlobs)
+{
     JsonObject cfg = doc["cfg"].to<JsonObject>();
     cfg["version"] = config.Cfg.Version;
     cfg["save_count"] = config.Cfg.SaveCount;
@@ -92,10 +232,12 @@ bool ConfigurationClass::write()
 
     JsonObject mqtt_tls = mqtt["tls"].to<JsonObject>();
     mqtt_tls["enabled"] = config.Mqtt.Tls.Enabled;
-    mqtt_tls["root_ca_cert"] = config.Mqtt.Tls.RootCaCert;
     mqtt_tls["certlogin"] = config.Mqtt.Tls.CertLogin;
-    mqtt_tls["client_cert"] = config.Mqtt.Tls.ClientCert;
-    mqtt_tls["client_key"] = config.Mqtt.Tls.ClientKey;
+    if (includeBlobs) {
+        mqtt_tls["root_ca_cert"] = readBlob(ConfigBlob::MqttRootCaCert);
+        mqtt_tls["client_cert"] = readBlob(ConfigBlob::MqttClientCert);
+        mqtt_tls["client_key"] = readBlob(ConfigBlob::MqttClientKey);
+    }
 
     JsonObject mqtt_hass = mqtt["hass"].to<JsonObject>();
     mqtt_hass["enabled"] = config.Mqtt.Hass.Enabled;
@@ -158,38 +300,189 @@ bool ConfigurationClass::write()
             chanData["yield_total_offset"] = config.Inverter[i].channel[c].YieldTotalOffset;
         }
     }
+}
+
+size_t ConfigurationClass::exportJson(Print& output)
+{
+    JsonDocument doc(HeapTaggedJsonAllocator::get(HEAP_TAG_CONFIG));
+    toJson(doc);
 
     if (!Utils::checkJsonAlloc(doc, __FUNCTION__, __LINE__)) {
+        return 0;
+    }
+
+    return serializeJson(doc, output);
+}
+
+bool ConfigurationClass::read()
+{
+    bool ret;
+
+    if (LittleFS.exists(CONFIG_FILENAME)) {
+        // Configuration of an older firmware or a restored backup
+        MessageOutput.print("importing JSON... ");
+        ret = readJson(CONFIG_FILENAME);
+    } else {
+        bool layoutChanged = false;
+        ret = readBinary(layoutChanged);
+        if (!ret && LittleFS.exists(CONFIG_FALLBACK_FILENAME)) {
+            MessageOutput.print("importing fallback JSON... ");
+            ret = readJson(CONFIG_FALLBACK_FILENAME);
+        } else if (ret && layoutChanged) {
+            // Store the upgraded sections right away. The JSON copy allows a
+            // firmware which can not read the new layout to import the settings.
+            writeFallback();
+            write();
+        }
+    }
+
+    // Check for default DTU serial
+    MessageOutput.print("Check for default DTU serial... ");
+    if (config.Dtu.Serial == DTU_SERIAL) {
+        MessageOutput.print("generate serial based on ESP chip id: ");
+        const uint64_t dtuId = Utils::generateDtuSerial();
+        MessageOutput.printf("%0" PRIx32 "%08" PRIx32 "... ",
+            static_cast<uint32_t>((dtuId >> 32) & 0xFFFFFFFF),
+            static_cast<uint32_t>(dtuId & 0xFFFFFFFF));
+        config.Dtu.Serial = dtuId;
+        write();
+    }
+    MessageOutput.println("done");
+
+    return ret;
+}
+
+bool ConfigurationClass::readBinary(bool& layoutChanged)
+{
+    // Start with defaults, every valid section overrides them afterwards
+    JsonDocument defaults(HeapTaggedJsonAllocator::get(HEAP_TAG_CONFIG));
+    fromJson(defaults);
+
+    File f = LittleFS.open(CONFIG_BINARY_FILENAME, "r", false);
+    if (!f) {
+        MessageOutput.println("Failed to read file, using default configuration");
         return false;
     }
 
-    // Serialize JSON to file
-    if (serializeJson(doc, f) == 0) {
-        MessageOutput.println("Failed to write file");
+    CONFIG_BINARY_HEADER_T header;
+    if (f.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)
+        || header.Magic != CONFIG_BINARY_MAGIC
+        || (header.Format != CONFIG_BINARY_FORMAT && header.Format != 1)
+        || header.Length != f.size() - sizeof(header)) {
+        MessageOutput.println("Invalid file header, using default configuration");
+        return false;
+    }
+
+    std::unique_ptr<uint8_t[]> payload(new (std::nothrow) uint8_t[header.Length]);
+    if (payload == nullptr) {
+        MessageOutput.printf("Alloc failed: %s, %" PRId16 "\r\n", __FUNCTION__, __LINE__);
         return false;
     }
 
+    if (f.read(payload.get(), header.Length) != header.Length
+        || esp_rom_crc32_le(0, payload.get(), header.Length) != header.Crc) {
+        MessageOutput.println("Checksum mismatch, using default configuration");
+        return false;
+    }
     f.close();
+
+    const size_t sectionHeaderSize = header.Format == 1 ? sizeof(CONFIG_SECTION_HEADER_V1_T) : sizeof(CONFIG_SECTION_HEADER_T);
+    uint16_t sectionsRead = 0;
+    layoutChanged = header.Format != CONFIG_BINARY_FORMAT;
+
+    size_t pos = 0;
+    for (uint16_t i = 0; i < header.SectionCount && pos + sectionHeaderSize <= header.Length; i++) {
+        CONFIG_SECTION_HEADER_T sectionHeader;
+        if (header.Format == 1) {
+            CONFIG_SECTION_HEADER_V1_T v1Header;
+            memcpy(&v1Header, &payload[pos], sizeof(v1Header));
+            sectionHeader = { v1Header.Id, 1, v1Header.Length };
+        } else {
+            memcpy(&sectionHeader, &payload[pos], sizeof(sectionHeader));
+        }
+        pos += sectionHeaderSize;
+
+        if (pos + sectionHeader.Length > header.Length) {
+            break;
+        }
+
+        const auto section = std::find_if(std::begin(sConfigSections), std::end(sConfigSections),
+            [&sectionHeader](const ConfigSection& s) { return s.id == sectionHeader.Id; });
+
+        if (section == std::end(sConfigSections)) {
+            MessageOutput.printf("Skipping unknown section %" PRIu16 "... ", sectionHeader.Id);
+            layoutChanged = true;
+        } else if (section->layout == sectionHeader.Layout) {
+            // Members appended by a later firmware are dropped, new ones keep their defaults
+            memcpy(section->data, &payload[pos], std::min(section->size, sectionHeader.Length));
+            layoutChanged |= section->size != sectionHeader.Length;
+            sectionsRead++;
+        } else if (section->upgrade != nullptr && section->upgrade(sectionHeader.Layout, &payload[pos], sectionHeader.Length)) {
+            MessageOutput.printf("Upgraded section %" PRIu16 "... ", sectionHeader.Id);
+            layoutChanged = true;
+            sectionsRead++;
+        } else {
+            MessageOutput.printf("Unknown layout of section %" PRIu16 ", using defaults... ", sectionHeader.Id);
+            layoutChanged = true;
+        }
+
+        pos += sectionHeader.Length;
+    }
+
+    // Sections added by this firmware keep their defaults
+    layoutChanged |= sectionsRead != std::size(sConfigSections);
+
     return true;
 }
 
-bool ConfigurationClass::read()
+bool ConfigurationClass::readJson(const char* filename)
 {
-    File f = LittleFS.open(CONFIG_FILENAME, "r", false);
+    File f = LittleFS.open(filename, "r", false);
     Utils::skipBom(f);
 
-    JsonDocument doc;
+    JsonDocument doc(HeapTaggedJsonAllocator::get(HEAP_TAG_CONFIG));
 
     // Deserialize the JSON document
     const DeserializationError error = deserializeJson(doc, f);
+    f.close();
+
     if (error) {
-        MessageOutput.println("Failed to read file, using default configuration");
+        // Keep the file, it is imported again once it was fixed or replaced
+        MessageOutput.printf("Failed to read file, using default configuration: %s\r\n", error.c_str());
+        doc.clear();
+        fromJson(doc);
+        return false;
     }
 
     if (!Utils::checkJsonAlloc(doc, __FUNCTION__, __LINE__)) {
         return false;
     }
 
+    fromJson(doc);
+
+    // The fallback file does not contain the certificates, their files are kept then
+    JsonObject mqtt_tls = doc["mqtt"]["tls"];
+    if (mqtt_tls["root_ca_cert"].is<const char*>()) {
+        writeBlob(ConfigBlob::MqttRootCaCert, mqtt_tls["root_ca_cert"].as<const char*>());
+    }
+    if (mqtt_tls["client_cert"].is<const char*>()) {
+        writeBlob(ConfigBlob::MqttClientCert, mqtt_tls["client_cert"].as<const char*>());
+    }
+    if (mqtt_tls["client_key"].is<const char*>()) {
+        writeBlob(ConfigBlob::MqttClientKey, mqtt_tls["client_key"].as<const char*>());
+    }
+
+    // If a migration is pending the file is still required and will be removed by migrate().
+    // The fallback file is kept until the next layout or version change.
+    if (config.Cfg.Version == CONFIG_VERSION && write() && strcmp(filename, CONFIG_FILENAME) == 0) {
+        LittleFS.remove(CONFIG_FILENAME);
+    }
+
+    return true;
+}
+
+void ConfigurationClass::fromJson(JsonDocument& doc)
+{
     JsonObject cfg = doc["cfg"];
     config.Cfg.Version = cfg["version"] | CONFIG_VERSION;
     config.Cfg.SaveCount = cfg["save_count"] | 0;
@@ -276,10 +569,7 @@ bool ConfigurationClass::read()
 
     JsonObject mqtt_tls = mqtt["tls"];
     config.Mqtt.Tls.Enabled = mqtt_tls["enabled"] | MQTT_TLS;
-    strlcpy(config.Mqtt.Tls.RootCaCert, mqtt_tls["root_ca_cert"] | MQTT_ROOT_CA_CERT, sizeof(config.Mqtt.Tls.RootCaCert));
     config.Mqtt.Tls.CertLogin = mqtt_tls["certlogin"] | MQTT_TLSCERTLOGIN;
-    strlcpy(config.Mqtt.Tls.ClientCert, mqtt_tls["client_cert"] | MQTT_TLSCLIENTCERT, sizeof(config.Mqtt.Tls.ClientCert));
-    strlcpy(config.Mqtt.Tls.ClientKey, mqtt_tls["client_key"] | MQTT_TLSCLIENTKEY, sizeof(config.Mqtt.Tls.ClientKey));
 
     JsonObject mqtt_hass = mqtt["hass"];
     config.Mqtt.Hass.Enabled = mqtt_hass["enabled"] | MQTT_HASS_ENABLED;
@@ -342,44 +632,26 @@ bool ConfigurationClass::read()
             strlcpy(config.Inverter[i].channel[c].Name, channel[c]["name"] | "", sizeof(config.Inverter[i].channel[c].Name));
         }
     }
-
-    f.close();
-
-    // Check for default DTU serial
-    MessageOutput.print("Check for default DTU serial... ");
-    if (config.Dtu.Serial == DTU_SERIAL) {
-        MessageOutput.print("generate serial based on ESP chip id: ");
-        const uint64_t dtuId = Utils::generateDtuSerial();
-        MessageOutput.printf("%0" PRIx32 "%08" PRIx32 "... ",
-            static_cast<uint32_t>((dtuId >> 32) & 0xFFFFFFFF),
-            static_cast<uint32_t>(dtuId & 0xFFFFFFFF));
-        config.Dtu.Serial = dtuId;
-        write();
-    }
-    MessageOutput.println("done");
-
-    return true;
 }
 
 void ConfigurationClass::migrate()
 {
-    File f = LittleFS.open(CONFIG_FILENAME, "r", false);
-    if (!f) {
-        MessageOutput.println("Failed to open file, cancel migration");
-        return;
-    }
+    JsonDocument doc(HeapTaggedJsonAllocator::get(HEAP_TAG_CONFIG));
 
-    JsonDocument doc;
-
-    // Deserialize the JSON document
-    const DeserializationError error = deserializeJson(doc, f);
-    if (error) {
-        MessageOutput.printf("Failed to read file, cancel migration: %s\r\n", error.c_str());
-        return;
-    }
+    // Settings of versions prior to the binary format are only available in the JSON file
+    File f = LittleFS.open(CONFIG_FILENAME, "r", false);
+    if (f) {
+        // Deserialize the JSON document
+        const DeserializationError error = deserializeJson(doc, f);
+        f.close();
+        if (error) {
+            MessageOutput.printf("Failed to read file, cancel migration: %s\r\n", error.c_str());
+            return;
+        }
 
-    if (!Utils::checkJsonAlloc(doc, __FUNCTION__, __LINE__)) {
-        return;
+        if (!Utils::checkJsonAlloc(doc, __FUNCTION__, __LINE__)) {
+            return;
+        }
     }
 
     if (config.Cfg.Version < 0x00011700) {
@@ -439,13 +711,103 @@ void ConfigurationClass::migrate()
         }
     }
 
-    f.close();
-
     config.Cfg.Version = CONFIG_VERSION;
-    write();
+    if (write()) {
+        writeFallback();
+        LittleFS.remove(CONFIG_FILENAME);
+    }
     read();
 }
 
+String ConfigurationClass::readBlob(const ConfigBlob blob)
+{
+    const auto& info = sConfigBlobs[static_cast<uint8_t>(blob)];
+
+    {
+        std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+        const auto& pending = _pendingBlobs[static_cast<uint8_t>(blob)];
+        if (pending.has_value()) {
+            return *pending;
+        }
+    }
+
+    File f = LittleFS.open(info.filename, "r", false);
+    if (!f) {
+        return info.defaultValue;
+    }
+
+    String value;
+    value.reserve(f.size());
+
+    char buffer[128];
+    size_t len;
+    while ((len = f.read(reinterpret_cast<uint8_t*>(buffer), sizeof(buffer))) > 0) {
+        value.concat(buffer, len);
+    }
+    f.close();
+
+    return value;
+}
+
+bool ConfigurationClass::writeBlob(const ConfigBlob blob, const String& value)
+{
+    const auto& info = sConfigBlobs[static_cast<uint8_t>(blob)];
+
+    {
+        std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+        _pendingBlobs[static_cast<uint8_t>(blob)].reset();
+    }
+
+    if (readBlob(blob) == value) {
+        return true;
+    }
+
+    return writeFileAtomic(info.filename, [&value](File& f) {
+        return f.write(reinterpret_cast<const uint8_t*>(value.c_str()), value.length()) == value.length();
+    });
+}
+
+void ConfigurationClass::setBlob(const ConfigBlob blob, const String& value)
+{
+    if (readBlob(blob) == value) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+    _pendingBlobs[static_cast<uint8_t>(blob)] = value;
+}
+
+bool ConfigurationClass::writePendingBlobs()
+{
+    bool success = true;
+
+    for (uint8_t i = 0; i < CONFIG_BLOB_COUNT; i++) {
+        std::optional<String> value;
+        {
+            std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+            value.swap(_pendingBlobs[i]);
+        }
+        if (!value.has_value()) {
+            continue;
+        }
+
+        const bool written = writeFileAtomic(sConfigBlobs[i].filename, [&value](File& f) {
+            return f.write(reinterpret_cast<const uint8_t*>(value->c_str()), value->length()) == value->length();
+        });
+
+        if (!written) {
+            // Keep the value for the next write unless a newer one was set meanwhile
+            std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+            if (!_pendingBlobs[i].has_value()) {
+                _pendingBlobs[i] = std::move(value);
+            }
+            success = false;
+        }
+    }
+
+    return success;
+}
+
 CONFIG_T const& ConfigurationClass::get()
 {
     return config;
@@ -500,13 +862,98 @@ void ConfigurationClass::deleteInverterById(const uint8_t id)
     }
 }
 
+uint32_t ConfigurationClass::writeDeferred(const WriteCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+
+    const uint32_t now = millis();
+    if (!_writeStats.Pending) {
+        _writeStats.Pending = true;
+        _writeFirstRequest = now;
+    }
+    _writeLastRequest = now;
+    _writeStats.Requests++;
+
+    if (callback) {
+        _writeCallbacks.push_back(callback);
+    }
+
+    return _writeStats.Requests;
+}
+
+void ConfigurationClass::flush()
+{
+    std::vector<WriteCallback> callbacks;
+    uint32_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+        if (!_writeStats.Pending) {
+            return;
+        }
+        _writeStats.Pending = false;
+        sequence = _writeStats.Requests;
+        callbacks.swap(_writeCallbacks);
+    }
+
+    const uint32_t start = millis();
+    const bool success = write();
+    const uint32_t duration = millis() - start;
+
+    {
+        std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+        _writeStats.Writes++;
+        _writeStats.Completed = sequence;
+        if (success) {
+            _writeStats.Saved = sequence;
+        }
+        _writeStats.LastSuccess = success;
+        _writeStats.LastDuration = duration;
+        _writeStats.MaxDuration = std::max(_writeStats.MaxDuration, duration);
+    }
+
+    for (auto& callback : callbacks) {
+        callback(success);
+    }
+}
+
+void ConfigurationClass::discardPendingWrite()
+{
+    std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+    _writeStats.Pending = false;
+    _writeCallbacks.clear();
+    for (auto& blob : _pendingBlobs) {
+        blob.reset();
+    }
+}
+
+ConfigurationClass::WriteStats ConfigurationClass::getWriteStats()
+{
+    std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+    return _writeStats;
+}
+
 void ConfigurationClass::loop()
 {
-    std::unique_lock<std::mutex> lock(sWriterMutex);
-    if (sWriterCount == 0) { return; }
+    {
+        std::unique_lock<std::mutex> lock(sWriterMutex);
+        if (sWriterCount > 0) {
+            sWriterCv.notify_all();
+            sWriterCv.wait(lock, [] { return sWriterCount == 0; });
+        }
+    }
+
+    {
+        // Wait until no further changes arrive, but do not postpone the write forever
+        std::lock_guard<std::mutex> lock(_deferredWriteMutex);
+        const uint32_t now = millis();
+        if (!_writeStats.Pending
+            || (now - _writeLastRequest < CONFIG_WRITE_DELAY
+                && now - _writeFirstRequest < CONFIG_WRITE_MAX_DELAY)) {
+            return;
+        }
+    }
 
-    sWriterCv.notify_all();
-    sWriterCv.wait(lock, [] { return sWriterCount == 0; });
+    flush();
 }
 
 CONFIG_T& ConfigurationClass::WriteGuard::getConfig()
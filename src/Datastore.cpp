@@ -4,12 +4,13 @@
  */
 #include "Datastore.h"
 #include "Configuration.h"
+#include "TaskProfiler.h"
 #include <Hoymiles.h>
 
 DatastoreClass Datastore;
 
 DatastoreClass::DatastoreClass()
-    : _loopTask(1 * TASK_SECOND, TASK_FOREVER, std::bind(&DatastoreClass::loop, this))
+    : _loopTask(1 * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("Datastore", std::bind(&DatastoreClass::loop, this)))
 {
 }
 
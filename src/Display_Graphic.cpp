@@ -5,6 +5,7 @@
 #include "Display_Graphic.h"
 #include "Datastore.h"
 #include "I18n.h"
+#include "TaskProfiler.h"
 #include <NetworkSettings.h>
 #include <map>
 #include <time.h>
@@ -36,7 +37,7 @@ static const char* const i18n_yield_total_mwh[] = { "total: %.0f kWh", "Ges.: %.
 static const char* const i18n_date_format[] = { "%m/%d/%Y %H:%M", "%d.%m.%Y %H:%M", "%d/%m/%Y %H:%M" };
 
 DisplayGraphicClass::DisplayGraphicClass()
-    : _loopTask(TASK_IMMEDIATE, TASK_FOREVER, std::bind(&DisplayGraphicClass::loop, this))
+    : _loopTask(TASK_IMMEDIATE, TASK_FOREVER, TaskProfiler.wrap("Display", std::bind(&DisplayGraphicClass::loop, this)))
 {
 }
 
@@ -0,0 +1,628 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "EnergyLog.h"
+#include "MessageOutput.h"
+#include "StallDetector.h"
+#include "TaskProfiler.h"
+#include <Hoymiles.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include <esp_rom_crc.h>
+
+EnergyLogClass EnergyLog;
+
+// File format of the log
+//
+// The log is a sequence of records: <type:1> <length:varint> <payload:length> <crc8:1>
+// All numbers within the payload are unsigned LEB128 varints, except the serial (8 bytes LE).
+//
+// Checkpoint: <index> <inverter count> { <serial:8> <channels:1> { <yield total Wh> } }
+// Interval:   <index - index of previous record> { <energy Wh> }
+//
+// A checkpoint is written at the beginning of every file, after every boot, on layout
+// changes and once a day. Interval records are only written if energy was produced.
+
+#define ENERGY_LOG_MAX_RECORD 512
+
+struct ENERGY_ROLLUP_HEADER_T {
+    uint32_t Magic;
+    uint16_t Format;
+    uint16_t Count;
+    uint32_t LastIndex;
+    uint32_t Crc;
+};
+
+struct ENERGY_ROLLUP_ENTRY_T {
+    uint64_t Serial;
+    uint32_t YieldTotal[ENERGY_MAX_CHANNELS];
+    EnergyLogClass::Rollup_t Days[ENERGY_ROLLUP_DAYS];
+    EnergyLogClass::Rollup_t Months[ENERGY_ROLLUP_MONTHS];
+};
+
+static void appendVarint(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    do {
+        uint8_t b = value & 0x7f;
+        value >>= 7;
+        if (value != 0) {
+            b |= 0x80;
+        }
+        buffer.push_back(b);
+    } while (value != 0);
+}
+
+static bool readVarint(const uint8_t* data, const size_t len, size_t& pos, uint32_t& value)
+{
+    value = 0;
+    for (uint8_t shift = 0; shift < 35 && pos < len; shift += 7) {
+        const uint8_t b = data[pos++];
+        value |= static_cast<uint32_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EnergyLogReader::open(const char* filename, const size_t maxSize)
+{
+    _file = LittleFS.open(filename, "r", false);
+    _remaining = _file ? std::min<size_t>(_file.size(), maxSize) : 0;
+    _data.clear();
+    _dataPos = 0;
+    _layout.clear();
+    _valueCount = 0;
+    _index = 0;
+    return static_cast<bool>(_file);
+}
+
+void EnergyLogReader::openBuffer(std::vector<uint8_t>&& data)
+{
+    _file.close();
+    _remaining = 0;
+    _data = std::move(data);
+    _dataPos = 0;
+}
+
+int EnergyLogReader::read()
+{
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+size_t EnergyLogReader::read(uint8_t* buffer, const size_t len)
+{
+    if (_file) {
+        const size_t n = _file.read(buffer, std::min(len, _remaining));
+        _remaining -= n;
+        return n;
+    }
+
+    const size_t n = std::min(len, _data.size() - _dataPos);
+    memcpy(buffer, _data.data() + _dataPos, n);
+    _dataPos += n;
+    return n;
+}
+
+bool EnergyLogReader::readVarint(uint32_t& value)
+{
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        const int b = read();
+        if (b < 0) {
+            return false;
+        }
+        value |= static_cast<uint32_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<EnergyLogInverter_t>& EnergyLogReader::getLayout() const
+{
+    return _layout;
+}
+
+bool EnergyLogReader::next(EnergyLogRecord_t& record)
+{
+    const int type = read();
+    if (type < 0) {
+        return false;
+    }
+
+    uint32_t len;
+    if (!readVarint(len) || len > ENERGY_LOG_MAX_RECORD) {
+        return false;
+    }
+
+    uint8_t payload[ENERGY_LOG_MAX_RECORD];
+    if (read(payload, len) != len) {
+        return false;
+    }
+
+    // The checksum covers type, length and payload
+    std::vector<uint8_t> header = { static_cast<uint8_t>(type) };
+    appendVarint(header, len);
+    const int crc = read();
+    if (crc < 0 || esp_rom_crc8_le(esp_rom_crc8_le(0, header.data(), header.size()), payload, len) != crc) {
+        return false;
+    }
+
+    size_t pos = 0;
+    uint32_t value;
+    record.Values.clear();
+
+    if (type == ENERGY_RECORD_CHECKPOINT) {
+        uint32_t count;
+        if (!readVarint(payload, len, pos, _index) || !readVarint(payload, len, pos, count)) {
+            return false;
+        }
+
+        _layout.clear();
+        for (uint32_t i = 0; i < count; i++) {
+            if (pos + sizeof(uint64_t) + 1 > len) {
+                return false;
+            }
+            EnergyLogInverter_t inv;
+            memcpy(&inv.Serial, &payload[pos], sizeof(uint64_t));
+            inv.Channels = std::min<uint8_t>(payload[pos + sizeof(uint64_t)], ENERGY_MAX_CHANNELS);
+            pos += sizeof(uint64_t) + 1;
+
+            for (uint8_t c = 0; c < inv.Channels; c++) {
+                if (!readVarint(payload, len, pos, value)) {
+                    return false;
+                }
+                record.Values.push_back(value);
+            }
+            _layout.push_back(inv);
+        }
+        _valueCount = record.Values.size();
+
+    } else if (type == ENERGY_RECORD_INTERVAL && !_layout.empty()) {
+        if (!readVarint(payload, len, pos, value)) {
+            return false;
+        }
+        _index += value;
+
+        for (size_t i = 0; i < _valueCount; i++) {
+            if (!readVarint(payload, len, pos, value)) {
+                return false;
+            }
+            record.Values.push_back(value);
+        }
+
+    } else {
+        return false;
+    }
+
+    record.Type = static_cast<EnergyLogRecordType>(type);
+    record.Index = _index;
+    return true;
+}
+
+EnergyLogClass::EnergyLogClass()
+    : _loopTask(10 * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("EnergyLog", std::bind(&EnergyLogClass::loop, this)))
+{
+}
+
+void EnergyLogClass::init(Scheduler& scheduler)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    readRollups();
+
+    // Apply everything which was logged after the last rollup write (e.g. power loss in between)
+    replayLog(ENERGY_LOG_OLD_FILENAME);
+    replayLog(ENERGY_LOG_FILENAME);
+
+    File f = LittleFS.open(ENERGY_LOG_FILENAME, "r", false);
+    if (f) {
+        _fileSize = f.size();
+    }
+
+    scheduler.addTask(_loopTask);
+    _loopTask.enable();
+}
+
+EnergyLogClass::InverterEnergy_t* EnergyLogClass::getInverter(const uint64_t serial)
+{
+    for (auto& inv : _inverters) {
+        if (inv.Serial == serial) {
+            return &inv;
+        }
+    }
+
+    InverterEnergy_t inv = {};
+    inv.Serial = serial;
+    _inverters.push_back(inv);
+    return &_inverters.back();
+}
+
+static void addRollup(EnergyLogClass::Rollup_t* rollups, const size_t count, const uint32_t key, const uint32_t energy)
+{
+    auto oldest = rollups;
+    for (size_t i = 0; i < count; i++) {
+        if (rollups[i].Key == key) {
+            rollups[i].Energy += energy;
+            return;
+        }
+        if (rollups[i].Key < oldest->Key) {
+            oldest = &rollups[i];
+        }
+    }
+
+    if (key > oldest->Key) {
+        *oldest = { key, energy };
+    }
+}
+
+void EnergyLogClass::addRollups(InverterEnergy_t& inv, const uint32_t index, const uint32_t energy)
+{
+    if (energy == 0) {
+        return;
+    }
+
+    const time_t t = static_cast<time_t>(index) * ENERGY_LOG_INTERVAL;
+    struct tm timeinfo;
+    localtime_r(&t, &timeinfo);
+
+    const uint32_t month = (timeinfo.tm_year + 1900) * 100 + timeinfo.tm_mon + 1;
+    addRollup(inv.Days, ENERGY_ROLLUP_DAYS, month * 100 + timeinfo.tm_mday, energy);
+    addRollup(inv.Months, ENERGY_ROLLUP_MONTHS, month, energy);
+}
+
+bool EnergyLogClass::readRollups()
+{
+    File f = LittleFS.open(ENERGY_ROLLUP_FILENAME, "r", false);
+    if (!f) {
+        return false;
+    }
+
+    ENERGY_ROLLUP_HEADER_T header;
+    if (f.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)
+        || header.Magic != ENERGY_ROLLUP_MAGIC
+        || header.Format != ENERGY_ROLLUP_FORMAT
+        || f.size() != sizeof(header) + header.Count * sizeof(ENERGY_ROLLUP_ENTRY_T)) {
+        MessageOutput.println("Invalid energy rollup file");
+        return false;
+    }
+
+    std::vector<ENERGY_ROLLUP_ENTRY_T> entries(header.Count);
+    const size_t size = entries.size() * sizeof(ENERGY_ROLLUP_ENTRY_T);
+    if (f.read(reinterpret_cast<uint8_t*>(entries.data()), size) != size
+        || esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(entries.data()), size) != header.Crc) {
+        MessageOutput.println("Checksum mismatch in energy rollup file");
+        return false;
+    }
+
+    for (const auto& entry : entries) {
+        auto inv = getInverter(entry.Serial);
+        memcpy(inv->YieldTotal, entry.YieldTotal, sizeof(inv->YieldTotal));
+        memcpy(inv->Days, entry.Days, sizeof(inv->Days));
+        memcpy(inv->Months, entry.Months, sizeof(inv->Months));
+    }
+    _lastRecordIndex = header.LastIndex;
+
+    return true;
+}
+
+bool EnergyLogClass::writeRollups()
+{
+    std::vector<ENERGY_ROLLUP_ENTRY_T> entries;
+    for (const auto& inv : _inverters) {
+        ENERGY_ROLLUP_ENTRY_T entry = {};
+        entry.Serial = inv.Serial;
+        // Energy of the open interval is not logged yet and must be counted again after a restart
+        for (uint8_t c = 0; c < ENERGY_MAX_CHANNELS; c++) {
+            entry.YieldTotal[c] = inv.YieldTotal[c] - inv.Pending[c];
+        }
+        memcpy(entry.Days, inv.Days, sizeof(entry.Days));
+        memcpy(entry.Months, inv.Months, sizeof(entry.Months));
+        entries.push_back(entry);
+    }
+
+    const size_t size = entries.size() * sizeof(ENERGY_ROLLUP_ENTRY_T);
+    ENERGY_ROLLUP_HEADER_T header = {};
+    header.Magic = ENERGY_ROLLUP_MAGIC;
+    header.Format = ENERGY_ROLLUP_FORMAT;
+    header.Count = entries.size();
+    header.LastIndex = _lastRecordIndex;
+    header.Crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(entries.data()), size);
+
+    const String tmpFilename = String(ENERGY_ROLLUP_FILENAME) + ".tmp";
+    File f = LittleFS.open(tmpFilename, "w");
+    if (!f) {
+        return false;
+    }
+    const bool success = f.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header)
+        && f.write(reinterpret_cast<const uint8_t*>(entries.data()), size) == size;
+    f.close();
+
+    if (!success) {
+        LittleFS.remove(tmpFilename);
+        return false;
+    }
+
+    return LittleFS.rename(tmpFilename, ENERGY_ROLLUP_FILENAME);
+}
+
+void EnergyLogClass::replayLog(const char* filename)
+{
+    EnergyLogReader reader;
+    if (!reader.open(filename)) {
+        return;
+    }
+
+    const uint32_t replayFrom = _lastRecordIndex;
+    EnergyLogRecord_t record;
+    while (reader.next(record)) {
+        if (record.Index <= replayFrom) {
+            continue;
+        }
+
+        size_t v = 0;
+        for (const auto& layoutInv : reader.getLayout()) {
+            auto inv = getInverter(layoutInv.Serial);
+            for (uint8_t c = 0; c < layoutInv.Channels; c++, v++) {
+                if (record.Type == ENERGY_RECORD_CHECKPOINT) {
+                    inv->YieldTotal[c] = record.Values[v];
+                } else {
+                    inv->YieldTotal[c] += record.Values[v];
+                    addRollups(*inv, record.Index, record.Values[v]);
+                }
+            }
+        }
+        _lastRecordIndex = record.Index;
+    }
+}
+
+void EnergyLogClass::encodeRecord(const EnergyLogRecordType type, const uint32_t indexValue, const std::vector<uint32_t>& values)
+{
+    std::vector<uint8_t> payload;
+    appendVarint(payload, indexValue);
+
+    if (type == ENERGY_RECORD_CHECKPOINT) {
+        appendVarint(payload, _layout.size());
+        size_t v = 0;
+        for (const auto& inv : _layout) {
+            const uint8_t* serial = reinterpret_cast<const uint8_t*>(&inv.Serial);
+            payload.insert(payload.end(), serial, serial + sizeof(inv.Serial));
+            payload.push_back(inv.Channels);
+            for (uint8_t c = 0; c < inv.Channels; c++) {
+                appendVarint(payload, values[v++]);
+            }
+        }
+    } else {
+        for (const auto value : values) {
+            appendVarint(payload, value);
+        }
+    }
+
+    const size_t start = _buffer.size();
+    _buffer.push_back(type);
+    appendVarint(_buffer, payload.size());
+    const uint8_t crc = esp_rom_crc8_le(0, &_buffer[start], _buffer.size() - start);
+    _buffer.insert(_buffer.end(), payload.begin(), payload.end());
+    _buffer.push_back(esp_rom_crc8_le(crc, payload.data(), payload.size()));
+}
+
+void EnergyLogClass::closeInterval()
+{
+    // Layout of all inverters which are currently configured
+    std::vector<EnergyLogInverter_t> layout;
+    for (const auto& inv : _inverters) {
+        if (Hoymiles.getInverterBySerial(inv.Serial) != nullptr && inv.Channels > 0) {
+            layout.push_back({ inv.Serial, inv.Channels });
+        }
+    }
+
+    std::vector<uint32_t> values;
+    uint32_t energy = 0;
+    for (const auto& layoutInv : layout) {
+        auto inv = getInverter(layoutInv.Serial);
+        for (uint8_t c = 0; c < layoutInv.Channels; c++) {
+            values.push_back(inv->Pending[c]);
+            energy += inv->Pending[c];
+        }
+    }
+
+    if (energy > 0) {
+        // Retried with the next interval if the rotation is not possible now
+        if (_fileSize + _buffer.size() > ENERGY_LOG_MAX_SIZE && _openSnapshots == 0) {
+            rotateLog();
+        }
+
+        if (_checkpointRequired || layout != _layout || _currentIndex - _lastCheckpointIndex >= ENERGY_LOG_CHECKPOINT_INTERVAL) {
+            _layout = layout;
+
+            std::vector<uint32_t> yieldTotals;
+            for (const auto& layoutInv : _layout) {
+                auto inv = getInverter(layoutInv.Serial);
+                for (uint8_t c = 0; c < layoutInv.Channels; c++) {
+                    yieldTotals.push_back(inv->YieldTotal[c] - inv->Pending[c]);
+                }
+            }
+            encodeRecord(ENERGY_RECORD_CHECKPOINT, _currentIndex, yieldTotals);
+            _lastRecordIndex = _currentIndex;
+            _lastCheckpointIndex = _currentIndex;
+            _checkpointRequired = false;
+        }
+
+        encodeRecord(ENERGY_RECORD_INTERVAL, _currentIndex - _lastRecordIndex, values);
+        _lastRecordIndex = _currentIndex;
+    }
+
+    for (auto& inv : _inverters) {
+        for (uint8_t c = 0; c < inv.Channels; c++) {
+            addRollups(inv, _currentIndex, inv.Pending[c]);
+            inv.Pending[c] = 0;
+        }
+    }
+}
+
+bool EnergyLogClass::rotateLog()
+{
+    // The old log must only contain records which precede the current one
+    writeBuffer();
+    if (!_buffer.empty()) {
+        return false;
+    }
+
+    if (LittleFS.exists(ENERGY_LOG_OLD_FILENAME) && !LittleFS.remove(ENERGY_LOG_OLD_FILENAME)) {
+        MessageOutput.println("Failed to remove old energy log");
+        return false;
+    }
+    if (!LittleFS.rename(ENERGY_LOG_FILENAME, ENERGY_LOG_OLD_FILENAME)) {
+        MessageOutput.println("Failed to rotate energy log");
+        return false;
+    }
+
+    _fileSize = 0;
+    _checkpointRequired = true;
+    return true;
+}
+
+void EnergyLogClass::writeBuffer()
+{
+    if (_buffer.empty()) {
+        return;
+    }
+
+    StallDetectorClass::Scope stallScope("EnergyLogWrite");
+
+    File f = LittleFS.open(ENERGY_LOG_FILENAME, "a");
+    if (!f) {
+        MessageOutput.println("Failed to open energy log");
+        return;
+    }
+    const size_t written = f.write(_buffer.data(), _buffer.size());
+    f.close();
+
+    if (written != _buffer.size()) {
+        MessageOutput.println("Failed to write energy log");
+        return;
+    }
+
+    _fileSize += written;
+    _buffer.clear();
+}
+
+void EnergyLogClass::flush()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    writeBuffer();
+    if (_buffer.empty()) {
+        writeRollups();
+    }
+    _lastFlush = millis();
+}
+
+void EnergyLogClass::openSnapshot(EnergyLogReader& oldLog, EnergyLogReader& log, std::vector<uint8_t>& pending)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    oldLog.open(ENERGY_LOG_OLD_FILENAME);
+    log.open(ENERGY_LOG_FILENAME, _fileSize);
+    pending = _buffer;
+    _openSnapshots++;
+}
+
+void EnergyLogClass::closeSnapshot()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_openSnapshots > 0) {
+        _openSnapshots--;
+    }
+}
+
+void EnergyLogClass::loop()
+{
+    struct tm timeinfo;
+    if (!getLocalTime(&timeinfo, 5)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const uint32_t index = time(nullptr) / ENERGY_LOG_INTERVAL;
+        if (_currentIndex == 0) {
+            _currentIndex = index;
+        }
+        if (index != _currentIndex) {
+            closeInterval();
+            _currentIndex = index;
+        }
+
+        for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+            auto inv = Hoymiles.getInverterByPos(i);
+            if (inv == nullptr) {
+                continue;
+            }
+
+            auto stats = inv->Statistics();
+            if (stats->getLastUpdate() == 0 || stats->isStale()) {
+                continue;
+            }
+
+            auto energy = getInverter(inv->serial());
+            if (energy->LastUpdate == stats->getLastUpdate()) {
+                continue;
+            }
+            energy->LastUpdate = stats->getLastUpdate();
+
+            for (auto& c : stats->getChannelsByType(TYPE_DC)) {
+                const uint8_t ch = static_cast<uint8_t>(c);
+                if (ch >= ENERGY_MAX_CHANNELS) {
+                    continue;
+                }
+                energy->Channels = std::max<uint8_t>(energy->Channels, ch + 1);
+
+                const uint32_t yieldTotal = stats->getChannelFieldValue(TYPE_DC, c, FLD_YT) * 1000 + 0.5f;
+                if (yieldTotal == 0) {
+                    // Inverter reports no counters (e.g. right after it started)
+                    continue;
+                }
+                if (energy->YieldTotal[ch] > 0 && yieldTotal >= energy->YieldTotal[ch]) {
+                    energy->Pending[ch] += yieldTotal - energy->YieldTotal[ch];
+                }
+                // The first value or a counter reset only sets the baseline
+                energy->YieldTotal[ch] = yieldTotal;
+            }
+        }
+    }
+
+    if (millis() - _lastFlush >= ENERGY_LOG_FLUSH_INTERVAL * 1000 || _buffer.size() >= ENERGY_LOG_MAX_PENDING) {
+        flush();
+    }
+}
+
+bool EnergyLogClass::getRollups(const uint64_t serial, const std::function<void(const Rollup_t&, bool monthly)>& onRollup)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = std::find_if(_inverters.begin(), _inverters.end(),
+        [serial](const InverterEnergy_t& inv) { return inv.Serial == serial; });
+    if (it == _inverters.end()) {
+        return false;
+    }
+
+    auto visit = [&onRollup](const Rollup_t* rollups, const size_t count, const bool monthly) {
+        std::vector<Rollup_t> sorted(rollups, rollups + count);
+        std::sort(sorted.begin(), sorted.end(), [](const Rollup_t& a, const Rollup_t& b) { return a.Key < b.Key; });
+        for (const auto& rollup : sorted) {
+            if (rollup.Key != 0) {
+                onRollup(rollup, monthly);
+            }
+        }
+    };
+    visit(it->Days, ENERGY_ROLLUP_DAYS, false);
+    visit(it->Months, ENERGY_ROLLUP_MONTHS, true);
+
+    return true;
+}
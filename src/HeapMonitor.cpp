@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HeapMonitor.h"
+#include "TaskProfiler.h"
+#include <Esp.h>
+#include <algorithm>
+
+HeapMonitorClass HeapMonitor;
+
+HeapMonitorClass::HeapMonitorClass()
+    : _loopTask(HEAP_MONITOR_INTERVAL * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("HeapMonitor", std::bind(&HeapMonitorClass::loop, this)))
+{
+}
+
+void HeapMonitorClass::init(Scheduler& scheduler)
+{
+    scheduler.addTask(_loopTask);
+    _loopTask.enable();
+}
+
+void HeapMonitorClass::loop()
+{
+    const uint32_t freeHeap = ESP.getFreeHeap();
+    const uint32_t maxBlock = ESP.getMaxAllocHeap();
+    _fragmentation = freeHeap > 0 ? 100 - std::min<uint32_t>(maxBlock, freeHeap) * 100 / freeHeap : 0;
+    _fragmentationMax = std::max(_fragmentationMax, _fragmentation);
+
+    for (uint8_t tag = 0; tag < HEAP_TAG_COUNT; tag++) {
+        const uint32_t allocations = HeapAccounting.getStats(static_cast<HeapTag_t>(tag)).Allocations;
+        if (!_loopTask.isFirstIteration()) {
+            _allocationRate[tag] = static_cast<float>(allocations - _lastAllocations[tag]) / HEAP_MONITOR_INTERVAL;
+        }
+        _lastAllocations[tag] = allocations;
+    }
+}
+
+uint8_t HeapMonitorClass::getFragmentation() const
+{
+    return _fragmentation;
+}
+
+uint8_t HeapMonitorClass::getFragmentationMax() const
+{
+    return _fragmentationMax;
+}
+
+float HeapMonitorClass::getAllocationRate(const HeapTag_t tag) const
+{
+    return _allocationRate[tag];
+}
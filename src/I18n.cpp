@@ -7,6 +7,7 @@
 #include "Utils.h"
 #include "defaults.h"
 #include <ArduinoJson.h>
+#include <HeapTaggedJsonAllocator.h>
 #include <LittleFS.h>
 
 I18nClass I18n;
@@ -51,12 +52,12 @@ void I18nClass::readDisplayStrings(
         return;
     }
 
-    JsonDocument filter;
+    JsonDocument filter(HeapTaggedJsonAllocator::get(HEAP_TAG_JSON));
     filter["display"] = true;
 
     File f = LittleFS.open(filename, "r", false);
 
-    JsonDocument doc;
+    JsonDocument doc(HeapTaggedJsonAllocator::get(HEAP_TAG_JSON));
 
     // Deserialize the JSON document
     const DeserializationError error = deserializeJson(doc, f, DeserializationOption::Filter(filter));
@@ -124,12 +125,12 @@ void I18nClass::readLangPacks()
 
 void I18nClass::readConfig(String file)
 {
-    JsonDocument filter;
+    JsonDocument filter(HeapTaggedJsonAllocator::get(HEAP_TAG_JSON));
     filter["meta"] = true;
 
     File f = LittleFS.open(file, "r", false);
 
-    JsonDocument doc;
+    JsonDocument doc(HeapTaggedJsonAllocator::get(HEAP_TAG_JSON));
 
     // Deserialize the JSON document
     const DeserializationError error = deserializeJson(doc, f, DeserializationOption::Filter(filter));
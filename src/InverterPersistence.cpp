@@ -0,0 +1,349 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "InverterPersistence.h"
+#include "MessageOutput.h"
+#include "TaskProfiler.h"
+#include <Hoymiles.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include <esp_rom_crc.h>
+
+InverterPersistenceClass InverterPersistence;
+
+enum PersistenceRecordId : uint16_t {
+    RECORD_DEV_INFO_ALL = 1,
+    RECORD_DEV_INFO_SIMPLE = 2,
+    RECORD_GRID_PROFILE = 3,
+    RECORD_LIMIT = 4,
+    RECORD_STATISTICS = 5,
+};
+
+struct PERSISTENCE_HEADER_T {
+    uint32_t Magic;
+    uint16_t Format;
+    uint16_t Length;
+    uint64_t Serial;
+    int64_t Timestamp; // Epoch of the snapshot, 0 if time was not synced
+    uint32_t Crc;
+};
+
+struct PERSISTENCE_RECORD_HEADER_T {
+    uint16_t Id;
+    uint16_t Length;
+};
+
+static void appendRecord(std::vector<uint8_t>& buffer, const uint16_t id, const std::vector<uint8_t>& data)
+{
+    if (data.empty()) {
+        return;
+    }
+
+    const PERSISTENCE_RECORD_HEADER_T recordHeader = { id, static_cast<uint16_t>(data.size()) };
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&recordHeader);
+    buffer.insert(buffer.end(), p, p + sizeof(recordHeader));
+    buffer.insert(buffer.end(), data.begin(), data.end());
+}
+
+static std::vector<uint8_t> getLimitData(InverterAbstract* inv)
+{
+    if (inv->SystemConfigPara()->getLastUpdate() == 0) {
+        return {};
+    }
+
+    const uint16_t limit = inv->SystemConfigPara()->getLimitPercent() * 10;
+    return { static_cast<uint8_t>(limit >> 8), static_cast<uint8_t>(limit) };
+}
+
+// Checksum over all data which rarely changes. Used to detect if a new snapshot has to be written.
+static uint32_t getMetadataCrc(InverterAbstract* inv)
+{
+    std::vector<uint8_t> buffer;
+    appendRecord(buffer, RECORD_DEV_INFO_ALL, inv->DevInfo()->getRawDataAll());
+    appendRecord(buffer, RECORD_DEV_INFO_SIMPLE, inv->DevInfo()->getRawDataSimple());
+    appendRecord(buffer, RECORD_GRID_PROFILE, inv->GridProfile()->getRawData());
+    appendRecord(buffer, RECORD_LIMIT, getLimitData(inv));
+    return esp_rom_crc32_le(0, buffer.data(), buffer.size());
+}
+
+static bool isSameLocalDay(const time_t timestamp)
+{
+    struct tm now;
+    if (timestamp == 0 || !getLocalTime(&now, 5)) {
+        return false;
+    }
+
+    struct tm snapshot;
+    localtime_r(&timestamp, &snapshot);
+    return snapshot.tm_year == now.tm_year && snapshot.tm_yday == now.tm_yday;
+}
+
+InverterPersistenceClass::InverterPersistenceClass()
+    : _loopTask(INVERTER_PERSISTENCE_INTERVAL, TASK_FOREVER, TaskProfiler.wrap("InverterPersistence", std::bind(&InverterPersistenceClass::loop, this)))
+{
+}
+
+void InverterPersistenceClass::init(Scheduler& scheduler)
+{
+    scheduler.addTask(_loopTask);
+    _loopTask.enable();
+}
+
+String InverterPersistenceClass::getFilename(const uint64_t serial)
+{
+    char filename[32];
+    snprintf(filename, sizeof(filename), "/inv_%0" PRIx32 "%08" PRIx32 ".bin",
+        static_cast<uint32_t>((serial >> 32) & 0xFFFFFFFF),
+        static_cast<uint32_t>(serial & 0xFFFFFFFF));
+    return filename;
+}
+
+InverterPersistenceClass::InverterState_t* InverterPersistenceClass::getState(const uint64_t serial)
+{
+    for (auto& state : _states) {
+        if (state.Serial == serial) {
+            return &state;
+        }
+    }
+
+    _states.push_back({ serial, 0, 0, 0, false });
+    return &_states.back();
+}
+
+void InverterPersistenceClass::restoreAll()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+        if (inv == nullptr) {
+            continue;
+        }
+
+        auto state = getState(inv->serial());
+        if (restore(inv.get(), false)) {
+            MessageOutput.printf("Restored inverter data of %s\r\n", inv->name());
+
+            // Statistics depend on the current day which is not known before the time is synced
+            state->StatisticsRestorePending = true;
+        }
+        state->MetadataCrc = getMetadataCrc(inv.get());
+    }
+}
+
+bool InverterPersistenceClass::restore(InverterAbstract* inv, const bool restoreStatistics)
+{
+    File f = LittleFS.open(getFilename(inv->serial()), "r", false);
+    if (!f) {
+        return false;
+    }
+
+    PERSISTENCE_HEADER_T header;
+    if (f.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)
+        || header.Magic != INVERTER_PERSISTENCE_MAGIC
+        || header.Format != INVERTER_PERSISTENCE_FORMAT
+        || header.Serial != inv->serial()
+        || header.Length != f.size() - sizeof(header)) {
+        return false;
+    }
+
+    std::vector<uint8_t> payload(header.Length);
+    if (f.read(payload.data(), payload.size()) != payload.size()
+        || esp_rom_crc32_le(0, payload.data(), payload.size()) != header.Crc) {
+        MessageOutput.printf("Checksum mismatch in %s\r\n", f.name());
+        return false;
+    }
+    f.close();
+
+    if (restoreStatistics && !isSameLocalDay(header.Timestamp)) {
+        return false;
+    }
+
+    bool restored = false;
+    size_t pos = 0;
+    while (pos + sizeof(PERSISTENCE_RECORD_HEADER_T) <= payload.size()) {
+        PERSISTENCE_RECORD_HEADER_T recordHeader;
+        memcpy(&recordHeader, &payload[pos], sizeof(recordHeader));
+        pos += sizeof(recordHeader);
+
+        if (pos + recordHeader.Length > payload.size() || recordHeader.Length > UINT8_MAX) {
+            break;
+        }
+        const uint8_t* data = &payload[pos];
+        const uint8_t len = recordHeader.Length;
+        pos += recordHeader.Length;
+
+        if (restoreStatistics != (recordHeader.Id == RECORD_STATISTICS)) {
+            continue;
+        }
+
+        switch (recordHeader.Id) {
+        case RECORD_DEV_INFO_ALL:
+            inv->DevInfo()->beginAppendFragment();
+            inv->DevInfo()->clearBufferAll();
+            inv->DevInfo()->appendFragmentAll(0, data, len);
+            inv->DevInfo()->endAppendFragment();
+            inv->DevInfo()->setLastUpdateAll(1);
+            inv->DevInfo()->setStale(true);
+            break;
+        case RECORD_DEV_INFO_SIMPLE:
+            inv->DevInfo()->beginAppendFragment();
+            inv->DevInfo()->clearBufferSimple();
+            inv->DevInfo()->appendFragmentSimple(0, data, len);
+            inv->DevInfo()->endAppendFragment();
+            inv->DevInfo()->setLastUpdateSimple(1);
+            inv->DevInfo()->setStale(true);
+            break;
+        case RECORD_GRID_PROFILE:
+            inv->GridProfile()->beginAppendFragment();
+            inv->GridProfile()->clearBuffer();
+            inv->GridProfile()->appendFragment(0, data, len);
+            inv->GridProfile()->endAppendFragment();
+            inv->GridProfile()->setLastUpdate(1);
+            inv->GridProfile()->setStale(true);
+            break;
+        case RECORD_LIMIT:
+            if (len != 2) {
+                continue;
+            }
+            inv->SystemConfigPara()->setLimitPercent(static_cast<float>((data[0] << 8) | data[1]) / 10);
+            inv->SystemConfigPara()->setLastUpdate(1);
+            inv->SystemConfigPara()->setStale(true);
+            break;
+        case RECORD_STATISTICS:
+            if (len < inv->Statistics()->getExpectedByteCount()) {
+                continue;
+            }
+            inv->Statistics()->beginAppendFragment();
+            inv->Statistics()->clearBuffer();
+            inv->Statistics()->appendFragment(0, data, len);
+            inv->Statistics()->endAppendFragment();
+
+            // Only the energy counters are still meaningful, runtime values would pretend production
+            inv->Statistics()->zeroRuntimeData();
+            inv->Statistics()->setLastUpdate(1);
+            inv->Statistics()->setStale(true);
+            break;
+        default:
+            continue;
+        }
+        restored = true;
+    }
+
+    return restored;
+}
+
+bool InverterPersistenceClass::save(InverterAbstract* inv, const bool saveStatistics)
+{
+    std::vector<uint8_t> payload;
+    appendRecord(payload, RECORD_DEV_INFO_ALL, inv->DevInfo()->getRawDataAll());
+    appendRecord(payload, RECORD_DEV_INFO_SIMPLE, inv->DevInfo()->getRawDataSimple());
+    appendRecord(payload, RECORD_GRID_PROFILE, inv->GridProfile()->getRawData());
+    appendRecord(payload, RECORD_LIMIT, getLimitData(inv));
+    if (saveStatistics) {
+        appendRecord(payload, RECORD_STATISTICS, inv->Statistics()->getRawData());
+    }
+
+    if (payload.empty()) {
+        return true;
+    }
+
+    struct tm timeinfo;
+    PERSISTENCE_HEADER_T header = {};
+    header.Magic = INVERTER_PERSISTENCE_MAGIC;
+    header.Format = INVERTER_PERSISTENCE_FORMAT;
+    header.Length = payload.size();
+    header.Serial = inv->serial();
+    header.Timestamp = getLocalTime(&timeinfo, 5) ? time(nullptr) : 0;
+    header.Crc = esp_rom_crc32_le(0, payload.data(), payload.size());
+
+    const String filename = getFilename(inv->serial());
+    const String tmpFilename = filename + ".tmp";
+
+    File f = LittleFS.open(tmpFilename, "w");
+    if (!f) {
+        return false;
+    }
+    const bool success = f.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header)
+        && f.write(payload.data(), payload.size()) == payload.size();
+    f.close();
+
+    if (!success) {
+        LittleFS.remove(tmpFilename);
+        return false;
+    }
+
+    return LittleFS.rename(tmpFilename, filename);
+}
+
+void InverterPersistenceClass::process(const bool force)
+{
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+        if (inv == nullptr) {
+            continue;
+        }
+
+        auto state = getState(inv->serial());
+
+        struct tm timeinfo;
+        if (state->StatisticsRestorePending) {
+            if (inv->Statistics()->getLastUpdate() > 0) {
+                // Inverter answered before the time was synced, nothing to restore anymore
+                state->StatisticsRestorePending = false;
+            } else if (getLocalTime(&timeinfo, 5)) {
+                state->StatisticsRestorePending = false;
+                restore(inv.get(), true);
+            }
+        }
+
+        // Snapshots of restored statistics would get the timestamp of today
+        const uint32_t statisticsUpdate = inv->Statistics()->isStale() ? 0 : inv->Statistics()->getLastUpdate();
+        const bool statisticsChanged = statisticsUpdate > 0 && statisticsUpdate != state->StatisticsUpdate;
+        const bool statisticsDue = statisticsChanged
+            && (force || state->StatisticsSaved == 0 || millis() / 1000 - state->StatisticsSaved >= INVERTER_PERSISTENCE_STATS_INTERVAL);
+
+        const uint32_t metadataCrc = getMetadataCrc(inv.get());
+        if (metadataCrc == state->MetadataCrc && !statisticsDue) {
+            continue;
+        }
+
+        if (!save(inv.get(), statisticsUpdate > 0)) {
+            MessageOutput.printf("Failed to save inverter data of %s\r\n", inv->name());
+            continue;
+        }
+
+        state->MetadataCrc = metadataCrc;
+        if (statisticsUpdate > 0) {
+            state->StatisticsUpdate = statisticsUpdate;
+            state->StatisticsSaved = millis() / 1000;
+        }
+    }
+}
+
+void InverterPersistenceClass::loop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    process(false);
+}
+
+void InverterPersistenceClass::flush()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    process(true);
+}
+
+void InverterPersistenceClass::remove(const uint64_t serial)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const String filename = getFilename(serial);
+    if (LittleFS.exists(filename)) {
+        LittleFS.remove(filename);
+    }
+
+    _states.erase(std::remove_if(_states.begin(), _states.end(),
+                      [serial](const InverterState_t& state) { return state.Serial == serial; }),
+        _states.end());
+}
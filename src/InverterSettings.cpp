@@ -4,17 +4,18 @@
  */
 #include "InverterSettings.h"
 #include "Configuration.h"
+#include "InverterPersistence.h"
 #include "MessageOutput.h"
 #include "PinMapping.h"
 #include "SunPosition.h"
+#include "TaskProfiler.h"
 #include <Hoymiles.h>
 #include <SpiManager.h>
 
 InverterSettingsClass InverterSettings;
 
 InverterSettingsClass::InverterSettingsClass()
-    : _settingsTask(INVERTER_UPDATE_SETTINGS_INTERVAL, TASK_FOREVER, std::bind(&InverterSettingsClass::settingsLoop, this))
-    , _hoyTask(TASK_IMMEDIATE, TASK_FOREVER, std::bind(&InverterSettingsClass::hoyLoop, this))
+    : _settingsTask(INVERTER_UPDATE_SETTINGS_INTERVAL, TASK_FOREVER, TaskProfiler.wrap("InverterSettings", std::bind(&InverterSettingsClass::settingsLoop, this)))
 {
 }
 
@@ -83,12 +84,18 @@ void InverterSettingsClass::init(Scheduler& scheduler)
             }
         }
         MessageOutput.println("done");
+
+        // Serve the last known data until the inverters answered again
+        InverterPersistence.restoreAll();
     } else {
         MessageOutput.println("Invalid pin config");
     }
 
-    scheduler.addTask(_hoyTask);
-    _hoyTask.enable();
+    // The RF communication runs in its own task to be independent of the
+    // timing of all other tasks running in the scheduler
+    xTaskCreatePinnedToCore(hoyTask, HOY_TASK_NAME, HOY_TASK_STACK_SIZE, nullptr,
+        HOY_TASK_PRIORITY, &_hoyTaskHandle, ARDUINO_RUNNING_CORE);
+    Hoymiles.setLoopTask(_hoyTaskHandle);
 
     scheduler.addTask(_settingsTask);
     _settingsTask.enable();
@@ -114,7 +121,13 @@ void InverterSettingsClass::settingsLoop()
     }
 }
 
-void InverterSettingsClass::hoyLoop()
+void InverterSettingsClass::hoyTask(void* parameter)
 {
-    Hoymiles.loop();
+    for (;;) {
+        Hoymiles.loop();
+
+        // Sleep until the next radio interrupt. Wake up regularly anyway to
+        // handle RX channel hopping, timeouts and newly enqueued commands.
+        ulTaskNotifyTake(pdTRUE, Hoymiles.isAllRadioIdle() ? pdMS_TO_TICKS(HOY_TASK_IDLE_WAIT) : 1);
+    }
 }
@@ -8,6 +8,7 @@
 #include "MqttSettings.h"
 #include "NetworkSettings.h"
 #include "PinMapping.h"
+#include "TaskProfiler.h"
 #include <Hoymiles.h>
 
 LedSingleClass LedSingle;
@@ -38,8 +39,8 @@ const uint8_t pwmTable[] = {
 #define LED_OFF 0
 
 LedSingleClass::LedSingleClass()
-    : _setTask(LEDSINGLE_UPDATE_INTERVAL * TASK_MILLISECOND, TASK_FOREVER, std::bind(&LedSingleClass::setLoop, this))
-    , _outputTask(TASK_IMMEDIATE, TASK_FOREVER, std::bind(&LedSingleClass::outputLoop, this))
+    : _setTask(LEDSINGLE_UPDATE_INTERVAL * TASK_MILLISECOND, TASK_FOREVER, TaskProfiler.wrap("LedSet", std::bind(&LedSingleClass::setLoop, this)))
+    , _outputTask(TASK_IMMEDIATE, TASK_FOREVER, TaskProfiler.wrap("LedOutput", std::bind(&LedSingleClass::outputLoop, this)))
 {
 }
 
@@ -13,6 +13,7 @@
 #include "ModbusDtu.h"
 #include "ModbusSettings.h"
 #include "NetworkSettings.h"
+#include "StallDetector.h"
 #include "__compiled_constants.h"
 
 // eModbus
@@ -21,6 +22,8 @@
 // OpenDTU single phase (AN or AB) meter
 // - FC 0x03 requests (read holding registers)
 ModbusMessage OpenDTUMeter(ModbusMessage request) {
+    StallDetectorClass::Scope stallScope("ModbusMeter", STALL_CONTEXT_MODBUS);
+
     uint16_t addr = 0;          // Start address
     uint16_t words = 0;         // # of words requested
 
@@ -12,6 +12,7 @@
 #include "MessageOutput.h"
 #include "ModbusDtu.h"
 #include "ModbusSettings.h"
+#include "StallDetector.h"
 
 // eModbus
 #include "Logging.h"
@@ -44,6 +45,8 @@ typedef struct {
 // 3-Gen DTU-Pro
 // - FC 0x03 requests (read holding registers)
 ModbusMessage DTUPro(ModbusMessage request) {
+    StallDetectorClass::Scope stallScope("ModbusDtuPro", STALL_CONTEXT_MODBUS);
+
     uint16_t addr = 0;          // Start address
     uint16_t words = 0;         // # of words requested
 
@@ -266,7 +269,8 @@ ModbusMessage DTUPro(ModbusMessage request) {
                         uint8_t entry_count = channels[chan_idx].inv->EventLog()->getEntryCount();
                         if (entry_count > 0) {
                             AlarmLogEntry_t entry;
-                            channels[chan_idx].inv->EventLog()->getLogEntry(entry_count - 1, entry);
+                            // Only the message id is used, no timezone offset required
+                            channels[chan_idx].inv->EventLog()->getLogEntry(entry_count - 1, entry, 0);
                             val = entry.MessageId;
                         } else {
                             val = 0;
@@ -6,14 +6,16 @@
 #include "MqttHandleInverter.h"
 #include "MqttSettings.h"
 #include "NetworkSettings.h"
+#include "TaskProfiler.h"
 #include "Utils.h"
 #include "__compiled_constants.h"
 #include "defaults.h"
+#include <HeapTaggedJsonAllocator.h>
 
 MqttHandleHassClass MqttHandleHass;
 
 MqttHandleHassClass::MqttHandleHassClass()
-    : _loopTask(TASK_IMMEDIATE, TASK_FOREVER, std::bind(&MqttHandleHassClass::loop, this))
+    : _loopTask(TASK_IMMEDIATE, TASK_FOREVER, TaskProfiler.wrap("MqttHass", std::bind(&MqttHandleHassClass::loop, this)))
 {
 }
 
@@ -153,7 +155,7 @@ void MqttHandleHassClass::publishInverterField(std::shared_ptr<InverterAbstract>
 
         String unit_of_measure = inv->Statistics()->getChannelFieldUnit(type, channel, fieldType.fieldId);
 
-        JsonDocument root;
+        JsonDocument root(HeapTaggedJsonAllocator::get(HEAP_TAG_MQTT));
         createInverterInfo(root, inv);
         addCommonMetadata(root, unit_of_measure, "", fieldType.deviceClsId, fieldType.stateClsId, CATEGORY_NONE);
 
@@ -188,7 +190,7 @@ void MqttHandleHassClass::publishInverterButton(
 
     const String cmdTopic = MqttSettings.getPrefix() + serial + "/" + state_topic;
 
-    JsonDocument root;
+    JsonDocument root(HeapTaggedJsonAllocator::get(HEAP_TAG_MQTT));
     createInverterInfo(root, inv);
     addCommonMetadata(root, "", icon, device_class, state_class, category);
 
@@ -220,7 +222,7 @@ void MqttHandleHassClass::publishInverterNumber(
     const String cmdTopic = MqttSettings.getPrefix() + serial + "/" + command_topic;
     const String statTopic = MqttSettings.getPrefix() + serial + "/" + stateTopic;
 
-    JsonDocument root;
+    JsonDocument root(HeapTaggedJsonAllocator::get(HEAP_TAG_MQTT));
     createInverterInfo(root, inv);
     addCommonMetadata(root, unit_of_measure, icon, DEVICE_CLS_NONE, state_class, category);
 
@@ -357,7 +359,7 @@ void MqttHandleHassClass::publishDtuBinarySensor(
 {
     const String dtuId = getDtuUniqueId();
 
-    JsonDocument root;
+    JsonDocument root(HeapTaggedJsonAllocator::get(HEAP_TAG_MQTT));
     createDtuInfo(root);
     publishBinarySensor(root, dtuId, dtuId, name, state_topic, payload_on, payload_off, device_class, state_class, category);
 }
@@ -368,7 +370,7 @@ void MqttHandleHassClass::publishInverterBinarySensor(
 {
     const String serial = inv->serialString();
 
-    JsonDocument root;
+    JsonDocument root(HeapTaggedJsonAllocator::get(HEAP_TAG_MQTT));
     createInverterInfo(root, inv);
     publishBinarySensor(root, "dtu_" + serial, serial, name, serial + "/" + state_topic, payload_on, payload_off, device_class, state_class, category);
 }
@@ -405,7 +407,7 @@ void MqttHandleHassClass::publishDtuSensor(
 {
     const String dtuId = getDtuUniqueId();
 
-    JsonDocument root;
+    JsonDocument root(HeapTaggedJsonAllocator::get(HEAP_TAG_MQTT));
     createDtuInfo(root);
     publishSensor(root, dtuId, dtuId, name, state_topic, unit_of_measure, icon, device_class, state_class, category);
 }
@@ -417,7 +419,7 @@ void MqttHandleHassClass::publishInverterSensor(
 {
     const String serial = inv->serialString();
 
-    JsonDocument root;
+    JsonDocument root(HeapTaggedJsonAllocator::get(HEAP_TAG_MQTT));
     createInverterInfo(root, inv);
     publishSensor(root, "dtu_" + serial, serial, name, serial + "/" + state_topic, unit_of_measure, icon, device_class, state_class, category);
 }
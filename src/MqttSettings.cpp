@@ -116,11 +116,15 @@ void MqttSettingsClass::performConnect()
         const String willTopic = getPrefix() + config.Mqtt.Lwt.Topic;
         String clientId = getClientId();
         if (config.Mqtt.Tls.Enabled) {
-            static_cast<espMqttClientSecure*>(_mqttClient)->setCACert(config.Mqtt.Tls.RootCaCert);
+            // The client only keeps pointers, so the certificates have to outlive the connection
+            _tlsRootCaCert = Configuration.readBlob(ConfigBlob::MqttRootCaCert);
+            static_cast<espMqttClientSecure*>(_mqttClient)->setCACert(_tlsRootCaCert.c_str());
             static_cast<espMqttClientSecure*>(_mqttClient)->setServer(config.Mqtt.Hostname, config.Mqtt.Port);
             if (config.Mqtt.Tls.CertLogin) {
-                static_cast<espMqttClientSecure*>(_mqttClient)->setCertificate(config.Mqtt.Tls.ClientCert);
-                static_cast<espMqttClientSecure*>(_mqttClient)->setPrivateKey(config.Mqtt.Tls.ClientKey);
+                _tlsClientCert = Configuration.readBlob(ConfigBlob::MqttClientCert);
+                _tlsClientKey = Configuration.readBlob(ConfigBlob::MqttClientKey);
+                static_cast<espMqttClientSecure*>(_mqttClient)->setCertificate(_tlsClientCert.c_str());
+                static_cast<espMqttClientSecure*>(_mqttClient)->setPrivateKey(_tlsClientKey.c_str());
             } else {
                 static_cast<espMqttClientSecure*>(_mqttClient)->setCredentials(config.Mqtt.Username, config.Mqtt.Password);
             }
@@ -223,6 +227,10 @@ void MqttSettingsClass::createMqttClientObject()
         delete _mqttClient;
         _mqttClient = nullptr;
     }
+    _tlsRootCaCert = String();
+    _tlsClientCert = String();
+    _tlsClientKey = String();
+
     const CONFIG_T& config = Configuration.get();
     if (config.Mqtt.Tls.Enabled) {
         _mqttClient = static_cast<MqttClient*>(new espMqttClientSecure);
@@ -6,6 +6,7 @@
 #include "Configuration.h"
 #include "MessageOutput.h"
 #include "PinMapping.h"
+#include "TaskProfiler.h"
 #include "Utils.h"
 #include "__compiled_constants.h"
 #include "defaults.h"
@@ -13,7 +14,7 @@
 #include <ETH.h>
 
 NetworkSettingsClass::NetworkSettingsClass()
-    : _loopTask(TASK_IMMEDIATE, TASK_FOREVER, std::bind(&NetworkSettingsClass::loop, this))
+    : _loopTask(TASK_IMMEDIATE, TASK_FOREVER, TaskProfiler.wrap("Network", std::bind(&NetworkSettingsClass::loop, this)))
     , _apIp(192, 168, 4, 1)
     , _apNetmask(255, 255, 255, 0)
 {
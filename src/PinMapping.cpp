@@ -6,6 +6,7 @@
 #include "MessageOutput.h"
 #include "Utils.h"
 #include <ArduinoJson.h>
+#include <HeapTaggedJsonAllocator.h>
 #include <LittleFS.h>
 #include <string.h>
 
@@ -202,7 +203,7 @@ bool PinMappingClass::init(const String& deviceMapping)
 
     Utils::skipBom(f);
 
-    JsonDocument doc;
+    JsonDocument doc(HeapTaggedJsonAllocator::get(HEAP_TAG_CONFIG));
     // Deserialize the JSON document
     DeserializationError error = deserializeJson(doc, f);
     if (error) {
@@ -3,14 +3,18 @@
  * Copyright (C) 2024 Thomas Basler and others
  */
 #include "RestartHelper.h"
+#include "Configuration.h"
 #include "Display_Graphic.h"
+#include "EnergyLog.h"
+#include "InverterPersistence.h"
 #include "Led_Single.h"
+#include "TaskProfiler.h"
 #include <Esp.h>
 
 RestartHelperClass RestartHelper;
 
 RestartHelperClass::RestartHelperClass()
-    : _rebootTask(1 * TASK_SECOND, TASK_FOREVER, std::bind(&RestartHelperClass::loop, this))
+    : _rebootTask(1 * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("RestartHelper", std::bind(&RestartHelperClass::loop, this)))
 {
 }
 
@@ -31,6 +35,9 @@ void RestartHelperClass::loop()
         LedSingle.turnAllOff();
         Display.setStatus(false);
     } else {
+        Configuration.flush();
+        InverterPersistence.flush();
+        EnergyLog.flush();
         ESP.restart();
     }
 }
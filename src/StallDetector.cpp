@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "StallDetector.h"
+#include "MessageOutput.h"
+#include <algorithm>
+#include <cstring>
+#include <esp_attr.h>
+#include <esp_system.h>
+
+#define STALL_STORAGE_MAGIC 0x4c415453 // "STAL"
+
+struct StallStorage_t {
+    uint32_t Magic;
+    uint32_t BootCount;
+    uint32_t Head; // Index of the next record to write
+    uint32_t Count;
+    StallRecord_t Records[STALL_RECORD_COUNT];
+};
+
+// Not initialized on startup to keep the records of the previous boot
+static RTC_NOINIT_ATTR StallStorage_t stallStorage;
+
+StallDetectorClass StallDetector;
+
+void StallDetectorClass::init()
+{
+    if (esp_reset_reason() == ESP_RST_POWERON
+        || stallStorage.Magic != STALL_STORAGE_MAGIC
+        || stallStorage.Head >= STALL_RECORD_COUNT
+        || stallStorage.Count > STALL_RECORD_COUNT) {
+
+        memset(&stallStorage, 0, sizeof(stallStorage));
+        stallStorage.Magic = STALL_STORAGE_MAGIC;
+    }
+    stallStorage.BootCount++;
+
+    _loopTask = xTaskGetCurrentTaskHandle();
+    _iterationStart = esp_timer_get_time();
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &StallDetectorClass::checkCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "stall";
+
+    if (esp_timer_create(&timerArgs, &_timer) != ESP_OK
+        || esp_timer_start_periodic(_timer, STALL_CHECK_INTERVAL_MS * 1000) != ESP_OK) {
+        MessageOutput.println("Failed to start stall detector");
+    }
+}
+
+void StallDetectorClass::beginIteration()
+{
+    const int64_t now = esp_timer_get_time();
+    _iterationStart.store(now, std::memory_order_relaxed);
+
+    if (_activeRecord.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+
+    StallRecord_t record;
+    portENTER_CRITICAL(&_lock);
+    StallRecord_t* active = _activeRecord.exchange(nullptr, std::memory_order_relaxed);
+    active->DurationMs = (now - _recordStart) / 1000;
+    active->Finished = true;
+    record = *active;
+    portEXIT_CRITICAL(&_lock);
+
+    MessageOutput.printf("Main loop stalled for %" PRIu32 " ms in %s\r\n",
+        record.DurationMs, record.Depth[STALL_CONTEXT_LOOP] > 0 ? record.Trace[STALL_CONTEXT_LOOP][0] : "loop");
+}
+
+void StallDetectorClass::checkCallback(void* arg)
+{
+    static_cast<StallDetectorClass*>(arg)->check();
+}
+
+void StallDetectorClass::check()
+{
+    const int64_t now = esp_timer_get_time();
+    const int64_t start = _iterationStart.load(std::memory_order_relaxed);
+    if (now - start < STALL_THRESHOLD_MS * 1000) {
+        return;
+    }
+
+    portENTER_CRITICAL(&_lock);
+    StallRecord_t* record = _activeRecord.load(std::memory_order_relaxed);
+    if (record == nullptr) {
+        record = &stallStorage.Records[stallStorage.Head];
+        stallStorage.Head = (stallStorage.Head + 1) % STALL_RECORD_COUNT;
+        stallStorage.Count = std::min<uint32_t>(stallStorage.Count + 1, STALL_RECORD_COUNT);
+
+        record->BootCount = stallStorage.BootCount;
+        record->Uptime = start / 1000000;
+        record->Finished = false;
+        memset(record->Depth, 0, sizeof(record->Depth));
+        memset(record->Trace, 0, sizeof(record->Trace));
+        for (const auto& activity : _activities) {
+            if (activity.Task == nullptr) {
+                continue;
+            }
+
+            // Other tasks can not stall the main loop on behalf of the loop task
+            const StallContext_t c = activity.Task == _loopTask ? STALL_CONTEXT_LOOP : activity.Context;
+            if (c == STALL_CONTEXT_LOOP && activity.Task != _loopTask) {
+                continue;
+            }
+
+            // If several tasks are active within one context the first one is recorded
+            if (record->Depth[c] > 0) {
+                continue;
+            }
+            record->Depth[c] = std::min<uint8_t>(activity.Depth, STALL_TRACE_DEPTH);
+            memcpy(record->Trace[c], activity.Names, sizeof(record->Trace[c]));
+        }
+
+        _recordStart = start;
+        _activeRecord.store(record, std::memory_order_relaxed);
+    }
+    record->DurationMs = (now - _recordStart) / 1000;
+    portEXIT_CRITICAL(&_lock);
+}
+
+uint32_t StallDetectorClass::getBootCount() const
+{
+    return stallStorage.BootCount;
+}
+
+void StallDetectorClass::getRecords(const std::function<void(const StallRecord_t&)>& onRecord)
+{
+    for (uint32_t i = 0; i < STALL_RECORD_COUNT; i++) {
+        StallRecord_t record;
+
+        portENTER_CRITICAL(&_lock);
+        const uint32_t count = stallStorage.Count;
+        if (i < count) {
+            record = stallStorage.Records[(stallStorage.Head + STALL_RECORD_COUNT - count + i) % STALL_RECORD_COUNT];
+        }
+        portEXIT_CRITICAL(&_lock);
+
+        if (i >= count) {
+            break;
+        }
+
+        // Records of a previous boot are read from uninitialized memory
+        for (uint8_t c = 0; c < STALL_CONTEXT_COUNT; c++) {
+            record.Depth[c] = std::min<uint8_t>(record.Depth[c], STALL_TRACE_DEPTH);
+            for (uint8_t d = 0; d < STALL_TRACE_DEPTH; d++) {
+                record.Trace[c][d][STALL_NAME_LENGTH - 1] = '\0';
+            }
+        }
+
+        onRecord(record);
+    }
+}
+
+StallDetectorClass::Scope::Scope(const char* name, const StallContext_t context)
+    : _slot(-1)
+    , _depth(0)
+{
+    const TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    auto& activities = StallDetector._activities;
+
+    portENTER_CRITICAL(&StallDetector._lock);
+    int8_t freeSlot = -1;
+    for (int8_t i = 0; i < STALL_TASK_SLOTS; i++) {
+        if (activities[i].Task == task) {
+            _slot = i;
+            break;
+        }
+        if (activities[i].Task == nullptr && freeSlot < 0) {
+            freeSlot = i;
+        }
+    }
+
+    if (_slot < 0 && freeSlot >= 0) {
+        _slot = freeSlot;
+        activities[_slot].Task = task;
+        activities[_slot].Context = context;
+        activities[_slot].Depth = 0;
+    }
+
+    if (_slot >= 0) {
+        auto& activity = activities[_slot];
+        _depth = activity.Depth;
+        if (_depth < STALL_TRACE_DEPTH) {
+            strlcpy(activity.Names[_depth], name, STALL_NAME_LENGTH);
+        }
+        activity.Depth = _depth + 1;
+    }
+    portEXIT_CRITICAL(&StallDetector._lock);
+}
+
+StallDetectorClass::Scope::~Scope()
+{
+    if (_slot < 0) {
+        return;
+    }
+
+    portENTER_CRITICAL(&StallDetector._lock);
+    auto& activity = StallDetector._activities[_slot];
+    activity.Depth = _depth;
+    if (_depth == 0) {
+        activity.Task = nullptr;
+    }
+    portEXIT_CRITICAL(&StallDetector._lock);
+}
@@ -4,6 +4,7 @@
  */
 #include "SunPosition.h"
 #include "Configuration.h"
+#include "TaskProfiler.h"
 #include "Utils.h"
 #include <Arduino.h>
 
@@ -12,7 +13,7 @@
 SunPositionClass SunPosition;
 
 SunPositionClass::SunPositionClass()
-    : _loopTask(5 * TASK_SECOND, TASK_FOREVER, std::bind(&SunPositionClass::loop, this))
+    : _loopTask(5 * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("SunPosition", std::bind(&SunPositionClass::loop, this)))
 {
 }
 
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "TaskProfiler.h"
+#include "StallDetector.h"
+#include <Esp.h>
+#include <algorithm>
+
+TaskProfilerClass TaskProfiler;
+
+TaskProfilerClass::Profile_t* TaskProfilerClass::_firstProfile = nullptr;
+
+void TaskProfilerClass::init(Scheduler& scheduler)
+{
+    _scheduler = &scheduler;
+    _cpuFreqMHz = ESP.getCpuFreqMHz();
+}
+
+TaskCallback TaskProfilerClass::wrap(const char* name, TaskCallback callback)
+{
+    Profile_t* profile = new Profile_t {};
+    profile->Name = name;
+
+    // Append to keep the order of construction
+    Profile_t** last = &_firstProfile;
+    while (*last != nullptr) {
+        last = &(*last)->Next;
+    }
+    *last = profile;
+
+    return [profile, callback]() {
+        StallDetectorClass::Scope stallScope(profile->Name);
+
+        // The cycle counter is cheap to read but overflows after ~17 seconds at 240MHz
+        const uint32_t start = ESP.getCycleCount();
+        callback();
+        TaskProfiler.addSample(*profile, ESP.getCycleCount() - start);
+    };
+}
+
+void TaskProfilerClass::addSample(Profile_t& profile, const uint32_t cycles)
+{
+    const uint32_t durationUs = cycles / _cpuFreqMHz;
+
+    profile.Count++;
+    profile.TotalUs += durationUs;
+    if (durationUs > profile.MaxUs) {
+        profile.MaxUs = durationUs;
+    }
+
+    if (_scheduler != nullptr) {
+        const unsigned long interval = _scheduler->currentTask().getInterval();
+        if (interval > 0 && durationUs > interval * 1000) {
+            profile.Overruns++;
+        }
+    }
+
+    uint8_t bucket = 0;
+    for (uint32_t limit = TASK_PROFILE_FIRST_BUCKET_US; durationUs >= limit && bucket < TASK_PROFILE_BUCKETS - 1; limit <<= 1) {
+        bucket++;
+    }
+    profile.Buckets[bucket]++;
+}
+
+const TaskProfilerClass::Profile_t* TaskProfilerClass::getFirstProfile() const
+{
+    return _firstProfile;
+}
+
+uint32_t TaskProfilerClass::getPercentile(const Profile_t& profile, const uint8_t percent)
+{
+    if (profile.Count == 0) {
+        return 0;
+    }
+
+    const uint64_t target = (static_cast<uint64_t>(profile.Count) * percent + 99) / 100;
+    uint64_t sum = 0;
+    for (uint8_t i = 0; i < TASK_PROFILE_BUCKETS - 1; i++) {
+        sum += profile.Buckets[i];
+        if (sum >= target) {
+            // The maximum can be a tighter bound than the upper limit of the bucket
+            return std::min<uint32_t>(TASK_PROFILE_FIRST_BUCKET_US << i, profile.MaxUs);
+        }
+    }
+
+    return profile.MaxUs;
+}
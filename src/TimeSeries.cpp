@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "TimeSeries.h"
+#include "MessageOutput.h"
+#include "TaskProfiler.h"
+#include <Hoymiles.h>
+#include <algorithm>
+#include <cmath>
+#include <esp_heap_caps.h>
+#include <iterator>
+
+TimeSeriesClass TimeSeries;
+
+struct TimeSeriesFieldInfo_t {
+    const char* name;
+    const char* unit;
+    ChannelType_t type;
+    FieldId_t fieldId;
+    float scale; // Values are stored as fixed point int16 with this factor
+    bool keepLast; // Aggregate by keeping the last value instead of the average (counters)
+};
+
+// Indexed by TimeSeriesField
+static const TimeSeriesFieldInfo_t sFields[] = {
+    { "ac_power", "W", TYPE_AC, FLD_PAC, 10, false },
+    { "dc_power", "W", TYPE_INV, FLD_PDC, 10, false },
+    { "yield_day", "Wh", TYPE_INV, FLD_YD, 1, true },
+    { "temperature", "°C", TYPE_INV, FLD_T, 10, false },
+};
+
+struct TimeSeriesLevel_t {
+    uint16_t interval; // Seconds per sample
+    uint16_t depth; // Amount of samples
+};
+
+// Indexed by TimeSeriesResolution
+static const TimeSeriesLevel_t sLevels[] = {
+    { TIMESERIES_SAMPLE_INTERVAL, 360 },
+    { 60, 1440 },
+    { 15 * 60, 672 },
+};
+
+static_assert(std::size(sFields) == static_cast<size_t>(TimeSeriesField::Count));
+static_assert(std::size(sLevels) == static_cast<size_t>(TimeSeriesResolution::Count));
+
+static int16_t toFixedPoint(const float value, const float scale)
+{
+    const float scaled = roundf(value * scale);
+    return static_cast<int16_t>(std::clamp<float>(scaled, TIMESERIES_GAP + 1, INT16_MAX));
+}
+
+TimeSeriesClass::TimeSeriesClass()
+    : _loopTask(1 * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("TimeSeries", std::bind(&TimeSeriesClass::loop, this)))
+{
+}
+
+void TimeSeriesClass::init(Scheduler& scheduler)
+{
+    _startTime = millis();
+
+    if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) == 0) {
+        _levelCount = std::clamp<uint8_t>(TIMESERIES_INTERNAL_LEVELS, 1, std::size(sLevels));
+        _budget = TIMESERIES_INTERNAL_BUDGET;
+        MessageOutput.printf("TimeSeries: No PSRAM, keeping %" PRIu8 " levels within %" PRIu32 " bytes\r\n",
+            _levelCount, static_cast<uint32_t>(_budget));
+    }
+
+    scheduler.addTask(_loopTask);
+    _loopTask.enable();
+}
+
+bool TimeSeriesClass::parseField(const String& name, TimeSeriesField& field)
+{
+    for (uint8_t i = 0; i < std::size(sFields); i++) {
+        if (name == sFields[i].name) {
+            field = static_cast<TimeSeriesField>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* TimeSeriesClass::getFieldName(const TimeSeriesField field)
+{
+    return sFields[static_cast<uint8_t>(field)].name;
+}
+
+const char* TimeSeriesClass::getFieldUnit(const TimeSeriesField field)
+{
+    return sFields[static_cast<uint8_t>(field)].unit;
+}
+
+uint16_t TimeSeriesClass::getInterval(const TimeSeriesResolution resolution)
+{
+    return sLevels[static_cast<uint8_t>(resolution)].interval;
+}
+
+uint16_t TimeSeriesClass::getDepth(const TimeSeriesResolution resolution)
+{
+    return sLevels[static_cast<uint8_t>(resolution)].depth;
+}
+
+uint8_t TimeSeriesClass::getLevelCount() const
+{
+    return _levelCount;
+}
+
+TimeSeriesResolution TimeSeriesClass::getResolutionForAge(const uint32_t age) const
+{
+    for (uint8_t i = 0; i < _levelCount; i++) {
+        if (age <= static_cast<uint32_t>(sLevels[i].interval) * sLevels[i].depth) {
+            return static_cast<TimeSeriesResolution>(i);
+        }
+    }
+    return static_cast<TimeSeriesResolution>(_levelCount - 1);
+}
+
+size_t TimeSeriesClass::getSeriesSize() const
+{
+    size_t size = sizeof(Series_t);
+    for (uint8_t l = 0; l < _levelCount; l++) {
+        size += sLevels[l].depth * sizeof(int16_t) * std::size(sFields);
+    }
+    return size;
+}
+
+TimeSeriesClass::Series_t* TimeSeriesClass::getSeries(const uint64_t serial, const bool create)
+{
+    for (auto& series : _series) {
+        if (series->Serial == serial) {
+            return series.get();
+        }
+    }
+
+    if (!create) {
+        return nullptr;
+    }
+
+    const size_t required = getSeriesSize();
+
+    // Large allocations are placed in PSRAM if available (see heap_caps_malloc_extmem_enable)
+    if ((_series.size() + 1) * required > _budget
+        || heap_caps_get_free_size(MALLOC_CAP_8BIT) < required + TIMESERIES_MIN_FREE_HEAP) {
+        return nullptr;
+    }
+
+    auto series = std::make_unique<Series_t>();
+    series->Serial = serial;
+    series->LastUpdate = 0;
+    for (uint8_t l = 0; l < _levelCount; l++) {
+        for (uint8_t f = 0; f < std::size(sFields); f++) {
+            Ring_t& ring = series->Rings[l][f];
+            ring.Data.reset(new (std::nothrow) int16_t[sLevels[l].depth]);
+            if (ring.Data == nullptr) {
+                MessageOutput.printf("Alloc failed: %s, %" PRId16 "\r\n", __FUNCTION__, __LINE__);
+                return nullptr;
+            }
+            ring.Head = 0;
+            ring.Count = 0;
+
+            series->Accumulators[l][f] = { 0, 0, TIMESERIES_GAP };
+        }
+    }
+
+    // Samples before the inverter was added are gaps
+    for (uint8_t l = 0; l < _levelCount; l++) {
+        const uint32_t missing = std::min<uint32_t>(_samples * TIMESERIES_SAMPLE_INTERVAL / sLevels[l].interval, sLevels[l].depth);
+        for (uint32_t i = 0; i < missing; i++) {
+            for (uint8_t f = 0; f < std::size(sFields); f++) {
+                push(*series, l, f, TIMESERIES_GAP);
+            }
+        }
+    }
+
+    _series.push_back(std::move(series));
+    return _series.back().get();
+}
+
+void TimeSeriesClass::push(Series_t& series, const uint8_t level, const uint8_t field, const int16_t value)
+{
+    Ring_t& ring = series.Rings[level][field];
+    ring.Data[ring.Head] = value;
+    ring.Head = (ring.Head + 1) % sLevels[level].depth;
+    ring.Count = std::min<uint16_t>(ring.Count + 1, sLevels[level].depth);
+}
+
+void TimeSeriesClass::loop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Drop series of removed inverters
+    _series.erase(std::remove_if(_series.begin(), _series.end(),
+                      [](const std::unique_ptr<Series_t>& series) { return Hoymiles.getInverterBySerial(series->Serial) == nullptr; }),
+        _series.end());
+
+    // Feed all new statistics into the accumulators of the finest level
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+        if (inv == nullptr) {
+            continue;
+        }
+
+        auto stats = inv->Statistics();
+        const uint32_t lastUpdate = stats->getLastUpdate();
+        if (lastUpdate == 0 || stats->isStale()) {
+            continue;
+        }
+
+        Series_t* series = getSeries(inv->serial(), true);
+        if (series == nullptr || series->LastUpdate == lastUpdate) {
+            continue;
+        }
+        series->LastUpdate = lastUpdate;
+
+        for (uint8_t f = 0; f < std::size(sFields); f++) {
+            if (!stats->hasChannelFieldValue(sFields[f].type, CH0, sFields[f].fieldId)) {
+                continue;
+            }
+            const int16_t value = toFixedPoint(stats->getChannelFieldValue(sFields[f].type, CH0, sFields[f].fieldId), sFields[f].scale);
+
+            Accumulator_t& acc = series->Accumulators[0][f];
+            acc.Sum += value;
+            acc.Count++;
+            acc.Last = value;
+        }
+    }
+
+    if (millis() - _startTime < (_samples + 1) * TIMESERIES_SAMPLE_INTERVAL * 1000) {
+        return;
+    }
+    _samples++;
+
+    // Close the sample window of every level which is complete and pass it to the next coarser level
+    for (uint8_t l = 0; l < _levelCount; l++) {
+        const uint32_t ratio = sLevels[l].interval / TIMESERIES_SAMPLE_INTERVAL;
+        if (_samples % ratio != 0) {
+            break;
+        }
+
+        for (auto& series : _series) {
+            for (uint8_t f = 0; f < std::size(sFields); f++) {
+                Accumulator_t& acc = series->Accumulators[l][f];
+
+                int16_t value = TIMESERIES_GAP;
+                if (acc.Count > 0) {
+                    value = sFields[f].keepLast ? acc.Last : acc.Sum / acc.Count;
+                }
+                acc = { 0, 0, TIMESERIES_GAP };
+
+                push(*series, l, f, value);
+
+                if (value != TIMESERIES_GAP && l + 1 < _levelCount) {
+                    Accumulator_t& next = series->Accumulators[l + 1][f];
+                    next.Sum += value;
+                    next.Count++;
+                    next.Last = value;
+                }
+            }
+        }
+    }
+}
+
+bool TimeSeriesClass::query(const uint64_t serial, const TimeSeriesField field, const TimeSeriesResolution resolution,
+    const uint32_t maxAge, const uint32_t minAge, const std::function<void(uint32_t, float)>& onValue)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const uint8_t l = static_cast<uint8_t>(resolution);
+    const Series_t* series = getSeries(serial, false);
+    if (series == nullptr || l >= _levelCount) {
+        return false;
+    }
+
+    const uint8_t f = static_cast<uint8_t>(field);
+    const Ring_t& ring = series->Rings[l][f];
+    const uint16_t depth = sLevels[l].depth;
+    const uint32_t interval = sLevels[l].interval;
+
+    // Start of the newest sample relative to the start of the series
+    const uint32_t samplesOfLevel = _samples * TIMESERIES_SAMPLE_INTERVAL / interval;
+    const uint32_t now = (millis() - _startTime) / 1000;
+
+    for (uint16_t i = 0; i < ring.Count; i++) {
+        const uint32_t start = (samplesOfLevel - ring.Count + i) * interval;
+        const uint32_t age = now - start;
+        if (age > maxAge || age < minAge) {
+            continue;
+        }
+
+        const int16_t value = ring.Data[(ring.Head + depth - ring.Count + i) % depth];
+        onValue(age, value == TIMESERIES_GAP ? NAN : value / sFields[f].scale);
+    }
+
+    return true;
+}
@@ -5,6 +5,7 @@
 #include "WebApi.h"
 #include "Configuration.h"
 #include "MessageOutput.h"
+#include "StallDetector.h"
 #include "defaults.h"
 #include <AsyncJson.h>
 
@@ -15,9 +16,17 @@ WebApiClass::WebApiClass()
 
 void WebApiClass::init(Scheduler& scheduler)
 {
+    // Name the running request in stall records
+    _server.addMiddleware([](AsyncWebServerRequest* request, ArMiddlewareNext next) {
+        StallDetectorClass::Scope stallScope(request->url().c_str(), STALL_CONTEXT_WEB);
+        next();
+    });
+
+    _webApiConfig.init(_server, scheduler);
     _webApiDevice.init(_server, scheduler);
     _webApiDevInfo.init(_server, scheduler);
     _webApiDtu.init(_server, scheduler);
+    _webApiEnergy.init(_server, scheduler);
     _webApiEventlog.init(_server, scheduler);
     _webApiFile.init(_server, scheduler);
     _webApiFirmware.init(_server, scheduler);
@@ -33,7 +42,9 @@ void WebApiClass::init(Scheduler& scheduler)
     _webApiPower.init(_server, scheduler);
     _webApiPrometheus.init(_server, scheduler);
     _webApiSecurity.init(_server, scheduler);
+    _webApiStall.init(_server, scheduler);
     _webApiSysstatus.init(_server, scheduler);
+    _webApiTimeSeries.init(_server, scheduler);
     _webApiWebapp.init(_server, scheduler);
     _webApiWsConsole.init(_server, scheduler);
     _webApiWsLive.init(_server, scheduler);
@@ -84,7 +95,17 @@ void WebApiClass::sendTooManyRequests(AsyncWebServerRequest* request)
 
 void WebApiClass::writeConfig(JsonVariant& retMsg, const WebApiError code, const String& message)
 {
-    if (!Configuration.write()) {
+    // Writing to flash is done by the main loop to keep the web server responsive
+    const uint32_t sequence = Configuration.writeDeferred([](const bool success) {
+        if (!success) {
+            MessageOutput.println("Write failed! Settings will be lost on restart.");
+        }
+    });
+
+    // A previous write failed and the changes made since then are not saved yet
+    const auto writeStats = Configuration.getWriteStats();
+    if (writeStats.Saved < writeStats.Completed) {
+        retMsg["type"] = "warning";
         retMsg["message"] = "Write failed!";
         retMsg["code"] = WebApiError::GenericWriteFailed;
     } else {
@@ -92,6 +113,9 @@ void WebApiClass::writeConfig(JsonVariant& retMsg, const WebApiError code, const
         retMsg["message"] = message;
         retMsg["code"] = code;
     }
+
+    // Clients have to poll /api/config/write_status to get the result of the write
+    retMsg["write_sequence"] = sequence;
 }
 
 bool WebApiClass::parseRequestData(AsyncWebServerRequest* request, AsyncJsonResponse* response, JsonDocument& json_document)
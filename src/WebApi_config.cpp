@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "WebApi_config.h"
+#include "Configuration.h"
+#include "WebApi.h"
+#include <AsyncJson.h>
+
+void WebApiConfigClass::init(AsyncWebServer& server, Scheduler& scheduler)
+{
+    using std::placeholders::_1;
+
+    server.on("/api/config/write_status", HTTP_GET, std::bind(&WebApiConfigClass::onWriteStatus, this, _1));
+}
+
+// Result of the deferred write belonging to the write_sequence returned by a settings POST
+void WebApiConfigClass::onWriteStatus(AsyncWebServerRequest* request)
+{
+    if (!WebApi.checkCredentials(request)) {
+        return;
+    }
+
+    AsyncJsonResponse* response = new AsyncJsonResponse();
+    auto& root = response->getRoot();
+
+    const auto writeStats = Configuration.getWriteStats();
+    uint32_t sequence = writeStats.Requests;
+    if (request->hasParam("sequence")) {
+        sequence = request->getParam("sequence")->value().toInt();
+    }
+
+    // Sequence numbers start again after a restart. Pending writes are
+    // flushed before, so unknown numbers are reported as done.
+    const bool pending = sequence > writeStats.Completed && sequence <= writeStats.Requests;
+
+    root["sequence"] = sequence;
+    root["pending"] = pending;
+    root["requests"] = writeStats.Requests;
+    root["completed"] = writeStats.Completed;
+    root["saved"] = writeStats.Saved;
+    root["last_duration"] = writeStats.LastDuration;
+
+    if (pending) {
+        root["type"] = "info";
+    } else if (sequence <= writeStats.Saved || sequence > writeStats.Requests) {
+        root["type"] = "success";
+        root["message"] = "Settings saved!";
+        root["code"] = WebApiError::GenericSuccess;
+    } else {
+        root["type"] = "warning";
+        root["message"] = "Write failed!";
+        root["code"] = WebApiError::GenericWriteFailed;
+    }
+
+    WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+}
@@ -4,13 +4,14 @@
  */
 #include "WebApi_dtu.h"
 #include "Configuration.h"
+#include "TaskProfiler.h"
 #include "WebApi.h"
 #include "WebApi_errors.h"
 #include <AsyncJson.h>
 #include <Hoymiles.h>
 
 WebApiDtuClass::WebApiDtuClass()
-    : _applyDataTask(TASK_IMMEDIATE, TASK_ONCE, std::bind(&WebApiDtuClass::applyDataTaskCb, this))
+    : _applyDataTask(TASK_IMMEDIATE, TASK_ONCE, TaskProfiler.wrap("WebApiDtuApply", std::bind(&WebApiDtuClass::applyDataTaskCb, this)))
 {
 }
 
@@ -26,8 +27,10 @@ void WebApiDtuClass::init(AsyncWebServer& server, Scheduler& scheduler)
 
 void WebApiDtuClass::applyDataTaskCb()
 {
-    // Execute stuff in main thread to avoid busy SPI bus
+    // The radios are driven by the Hoymiles task. Keep it from accessing
+    // the SPI bus while the settings are applied.
     auto const& config = Configuration.get();
+    auto lock = Hoymiles.lockRadios();
     Hoymiles.getRadioNrf()->setPALevel((rf24_pa_dbm_e)config.Dtu.Nrf.PaLevel);
     Hoymiles.getRadioCmt()->setPALevel(config.Dtu.Cmt.PaLevel);
     Hoymiles.getRadioNrf()->setDtuSerial(config.Dtu.Serial);
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "WebApi_energy.h"
+#include "EnergyLog.h"
+#include "WebApi.h"
+#include <AsyncJson.h>
+#include <memory>
+
+void WebApiEnergyClass::init(AsyncWebServer& server, Scheduler& scheduler)
+{
+    using std::placeholders::_1;
+
+    server.on("/api/energy/status", HTTP_GET, std::bind(&WebApiEnergyClass::onEnergyStatus, this, _1));
+    server.on("/api/energy/export", HTTP_GET, std::bind(&WebApiEnergyClass::onEnergyExport, this, _1));
+}
+
+void WebApiEnergyClass::onEnergyStatus(AsyncWebServerRequest* request)
+{
+    if (!WebApi.checkCredentialsReadonly(request)) {
+        return;
+    }
+
+    AsyncJsonResponse* response = new AsyncJsonResponse();
+    auto& root = response->getRoot();
+    auto serial = WebApi.parseSerialFromRequest(request);
+
+    auto days = root["days"].to<JsonArray>();
+    auto months = root["months"].to<JsonArray>();
+
+    EnergyLog.getRollups(serial, [&](const EnergyLogClass::Rollup_t& rollup, const bool monthly) {
+        auto obj = monthly ? months.add<JsonObject>() : days.add<JsonObject>();
+        obj["date"] = rollup.Key;
+        obj["energy"] = rollup.Energy;
+    });
+
+    WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+}
+
+// Streams the whole energy log as CSV without loading it into memory
+void WebApiEnergyClass::onEnergyExport(AsyncWebServerRequest* request)
+{
+    if (!WebApi.checkCredentialsReadonly(request)) {
+        return;
+    }
+
+    // Records which are still buffered in RAM are appended to the file
+    // contents. Nothing is written to flash from within the web server task.
+    struct ExportState {
+        EnergyLogReader logs[2]; // Old and current log
+        std::vector<uint8_t> buffered;
+        uint8_t stage = 0; // 0: old log, 1: current log, 2: buffered records
+        String pending = "time,serial,channel,energy\n";
+
+        // Released when the response is finished or aborted
+        ~ExportState() { EnergyLog.closeSnapshot(); }
+    };
+    auto state = std::make_shared<ExportState>();
+    EnergyLog.openSnapshot(state->logs[0], state->logs[1], state->buffered);
+
+    auto response = request->beginChunkedResponse("text/csv", [state](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+        EnergyLogRecord_t record;
+        while (state->pending.length() < maxLen) {
+            auto& reader = state->logs[state->stage == 0 ? 0 : 1];
+            if (!reader.next(record)) {
+                if (state->stage >= 2) {
+                    break;
+                }
+                if (++state->stage == 2) {
+                    state->logs[1].openBuffer(std::move(state->buffered));
+                }
+                continue;
+            }
+
+            if (record.Type != ENERGY_RECORD_INTERVAL) {
+                continue;
+            }
+
+            size_t v = 0;
+            for (const auto& inv : reader.getLayout()) {
+                for (uint8_t c = 0; c < inv.Channels; c++, v++) {
+                    if (record.Values[v] == 0) {
+                        continue;
+                    }
+                    char line[64];
+                    snprintf(line, sizeof(line), "%" PRIu32 ",%0" PRIx32 "%08" PRIx32 ",%" PRIu8 ",%" PRIu32 "\n",
+                        record.Index * ENERGY_LOG_INTERVAL,
+                        static_cast<uint32_t>((inv.Serial >> 32) & 0xFFFFFFFF),
+                        static_cast<uint32_t>(inv.Serial & 0xFFFFFFFF),
+                        c, record.Values[v]);
+                    state->pending += line;
+                }
+            }
+        }
+
+        const size_t len = std::min<size_t>(state->pending.length(), maxLen);
+        memcpy(buffer, state->pending.c_str(), len);
+        state->pending.remove(0, len);
+        return len;
+    });
+    response->addHeader("Content-Disposition", "attachment; filename=\"energy.csv\"");
+    request->send(response);
+}
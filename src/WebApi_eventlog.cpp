@@ -44,11 +44,13 @@ void WebApiEventlogClass::onEventlogStatus(AsyncWebServerRequest* request)
         root["count"] = logEntryCount;
         JsonArray eventsArray = root["events"].to<JsonArray>();
 
+        const int timezoneOffset = AlarmLogParser::getTimezoneOffset();
+
         for (uint8_t logEntry = 0; logEntry < logEntryCount; logEntry++) {
             JsonObject eventsObject = eventsArray.add<JsonObject>();
 
             AlarmLogEntry_t entry;
-            inv->EventLog()->getLogEntry(logEntry, entry, locale);
+            inv->EventLog()->getLogEntry(logEntry, entry, timezoneOffset, locale);
 
             eventsObject["message_id"] = entry.MessageId;
             eventsObject["message"] = entry.Message;
@@ -11,6 +11,12 @@
 #include <AsyncJson.h>
 #include <LittleFS.h>
 
+// Discards all output, used to determine the size of generated content
+class NullPrint : public Print {
+public:
+    size_t write(uint8_t) override { return 1; }
+};
+
 void WebApiFileClass::init(AsyncWebServer& server, Scheduler& scheduler)
 {
     using std::placeholders::_1;
@@ -53,6 +59,14 @@ void WebApiFileClass::onFileListGet(AsyncWebServerRequest* request)
     }
     file.close();
 
+    // The configuration is stored in binary format, its JSON representation is generated on demand
+    if (!LittleFS.exists(CONFIG_FILENAME)) {
+        JsonObject obj = data.add<JsonObject>();
+        obj["name"] = String(CONFIG_FILENAME).substring(1);
+        NullPrint nullPrint;
+        obj["size"] = Configuration.exportJson(nullPrint);
+    }
+
     WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
 }
 
@@ -64,13 +78,20 @@ void WebApiFileClass::onFileGet(AsyncWebServerRequest* request)
 
     String requestFile = CONFIG_FILENAME;
     if (request->hasParam("file")) {
-        String name = "/" + request->getParam("file")->value();
-        if (LittleFS.exists(name)) {
-            requestFile = name;
-        } else {
-            request->send(404);
-            return;
-        }
+        requestFile = "/" + request->getParam("file")->value();
+    }
+
+    if (requestFile == CONFIG_FILENAME && !LittleFS.exists(requestFile)) {
+        AsyncResponseStream* response = request->beginResponseStream("application/json");
+        response->addHeader("Content-Disposition", "attachment; filename=\"" + requestFile.substring(1) + "\"");
+        Configuration.exportJson(*response);
+        request->send(response);
+        return;
+    }
+
+    if (!LittleFS.exists(requestFile)) {
+        request->send(404);
+        return;
     }
 
     request->send(LittleFS, requestFile, String(), true);
@@ -146,6 +167,7 @@ void WebApiFileClass::onFileDeleteAll(AsyncWebServerRequest* request)
 
     WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
 
+    Configuration.discardPendingWrite();
     Utils::removeAllFiles();
     RestartHelper.triggerRestart();
 }
@@ -31,22 +31,21 @@ void WebApiGridProfileClass::onGridProfileStatus(AsyncWebServerRequest* request)
         root["version"] = inv->GridProfile()->getProfileVersion();
 
         auto jsonSections = root["sections"].to<JsonArray>();
-        auto profSections = inv->GridProfile()->getProfile();
-
-        for (auto &profSection : profSections) {
-            auto jsonSection = jsonSections.add<JsonObject>();
-            jsonSection["name"] = profSection.SectionName;
-
-            auto jsonItems = jsonSection["items"].to<JsonArray>();
-
-            for (auto &profItem : profSection.items) {
+        JsonArray jsonItems;
+
+        inv->GridProfile()->visitProfile(
+            [&](const char* name) {
+                auto jsonSection = jsonSections.add<JsonObject>();
+                jsonSection["name"] = name;
+                jsonItems = jsonSection["items"].to<JsonArray>();
+            },
+            [&](const char* name, const char* unit, const float value) {
                 auto jsonItem = jsonItems.add<JsonObject>();
 
-                jsonItem["n"] = profItem.Name;
-                jsonItem["u"] = profItem.Unit;
-                jsonItem["v"] = profItem.Value;
-            }
-        }
+                jsonItem["n"] = name;
+                jsonItem["u"] = unit;
+                jsonItem["v"] = value;
+            });
     }
 
     WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
@@ -4,6 +4,7 @@
  */
 #include "WebApi_inverter.h"
 #include "Configuration.h"
+#include "InverterPersistence.h"
 #include "MqttHandleHass.h"
 #include "WebApi.h"
 #include "WebApi_errors.h"
@@ -250,6 +251,7 @@ void WebApiInverterClass::onInverterEdit(AsyncWebServerRequest* request)
     if (inv != nullptr && new_serial != old_serial) {
         // Valid inverter exists but serial changed --> remove it and insert new one
         Hoymiles.removeInverterBySerial(old_serial);
+        InverterPersistence.remove(old_serial);
         inv = Hoymiles.addInverter(inverter.Name, inverter.Serial);
     } else if (inv != nullptr && new_serial == old_serial) {
         // Valid inverter exists and serial stays the same --> update name
@@ -308,6 +310,7 @@ void WebApiInverterClass::onInverterDelete(AsyncWebServerRequest* request)
     INVERTER_CONFIG_T const& inverter = Configuration.get().Inverter[inverter_id];
 
     Hoymiles.removeInverterBySerial(inverter.Serial);
+    InverterPersistence.remove(inverter.Serial);
 
     Configuration.deleteInverterById(inverter_id);
 
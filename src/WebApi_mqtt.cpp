@@ -40,9 +40,9 @@ void WebApiMqttClass::onMqttStatus(AsyncWebServerRequest* request)
     root["mqtt_connected"] = MqttSettings.getConnected();
     root["mqtt_retain"] = config.Mqtt.Retain;
     root["mqtt_tls"] = config.Mqtt.Tls.Enabled;
-    root["mqtt_root_ca_cert_info"] = getTlsCertInfo(config.Mqtt.Tls.RootCaCert);
+    root["mqtt_root_ca_cert_info"] = getTlsCertInfo(Configuration.readBlob(ConfigBlob::MqttRootCaCert).c_str());
     root["mqtt_tls_cert_login"] = config.Mqtt.Tls.CertLogin;
-    root["mqtt_client_cert_info"] = getTlsCertInfo(config.Mqtt.Tls.ClientCert);
+    root["mqtt_client_cert_info"] = getTlsCertInfo(Configuration.readBlob(ConfigBlob::MqttClientCert).c_str());
     root["mqtt_lwt_topic"] = String(config.Mqtt.Topic) + config.Mqtt.Lwt.Topic;
     root["mqtt_publish_interval"] = config.Mqtt.PublishInterval;
     root["mqtt_clean_session"] = config.Mqtt.CleanSession;
@@ -74,10 +74,10 @@ void WebApiMqttClass::onMqttAdminGet(AsyncWebServerRequest* request)
     root["mqtt_topic"] = config.Mqtt.Topic;
     root["mqtt_retain"] = config.Mqtt.Retain;
     root["mqtt_tls"] = config.Mqtt.Tls.Enabled;
-    root["mqtt_root_ca_cert"] = config.Mqtt.Tls.RootCaCert;
+    root["mqtt_root_ca_cert"] = Configuration.readBlob(ConfigBlob::MqttRootCaCert);
     root["mqtt_tls_cert_login"] = config.Mqtt.Tls.CertLogin;
-    root["mqtt_client_cert"] = config.Mqtt.Tls.ClientCert;
-    root["mqtt_client_key"] = config.Mqtt.Tls.ClientKey;
+    root["mqtt_client_cert"] = Configuration.readBlob(ConfigBlob::MqttClientCert);
+    root["mqtt_client_key"] = Configuration.readBlob(ConfigBlob::MqttClientKey);
     root["mqtt_lwt_topic"] = config.Mqtt.Lwt.Topic;
     root["mqtt_lwt_online"] = config.Mqtt.Lwt.Value_Online;
     root["mqtt_lwt_offline"] = config.Mqtt.Lwt.Value_Offline;
@@ -278,10 +278,7 @@ void WebApiMqttClass::onMqttAdminPost(AsyncWebServerRequest* request)
         config.Mqtt.Enabled = root["mqtt_enabled"].as<bool>();
         config.Mqtt.Retain = root["mqtt_retain"].as<bool>();
         config.Mqtt.Tls.Enabled = root["mqtt_tls"].as<bool>();
-        strlcpy(config.Mqtt.Tls.RootCaCert, root["mqtt_root_ca_cert"].as<String>().c_str(), sizeof(config.Mqtt.Tls.RootCaCert));
         config.Mqtt.Tls.CertLogin = root["mqtt_tls_cert_login"].as<bool>();
-        strlcpy(config.Mqtt.Tls.ClientCert, root["mqtt_client_cert"].as<String>().c_str(), sizeof(config.Mqtt.Tls.ClientCert));
-        strlcpy(config.Mqtt.Tls.ClientKey, root["mqtt_client_key"].as<String>().c_str(), sizeof(config.Mqtt.Tls.ClientKey));
         config.Mqtt.Port = root["mqtt_port"].as<uint>();
         strlcpy(config.Mqtt.Hostname, root["mqtt_hostname"].as<String>().c_str(), sizeof(config.Mqtt.Hostname));
         strlcpy(config.Mqtt.ClientId, root["mqtt_clientid"].as<String>().c_str(), sizeof(config.Mqtt.ClientId));
@@ -307,6 +304,11 @@ void WebApiMqttClass::onMqttAdminPost(AsyncWebServerRequest* request)
         }
     }
 
+    // Only changed certificates are written, together with the other settings
+    Configuration.setBlob(ConfigBlob::MqttRootCaCert, root["mqtt_root_ca_cert"].as<String>());
+    Configuration.setBlob(ConfigBlob::MqttClientCert, root["mqtt_client_cert"].as<String>());
+    Configuration.setBlob(ConfigBlob::MqttClientKey, root["mqtt_client_key"].as<String>());
+
     WebApi.writeConfig(retMsg);
 
     WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
@@ -5,8 +5,10 @@
  */
 #include "WebApi_prometheus.h"
 #include "Configuration.h"
+#include "HeapMonitor.h"
 #include "MessageOutput.h"
 #include "NetworkSettings.h"
+#include "TaskProfiler.h"
 #include "WebApi.h"
 #include <Hoymiles.h>
 #include "__compiled_constants.h"
@@ -56,6 +58,33 @@ void WebApiPrometheusClass::onPrometheusMetricsGet(AsyncWebServerRequest* reques
         stream->print("# TYPE opendtu_heap_min_free gauge\n");
         stream->printf("opendtu_heap_min_free %" PRId32 "\n", ESP.getMinFreeHeap());
 
+        stream->print("# HELP opendtu_heap_fragmentation Fragmentation of the free heap in percent\n");
+        stream->print("# TYPE opendtu_heap_fragmentation gauge\n");
+        stream->printf("opendtu_heap_fragmentation %" PRIu8 "\n", HeapMonitor.getFragmentation());
+
+        stream->print("# HELP opendtu_heap_fragmentation_max Maximum fragmentation of the free heap in percent since boot\n");
+        stream->print("# TYPE opendtu_heap_fragmentation_max gauge\n");
+        stream->printf("opendtu_heap_fragmentation_max %" PRIu8 "\n", HeapMonitor.getFragmentationMax());
+
+        addHeapTags(stream);
+
+        const auto writeStats = Configuration.getWriteStats();
+        stream->print("# HELP opendtu_config_write_requests Number of requested configuration writes\n");
+        stream->print("# TYPE opendtu_config_write_requests counter\n");
+        stream->printf("opendtu_config_write_requests %" PRIu32 "\n", writeStats.Requests);
+
+        stream->print("# HELP opendtu_config_writes Number of configuration writes to flash\n");
+        stream->print("# TYPE opendtu_config_writes counter\n");
+        stream->printf("opendtu_config_writes %" PRIu32 "\n", writeStats.Writes);
+
+        stream->print("# HELP opendtu_config_write_duration Duration of the last configuration write in ms\n");
+        stream->print("# TYPE opendtu_config_write_duration gauge\n");
+        stream->printf("opendtu_config_write_duration %" PRIu32 "\n", writeStats.LastDuration);
+
+        stream->print("# HELP opendtu_config_write_duration_max Maximum duration of a configuration write in ms\n");
+        stream->print("# TYPE opendtu_config_write_duration_max gauge\n");
+        stream->printf("opendtu_config_write_duration_max %" PRIu32 "\n", writeStats.MaxDuration);
+
         stream->print("# HELP wifi_rssi WiFi RSSI\n");
         stream->print("# TYPE wifi_rssi gauge\n");
         stream->printf("wifi_rssi %" PRId8 "\n", WiFi.RSSI());
@@ -64,6 +93,9 @@ void WebApiPrometheusClass::onPrometheusMetricsGet(AsyncWebServerRequest* reques
         stream->print("# TYPE wifi_station gauge\n");
         stream->printf("wifi_station{bssid=\"%s\"} 1\n", WiFi.BSSIDstr().c_str());
 
+        addTaskProfiles(stream);
+        addRadioHistograms(stream);
+
         for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
             auto inv = Hoymiles.getInverterByPos(i);
 
@@ -179,3 +211,146 @@ void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, const Stri
         channel,
         config->channel[channel].YieldTotalOffset);
 }
+
+void WebApiPrometheusClass::addTaskProfiles(AsyncResponseStream* stream)
+{
+    const auto first = TaskProfiler.getFirstProfile();
+
+    stream->print("# HELP opendtu_task_invocations Number of scheduler task invocations\n");
+    stream->print("# TYPE opendtu_task_invocations counter\n");
+    for (auto profile = first; profile != nullptr; profile = profile->Next) {
+        stream->printf("opendtu_task_invocations{task=\"%s\"} %" PRIu32 "\n", profile->Name, profile->Count);
+    }
+
+    stream->print("# HELP opendtu_task_runtime_seconds Total runtime of a scheduler task\n");
+    stream->print("# TYPE opendtu_task_runtime_seconds counter\n");
+    for (auto profile = first; profile != nullptr; profile = profile->Next) {
+        stream->printf("opendtu_task_runtime_seconds{task=\"%s\"} %f\n", profile->Name, profile->TotalUs / 1000000.0);
+    }
+
+    stream->print("# HELP opendtu_task_runtime_max_seconds Longest invocation of a scheduler task\n");
+    stream->print("# TYPE opendtu_task_runtime_max_seconds gauge\n");
+    for (auto profile = first; profile != nullptr; profile = profile->Next) {
+        stream->printf("opendtu_task_runtime_max_seconds{task=\"%s\"} %f\n", profile->Name, profile->MaxUs / 1000000.0);
+    }
+
+    stream->print("# HELP opendtu_task_runtime_p99_seconds Estimated 99th percentile of the invocation duration of a scheduler task\n");
+    stream->print("# TYPE opendtu_task_runtime_p99_seconds gauge\n");
+    for (auto profile = first; profile != nullptr; profile = profile->Next) {
+        stream->printf("opendtu_task_runtime_p99_seconds{task=\"%s\"} %f\n", profile->Name, TaskProfiler.getPercentile(*profile, 99) / 1000000.0);
+    }
+
+    stream->print("# HELP opendtu_task_overruns Number of scheduler task invocations which took longer than the task interval\n");
+    stream->print("# TYPE opendtu_task_overruns counter\n");
+    for (auto profile = first; profile != nullptr; profile = profile->Next) {
+        stream->printf("opendtu_task_overruns{task=\"%s\"} %" PRIu32 "\n", profile->Name, profile->Overruns);
+    }
+}
+
+void WebApiPrometheusClass::addHeapTags(AsyncResponseStream* stream)
+{
+    stream->print("# HELP opendtu_heap_tag_live Heap memory currently used by a subsystem\n");
+    stream->print("# TYPE opendtu_heap_tag_live gauge\n");
+    for (uint8_t tag = 0; tag < HEAP_TAG_COUNT; tag++) {
+        stream->printf("opendtu_heap_tag_live{tag=\"%s\"} %" PRIu32 "\n",
+            HeapAccounting.getTagName(static_cast<HeapTag_t>(tag)), HeapAccounting.getStats(static_cast<HeapTag_t>(tag)).Live);
+    }
+
+    stream->print("# HELP opendtu_heap_tag_peak Maximum heap memory used by a subsystem since boot\n");
+    stream->print("# TYPE opendtu_heap_tag_peak gauge\n");
+    for (uint8_t tag = 0; tag < HEAP_TAG_COUNT; tag++) {
+        stream->printf("opendtu_heap_tag_peak{tag=\"%s\"} %" PRIu32 "\n",
+            HeapAccounting.getTagName(static_cast<HeapTag_t>(tag)), HeapAccounting.getStats(static_cast<HeapTag_t>(tag)).Peak);
+    }
+
+    stream->print("# HELP opendtu_heap_tag_allocations Number of heap allocations of a subsystem\n");
+    stream->print("# TYPE opendtu_heap_tag_allocations counter\n");
+    for (uint8_t tag = 0; tag < HEAP_TAG_COUNT; tag++) {
+        stream->printf("opendtu_heap_tag_allocations{tag=\"%s\"} %" PRIu32 "\n",
+            HeapAccounting.getTagName(static_cast<HeapTag_t>(tag)), HeapAccounting.getStats(static_cast<HeapTag_t>(tag)).Allocations);
+    }
+
+    stream->print("# HELP opendtu_heap_tag_allocation_rate Heap allocations per second of a subsystem\n");
+    stream->print("# TYPE opendtu_heap_tag_allocation_rate gauge\n");
+    for (uint8_t tag = 0; tag < HEAP_TAG_COUNT; tag++) {
+        stream->printf("opendtu_heap_tag_allocation_rate{tag=\"%s\"} %f\n",
+            HeapAccounting.getTagName(static_cast<HeapTag_t>(tag)), HeapMonitor.getAllocationRate(static_cast<HeapTag_t>(tag)));
+    }
+}
+
+void WebApiPrometheusClass::addRadioHistograms(AsyncResponseStream* stream)
+{
+    const std::pair<const char*, HoymilesRadio*> radios[] = {
+        { "nrf", Hoymiles.getRadioNrf() },
+        { "cmt", Hoymiles.getRadioCmt() },
+    };
+
+    stream->print("# HELP opendtu_radio_tx_airtime_seconds Time the radio was busy transmitting\n");
+    stream->print("# TYPE opendtu_radio_tx_airtime_seconds counter\n");
+    for (auto& [name, radio] : radios) {
+        if (radio->isInitialized()) {
+            stream->printf("opendtu_radio_tx_airtime_seconds{radio=\"%s\"} %f\n", name, radio->getTxAirtime() / 1000000.0);
+        }
+    }
+
+    stream->print("# HELP opendtu_radio_rx_latency_seconds Time from sending a request until the first fragment of the answer was received\n");
+    stream->print("# TYPE opendtu_radio_rx_latency_seconds histogram\n");
+    for (auto& [name, radio] : radios) {
+        if (radio->isInitialized()) {
+            addHistogram(stream, "opendtu_radio_rx_latency_seconds", String("radio=\"") + name + "\"", radio->RxLatency, 0.001);
+        }
+    }
+
+    stream->print("# HELP opendtu_radio_command_complete_seconds Time from sending a request until the answer was completely received\n");
+    stream->print("# TYPE opendtu_radio_command_complete_seconds histogram\n");
+    for (auto& [name, radio] : radios) {
+        if (!radio->isInitialized()) {
+            continue;
+        }
+        for (uint8_t i = 0; i < radio->getCommandStatsCount(); i++) {
+            const auto& stats = radio->getCommandStats(i);
+            addHistogram(stream, "opendtu_radio_command_complete_seconds",
+                String("radio=\"") + name + "\",command=\"" + stats.Name + "\"", stats.CompleteTime, 0.001);
+        }
+    }
+
+    stream->print("# HELP opendtu_radio_command_retransmits Resent requests and re-requested fragments per command\n");
+    stream->print("# TYPE opendtu_radio_command_retransmits histogram\n");
+    for (auto& [name, radio] : radios) {
+        if (!radio->isInitialized()) {
+            continue;
+        }
+        for (uint8_t i = 0; i < radio->getCommandStatsCount(); i++) {
+            const auto& stats = radio->getCommandStats(i);
+            addHistogram(stream, "opendtu_radio_command_retransmits",
+                String("radio=\"") + name + "\",command=\"" + stats.Name + "\"", stats.Retransmits);
+        }
+    }
+
+    stream->print("# HELP opendtu_inverter_rssi_dbm RSSI of the received fragments\n");
+    stream->print("# TYPE opendtu_inverter_rssi_dbm histogram\n");
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+        addHistogram(stream, "opendtu_inverter_rssi_dbm",
+            String("serial=\"") + inv->serialString() + "\",unit=\"" + i + "\",name=\"" + inv->name() + "\"", inv->RssiHistogram);
+    }
+}
+
+void WebApiPrometheusClass::addHistogram(AsyncResponseStream* stream, const char* name, const String& labels, const Histogram& histogram, const double scale)
+{
+    // The radio task keeps adding values while the response is written
+    const Histogram snapshot(histogram);
+    const uint32_t count = snapshot.getCumulativeBucket(snapshot.getBoundCount());
+
+    for (uint8_t i = 0; i < snapshot.getBoundCount(); i++) {
+        stream->printf("%s_bucket{%s,le=\"%g\"} %" PRIu32 "\n",
+            name, labels.c_str(), snapshot.getBound(i) * scale, snapshot.getCumulativeBucket(i));
+    }
+    stream->printf("%s_bucket{%s,le=\"+Inf\"} %" PRIu32 "\n", name, labels.c_str(), count);
+    if (scale == 1) {
+        stream->printf("%s_sum{%s} %" PRId64 "\n", name, labels.c_str(), snapshot.getSum());
+    } else {
+        stream->printf("%s_sum{%s} %.3f\n", name, labels.c_str(), snapshot.getSum() * scale);
+    }
+    stream->printf("%s_count{%s} %" PRIu32 "\n", name, labels.c_str(), count);
+}
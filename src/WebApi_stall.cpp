@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "WebApi_stall.h"
+#include "StallDetector.h"
+#include "WebApi.h"
+#include <AsyncJson.h>
+
+void WebApiStallClass::init(AsyncWebServer& server, Scheduler& scheduler)
+{
+    using std::placeholders::_1;
+
+    server.on("/api/stall/status", HTTP_GET, std::bind(&WebApiStallClass::onStallStatus, this, _1));
+}
+
+void WebApiStallClass::onStallStatus(AsyncWebServerRequest* request)
+{
+    if (!WebApi.checkCredentialsReadonly(request)) {
+        return;
+    }
+
+    AsyncJsonResponse* response = new AsyncJsonResponse();
+    auto& root = response->getRoot();
+
+    root["threshold_ms"] = STALL_THRESHOLD_MS;
+    root["boot_count"] = StallDetector.getBootCount();
+
+    static constexpr char const* contextNames[STALL_CONTEXT_COUNT] = { "loop", "web", "modbus" };
+
+    JsonArray records = root["records"].to<JsonArray>();
+    StallDetector.getRecords([&records](const StallRecord_t& record) {
+        JsonObject obj = records.add<JsonObject>();
+        obj["boot"] = record.BootCount;
+        obj["uptime"] = record.Uptime;
+        obj["duration_ms"] = record.DurationMs;
+        obj["finished"] = record.Finished;
+
+        for (uint8_t c = 0; c < STALL_CONTEXT_COUNT; c++) {
+            JsonArray trace = obj[contextNames[c]].to<JsonArray>();
+            for (uint8_t d = 0; d < record.Depth[c]; d++) {
+                trace.add(record.Trace[c][d]);
+            }
+        }
+    });
+
+    WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+}
@@ -4,8 +4,10 @@
  */
 #include "WebApi_sysstatus.h"
 #include "Configuration.h"
+#include "InverterSettings.h"
 #include "NetworkSettings.h"
 #include "PinMapping.h"
+#include "TaskProfiler.h"
 #include "WebApi.h"
 #include "__compiled_constants.h"
 #include <AsyncJson.h>
@@ -53,8 +55,8 @@ void WebApiSysstatusClass::onSystemStatus(AsyncWebServerRequest* request)
     root["flashsize"] = ESP.getFlashChipSize();
 
     JsonArray taskDetails = root["task_details"].to<JsonArray>();
-    static std::array<char const*, 12> constexpr task_names = {
-        "IDLE0", "IDLE1", "wifi", "tiT", "loopTask", "async_tcp", "mqttclient",
+    static std::array<char const*, 13> constexpr task_names = {
+        "IDLE0", "IDLE1", "wifi", "tiT", "loopTask", HOY_TASK_NAME, "async_tcp", "mqttclient",
         "HUAWEI_CAN_0", "PM:SDM", "PM:HTTP+JSON", "PM:SML", "PM:HTTP+SML"
     };
     for (char const* task_name : task_names) {
@@ -66,6 +68,17 @@ void WebApiSysstatusClass::onSystemStatus(AsyncWebServerRequest* request)
         task["priority"] = uxTaskPriorityGet(handle);
     }
 
+    JsonArray taskProfiles = root["task_profiles"].to<JsonArray>();
+    for (auto profile = TaskProfiler.getFirstProfile(); profile != nullptr; profile = profile->Next) {
+        JsonObject task = taskProfiles.add<JsonObject>();
+        task["name"] = profile->Name;
+        task["count"] = profile->Count;
+        task["total_ms"] = profile->TotalUs / 1000;
+        task["max_us"] = profile->MaxUs;
+        task["p99_us"] = TaskProfiler.getPercentile(*profile, 99);
+        task["overruns"] = profile->Overruns;
+    }
+
     String reason;
     reason = ResetReason::get_reset_reason_verbose(0);
     root["resetreason_0"] = reason;
@@ -84,11 +97,15 @@ void WebApiSysstatusClass::onSystemStatus(AsyncWebServerRequest* request)
     root["uptime"] = esp_timer_get_time() / 1000000;
 
     root["nrf_configured"] = PinMapping.isValidNrf24Config();
-    root["nrf_connected"] = Hoymiles.getRadioNrf()->isConnected();
-    root["nrf_pvariant"] = Hoymiles.getRadioNrf()->isPVariant();
-
     root["cmt_configured"] = PinMapping.isValidCmt2300Config();
-    root["cmt_connected"] = Hoymiles.getRadioCmt()->isConnected();
+    {
+        // isConnected() reads the chip registers
+        auto lock = Hoymiles.lockRadios();
+        root["nrf_connected"] = Hoymiles.getRadioNrf()->isConnected();
+        root["nrf_pvariant"] = Hoymiles.getRadioNrf()->isPVariant();
+        root["cmt_connected"] = Hoymiles.getRadioCmt()->isConnected();
+        root["cmt_turnaround"] = Hoymiles.getRadioCmt()->getTxRxTurnaround();
+    }
 
     WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
 }
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "WebApi_timeseries.h"
+#include "TimeSeries.h"
+#include "WebApi.h"
+#include <AsyncJson.h>
+#include <cmath>
+
+void WebApiTimeSeriesClass::init(AsyncWebServer& server, Scheduler& scheduler)
+{
+    using std::placeholders::_1;
+
+    server.on("/api/timeseries/status", HTTP_GET, std::bind(&WebApiTimeSeriesClass::onTimeSeriesStatus, this, _1));
+}
+
+// Parameters:
+//   inv:   serial of the inverter
+//   field: ac_power, dc_power, yield_day or temperature
+//   from:  epoch of the oldest sample (optional, default: one hour ago)
+//   to:    epoch of the newest sample (optional, default: now)
+//   res:   seconds per sample: 10, 60 or 900 (optional, default: finest one which covers "from")
+void WebApiTimeSeriesClass::onTimeSeriesStatus(AsyncWebServerRequest* request)
+{
+    if (!WebApi.checkCredentialsReadonly(request)) {
+        return;
+    }
+
+    AsyncJsonResponse* response = new AsyncJsonResponse();
+    auto& root = response->getRoot();
+    const uint64_t serial = WebApi.parseSerialFromRequest(request);
+
+    TimeSeriesField field = TimeSeriesField::AcPower;
+    if (request->hasParam("field") && !TimeSeries.parseField(request->getParam("field")->value(), field)) {
+        root["message"] = "Invalid field!";
+        root["code"] = WebApiError::GenericValueMissing;
+        root["type"] = "warning";
+        WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+        return;
+    }
+
+    const time_t now = time(nullptr);
+    time_t from = now - 3600;
+    time_t to = now;
+    if (request->hasParam("from")) {
+        from = std::min<time_t>(strtoll(request->getParam("from")->value().c_str(), nullptr, 10), now);
+    }
+    if (request->hasParam("to")) {
+        to = std::min<time_t>(strtoll(request->getParam("to")->value().c_str(), nullptr, 10), now);
+    }
+
+    const uint32_t maxAge = now - from;
+    const uint32_t minAge = to < from ? maxAge : now - to;
+
+    TimeSeriesResolution resolution = TimeSeries.getResolutionForAge(maxAge);
+    if (request->hasParam("res")) {
+        const uint32_t interval = request->getParam("res")->value().toInt();
+        for (uint8_t i = 0; i < TimeSeries.getLevelCount(); i++) {
+            if (TimeSeries.getInterval(static_cast<TimeSeriesResolution>(i)) == interval) {
+                resolution = static_cast<TimeSeriesResolution>(i);
+            }
+        }
+    }
+
+    root["field"] = TimeSeries.getFieldName(field);
+    root["unit"] = TimeSeries.getFieldUnit(field);
+    root["interval"] = TimeSeries.getInterval(resolution);
+
+    // Samples are contiguous, so only the start time of the first one is required
+    auto values = root["values"].to<JsonArray>();
+    bool first = true;
+    TimeSeries.query(serial, field, resolution, maxAge, minAge, [&](const uint32_t age, const float value) {
+        if (first) {
+            root["start"] = now - age;
+            first = false;
+        }
+        if (std::isnan(value)) {
+            values.add(nullptr);
+        } else {
+            values.add(value);
+        }
+    });
+
+    WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+}
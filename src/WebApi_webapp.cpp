@@ -3,7 +3,6 @@
  * Copyright (C) 2022-2024 Thomas Basler and others
  */
 #include "WebApi_webapp.h"
-#include <MD5Builder.h>
 
 extern const uint8_t file_index_html_start[] asm("_binary_webapp_dist_index_html_gz_start");
 extern const uint8_t file_favicon_ico_start[] asm("_binary_webapp_dist_favicon_ico_start");
@@ -19,18 +18,16 @@ extern const uint8_t file_zones_json_end[] asm("_binary_webapp_dist_zones_json_g
 extern const uint8_t file_app_js_end[] asm("_binary_webapp_dist_js_app_js_gz_end");
 extern const uint8_t file_site_webmanifest_end[] asm("_binary_webapp_dist_site_webmanifest_end");
 
-void WebApiWebappClass::responseBinaryDataWithETagCache(AsyncWebServerRequest *request, const String &contentType, const String &contentEncoding, const uint8_t *content, size_t len)
-{
-    auto md5 = MD5Builder();
-    md5.begin();
-    md5.add(const_cast<uint8_t *>(content), len);
-    md5.calculate();
-
-    String expectedEtag;
-    expectedEtag = "\"";
-    expectedEtag += md5.toString();
-    expectedEtag += "\"";
+// The ETags are generated by pio-scripts/webapp_etags.py
+extern const char file_index_html_etag[] asm("_binary_webapp_dist_index_html_gz_etag");
+extern const char file_favicon_ico_etag[] asm("_binary_webapp_dist_favicon_ico_etag");
+extern const char file_favicon_png_etag[] asm("_binary_webapp_dist_favicon_png_etag");
+extern const char file_zones_json_etag[] asm("_binary_webapp_dist_zones_json_gz_etag");
+extern const char file_app_js_etag[] asm("_binary_webapp_dist_js_app_js_gz_etag");
+extern const char file_site_webmanifest_etag[] asm("_binary_webapp_dist_site_webmanifest_etag");
 
+void WebApiWebappClass::responseBinaryDataWithETagCache(AsyncWebServerRequest *request, const String &contentType, const String &contentEncoding, const uint8_t *content, size_t len, const char* expectedEtag)
+{
     bool eTagMatch = false;
     if (request->hasHeader("If-None-Match")) {
         const AsyncWebHeader* h = request->getHeader("If-None-Match");
@@ -63,34 +60,34 @@ void WebApiWebappClass::init(AsyncWebServer& server, Scheduler& scheduler)
     */
 
     server.on("/", HTTP_GET, [&](AsyncWebServerRequest* request) {
-        responseBinaryDataWithETagCache(request, "text/html", "gzip", file_index_html_start, file_index_html_end - file_index_html_start);
+        responseBinaryDataWithETagCache(request, "text/html", "gzip", file_index_html_start, file_index_html_end - file_index_html_start, file_index_html_etag);
     });
 
     server.onNotFound([&](AsyncWebServerRequest* request) {
-        responseBinaryDataWithETagCache(request, "text/html", "gzip", file_index_html_start, file_index_html_end - file_index_html_start);
+        responseBinaryDataWithETagCache(request, "text/html", "gzip", file_index_html_start, file_index_html_end - file_index_html_start, file_index_html_etag);
     });
 
     server.on("/index.html", HTTP_GET, [&](AsyncWebServerRequest* request) {
-        responseBinaryDataWithETagCache(request, "text/html", "gzip", file_index_html_start, file_index_html_end - file_index_html_start);
+        responseBinaryDataWithETagCache(request, "text/html", "gzip", file_index_html_start, file_index_html_end - file_index_html_start, file_index_html_etag);
     });
 
     server.on("/favicon.ico", HTTP_GET, [&](AsyncWebServerRequest* request) {
-        responseBinaryDataWithETagCache(request, "image/x-icon", "", file_favicon_ico_start, file_favicon_ico_end - file_favicon_ico_start);
+        responseBinaryDataWithETagCache(request, "image/x-icon", "", file_favicon_ico_start, file_favicon_ico_end - file_favicon_ico_start, file_favicon_ico_etag);
     });
 
     server.on("/favicon.png", HTTP_GET, [&](AsyncWebServerRequest* request) {
-        responseBinaryDataWithETagCache(request, "image/png", "", file_favicon_png_start, file_favicon_png_end - file_favicon_png_start);
+        responseBinaryDataWithETagCache(request, "image/png", "", file_favicon_png_start, file_favicon_png_end - file_favicon_png_start, file_favicon_png_etag);
     });
 
     server.on("/zones.json", HTTP_GET, [&](AsyncWebServerRequest* request) {
-        responseBinaryDataWithETagCache(request, "application/json", "gzip", file_zones_json_start, file_zones_json_end - file_zones_json_start);
+        responseBinaryDataWithETagCache(request, "application/json", "gzip", file_zones_json_start, file_zones_json_end - file_zones_json_start, file_zones_json_etag);
     });
 
     server.on("/site.webmanifest", HTTP_GET, [&](AsyncWebServerRequest* request) {
-        responseBinaryDataWithETagCache(request, "application/json", "", file_site_webmanifest_start, file_site_webmanifest_end - file_site_webmanifest_start);
+        responseBinaryDataWithETagCache(request, "application/json", "", file_site_webmanifest_start, file_site_webmanifest_end - file_site_webmanifest_start, file_site_webmanifest_etag);
     });
 
     server.on("/js/app.js", HTTP_GET, [&](AsyncWebServerRequest* request) {
-        responseBinaryDataWithETagCache(request, "text/javascript", "gzip", file_app_js_start, file_app_js_end - file_app_js_start);
+        responseBinaryDataWithETagCache(request, "text/javascript", "gzip", file_app_js_start, file_app_js_end - file_app_js_start, file_app_js_etag);
     });
 }
@@ -5,12 +5,13 @@
 #include "WebApi_ws_console.h"
 #include "Configuration.h"
 #include "MessageOutput.h"
+#include "TaskProfiler.h"
 #include "WebApi.h"
 #include "defaults.h"
 
 WebApiWsConsoleClass::WebApiWsConsoleClass()
     : _ws("/console")
-    , _wsCleanupTask(1 * TASK_SECOND, TASK_FOREVER, std::bind(&WebApiWsConsoleClass::wsCleanupTaskCb, this))
+    , _wsCleanupTask(1 * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("WsConsoleCleanup", std::bind(&WebApiWsConsoleClass::wsCleanupTaskCb, this)))
 {
 }
 
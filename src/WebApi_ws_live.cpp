@@ -5,15 +5,17 @@
 #include "WebApi_ws_live.h"
 #include "Datastore.h"
 #include "MessageOutput.h"
+#include "TaskProfiler.h"
 #include "Utils.h"
 #include "WebApi.h"
 #include "defaults.h"
 #include <AsyncJson.h>
+#include <HeapTaggedJsonAllocator.h>
 
 WebApiWsLiveClass::WebApiWsLiveClass()
     : _ws("/livedata")
-    , _wsCleanupTask(1 * TASK_SECOND, TASK_FOREVER, std::bind(&WebApiWsLiveClass::wsCleanupTaskCb, this))
-    , _sendDataTask(1 * TASK_SECOND, TASK_FOREVER, std::bind(&WebApiWsLiveClass::sendDataTaskCb, this))
+    , _wsCleanupTask(1 * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("WsLiveCleanup", std::bind(&WebApiWsLiveClass::wsCleanupTaskCb, this)))
+    , _sendDataTask(1 * TASK_SECOND, TASK_FOREVER, TaskProfiler.wrap("WsLiveSendData", std::bind(&WebApiWsLiveClass::sendDataTaskCb, this)))
 {
 }
 
@@ -86,7 +88,7 @@ void WebApiWsLiveClass::sendDataTaskCb()
 
         try {
             std::lock_guard<std::mutex> lock(_mutex);
-            JsonDocument root;
+            JsonDocument root(HeapTaggedJsonAllocator::get(HEAP_TAG_JSON));
             JsonVariant var = root;
 
             auto invArray = var["inverters"].to<JsonArray>();
@@ -100,8 +102,15 @@ void WebApiWsLiveClass::sendDataTaskCb()
                 continue;
             }
 
-            String buffer;
-            serializeJson(root, buffer);
+            // The message is shared by the queues of all clients and
+            // released by the web server once it was sent to every client
+            const size_t len = measureJson(root);
+            auto buffer = AsyncWebSocketSharedBuffer(new std::vector<uint8_t>(len), [len](std::vector<uint8_t>* message) {
+                HeapAccounting.remove(HEAP_TAG_WEBSOCKET, len);
+                delete message;
+            });
+            HeapAccounting.add(HEAP_TAG_WEBSOCKET, len);
+            serializeJson(root, buffer->data(), len);
 
             _ws.textAll(buffer);
 
@@ -125,6 +134,49 @@ void WebApiWsLiveClass::generateCommonJsonResponse(JsonVariant& root)
     hintObj["time_sync"] = !getLocalTime(&timeinfo, 5);
     hintObj["radio_problem"] = (Hoymiles.getRadioNrf()->isInitialized() && (!Hoymiles.getRadioNrf()->isConnected() || !Hoymiles.getRadioNrf()->isPVariant())) || (Hoymiles.getRadioCmt()->isInitialized() && (!Hoymiles.getRadioCmt()->isConnected()));
     hintObj["default_password"] = strcmp(Configuration.get().Security.Password, ACCESS_POINT_PASSWORD) == 0;
+
+    JsonObject radioObj = root["radio"].to<JsonObject>();
+    if (Hoymiles.getRadioNrf()->isInitialized()) {
+        JsonObject nrfObj = radioObj["nrf"].to<JsonObject>();
+        generateRadioJsonResponse(nrfObj, Hoymiles.getRadioNrf());
+    }
+    if (Hoymiles.getRadioCmt()->isInitialized()) {
+        JsonObject cmtObj = radioObj["cmt"].to<JsonObject>();
+        generateRadioJsonResponse(cmtObj, Hoymiles.getRadioCmt());
+    }
+}
+
+void WebApiWsLiveClass::generateRadioJsonResponse(JsonObject& root, HoymilesRadio* radio)
+{
+    root["tx_airtime"] = radio->getTxAirtime() / 1000; // ms
+    addHistogram(root["rx_latency"].to<JsonObject>(), radio->RxLatency);
+
+    JsonArray commands = root["commands"].to<JsonArray>();
+    for (uint8_t i = 0; i < radio->getCommandStatsCount(); i++) {
+        const auto& stats = radio->getCommandStats(i);
+        JsonObject command = commands.add<JsonObject>();
+        command["name"] = stats.Name;
+        addHistogram(command["complete_time"].to<JsonObject>(), stats.CompleteTime);
+        addHistogram(command["retransmits"].to<JsonObject>(), stats.Retransmits);
+    }
+}
+
+void WebApiWsLiveClass::addHistogram(JsonObject root, const Histogram& source)
+{
+    // The radio task keeps adding values while the response is generated
+    const Histogram histogram(source);
+
+    // The last bucket contains all values above the last bound
+    JsonArray bounds = root["bounds"].to<JsonArray>();
+    JsonArray buckets = root["buckets"].to<JsonArray>();
+    for (uint8_t i = 0; i <= histogram.getBoundCount(); i++) {
+        if (i < histogram.getBoundCount()) {
+            bounds.add(histogram.getBound(i));
+        }
+        buckets.add(histogram.getBucket(i));
+    }
+    root["count"] = histogram.getCount();
+    root["sum"] = histogram.getSum();
 }
 
 void WebApiWsLiveClass::generateInverterCommonJsonResponse(JsonObject& root, std::shared_ptr<InverterAbstract> inv)
@@ -138,6 +190,7 @@ void WebApiWsLiveClass::generateInverterCommonJsonResponse(JsonObject& root, std
     root["name"] = inv->name();
     root["order"] = inv_cfg->Order;
     root["data_age"] = (millis() - inv->Statistics()->getLastUpdate()) / 1000;
+    root["data_stale"] = inv->Statistics()->isStale() || inv->DevInfo()->isStale() || inv->GridProfile()->isStale();
     root["poll_enabled"] = inv->getEnablePolling();
     root["reachable"] = inv->isReachable();
     root["producing"] = inv->isProducing();
@@ -153,7 +206,24 @@ void WebApiWsLiveClass::generateInverterCommonJsonResponse(JsonObject& root, std
     root["radio_stats"]["rx_fail_nothing"] = inv->RadioStats.RxFailNoAnswer;
     root["radio_stats"]["rx_fail_partial"] = inv->RadioStats.RxFailPartialAnswer;
     root["radio_stats"]["rx_fail_corrupt"] = inv->RadioStats.RxFailCorruptData;
+    root["radio_stats"]["rx_complete_time"] = inv->RadioStats.RxCompleteTimeLast;
+    root["radio_stats"]["rx_complete_time_avg"] = inv->RadioStats.RxSuccess > 0 ? inv->RadioStats.RxCompleteTimeSum / inv->RadioStats.RxSuccess : 0;
     root["radio_stats"]["rssi"] = inv->getLastRssi();
+
+    JsonArray channels = root["radio_stats"]["channels"].to<JsonArray>();
+    for (auto& stats : inv->RadioChannelStats) {
+        if (stats.Channel == 0) {
+            continue;
+        }
+        JsonObject channel = channels.add<JsonObject>();
+        channel["channel"] = stats.Channel;
+        channel["rx_fragments"] = stats.RxFragments;
+        channel["rx_crc_errors"] = stats.RxCrcErrors;
+        channel["rssi"] = stats.LastRssi;
+        channel["score"] = stats.Score;
+    }
+
+    addHistogram(root["radio_stats"]["rssi_histogram"].to<JsonObject>(), inv->RssiHistogram);
 }
 
 void WebApiWsLiveClass::generateInverterChannelJsonResponse(JsonObject& root, std::shared_ptr<InverterAbstract> inv)
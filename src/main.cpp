@@ -5,7 +5,10 @@
 #include "Configuration.h"
 #include "Datastore.h"
 #include "Display_Graphic.h"
+#include "EnergyLog.h"
+#include "HeapMonitor.h"
 #include "I18n.h"
+#include "InverterPersistence.h"
 #include "InverterSettings.h"
 #include "Led_Single.h"
 #include "MessageOutput.h"
@@ -21,7 +24,10 @@
 #include "PinMapping.h"
 #include "RestartHelper.h"
 #include "Scheduler.h"
+#include "StallDetector.h"
 #include "SunPosition.h"
+#include "TaskProfiler.h"
+#include "TimeSeries.h"
 #include "Utils.h"
 #include "WebApi.h"
 #include "defaults.h"
@@ -36,6 +42,10 @@ void setup()
     // Move all dynamic allocations >512byte to psram (if available)
     heap_caps_malloc_extmem_enable(512);
 
+    // Start measuring the runtime of all scheduler tasks
+    TaskProfiler.init(scheduler);
+    StallDetector.init();
+
     // Initialize SpiManager
     SpiManagerInst.register_bus(SPI2_HOST);
 #if SOC_SPI_PERIPH_NUM > 2
@@ -157,12 +167,17 @@ void setup()
     MessageOutput.println("done");
 
     InverterSettings.init(scheduler);
+    InverterPersistence.init(scheduler);
 
     Datastore.init(scheduler);
+    HeapMonitor.init(scheduler);
+    EnergyLog.init(scheduler);
+    TimeSeries.init(scheduler);
     RestartHelper.init(scheduler);
 }
 
 void loop()
 {
+    StallDetector.beginIteration();
     scheduler.execute();
 }
@@ -0,0 +1,448 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+# Generates the payload corpus for every inverter class and response type.
+#
+# The payloads are encoded from the byte assignment tables and parser tables
+# of lib/Hoymiles so the layout always matches the firmware. Every response is
+# split into radio fragments exactly like an inverter sends them (header,
+# fragment id, CRC8) and written in the format of the RX dump of the serial
+# console. The expected values are calculated independently of the C++ code.
+#
+# invalid/ contains damaged or incomplete responses. Files in recorded/ are
+# real captures which are maintained by hand and not touched.
+#
+# Usage: ./generate.py   (run from any directory)
+
+import os
+import random
+import re
+
+CORPUS_DIR = os.path.dirname(os.path.abspath(__file__))
+LIB_DIR = os.path.join(CORPUS_DIR, "..", "..", "..", "lib", "Hoymiles", "src")
+
+DTU_SERIAL = 0x199912345678
+
+# Inverter class, serial, byte assignment source, hardware part number
+INVERTERS = [
+    ("HM_1CH", 0x112112345678, "HM_1CH", (0x10, 0x10, 0x40, 0x01)),
+    ("HM_2CH", 0x114112345678, "HM_2CH", (0x10, 0x11, 0x30, 0x01)),
+    ("HM_4CH", 0x116112345678, "HM_4CH", (0x10, 0x12, 0x30, 0x01)),
+    ("HMS_1CH", 0x112412345678, "HMS_1CH", (0x10, 0x20, 0x41, 0x01)),
+    ("HMS_1CHv2", 0x112512345678, "HMS_1CHv2", (0x10, 0x20, 0x71, 0x01)),
+    ("HMS_2CH", 0x114412345678, "HMS_2CH", (0x10, 0x21, 0x41, 0x01)),
+    ("HMS_4CH", 0x116412345678, "HMS_4CH", (0x10, 0x22, 0x71, 0x01)),
+    ("HMT_4CH", 0x136112345678, "HMT_4CH", (0x10, 0x32, 0x71, 0x01)),
+    ("HMT_6CH", 0x138212345678, "HMT_6CH", (0x10, 0x33, 0x31, 0x01)),
+    ("HERF_1CH", 0x284112345678, "HERF_1CH", (0xF1, 0x01, 0x10, 0x01)),
+    ("HERF_2CH", 0x282112345678, "HERF_2CH", (0xF1, 0x01, 0x14, 0x01)),
+    ("HERF_4CH", 0x280112345678, "HM_4CH", (0xF1, 0x01, 0x24, 0x01)),
+]
+
+# Plausible physical range of every field
+FIELD_RANGES = {
+    "UDC": (20, 48), "IDC": (0, 12), "PDC": (0, 450), "YD": (0, 3500), "YT": (0, 2500),
+    "UAC": (220, 245), "IAC": (0, 8), "PAC": (0, 2000), "F": (49.9, 50.1), "T": (-15, 65),
+    "PF": (0.9, 1.0), "Q": (-60, 60), "EVT_LOG": (0, 60),
+    "UAC_1N": (220, 245), "UAC_2N": (220, 245), "UAC_3N": (220, 245),
+    "UAC_12": (385, 420), "UAC_23": (385, 420), "UAC_31": (385, 420),
+    "IAC_1": (0, 3), "IAC_2": (0, 3), "IAC_3": (0, 3),
+}
+
+
+def crc8(data):
+    crc = 0
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x01) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def be(value, size):
+    return list((value & ((1 << (8 * size)) - 1)).to_bytes(size, "big"))
+
+
+def fragments(serial, payload):
+    """Appends the CRC16 and splits the payload into radio packets"""
+    crc = crc16(payload)
+    data = payload + [crc >> 8, crc & 0xFF]
+
+    chunks = []
+    while len(data) > 21:
+        chunks.append(data[:16])
+        data = data[16:]
+    chunks.append(data)
+
+    packets = []
+    for i, chunk in enumerate(chunks):
+        frag_id = i + 1
+        if i == len(chunks) - 1:
+            frag_id |= 0x80
+        packet = [0x95] + be(serial, 4) + be(DTU_SERIAL, 4) + [frag_id] + chunk
+        packets.append(packet + [crc8(packet)])
+    return packets
+
+
+def fmt(value):
+    text = ("%.6f" % value).rstrip("0").rstrip(".")
+    return "0" if text == "-0" else text
+
+
+def rng(*key):
+    return random.Random("/".join(str(k) for k in key))
+
+
+def read(path):
+    with open(os.path.join(LIB_DIR, path), encoding="utf-8") as f:
+        return f.read()
+
+
+def parse_byte_assignment(source):
+    text = read("inverters/%s.cpp" % source)
+    entries = []
+    for m in re.finditer(r"\{\s*TYPE_(\w+),\s*CH(\d),\s*FLD_(\w+),\s*UNIT_\w+,\s*(\w+),\s*(\w+),\s*(\w+),\s*(true|false),\s*\d+\s*\}", text):
+        typ, ch, fld, start, num, div, signed = m.groups()
+        entries.append({
+            "type": typ, "ch": int(ch), "field": fld,
+            "calc": div == "CMD_CALC",
+            "start": start if div == "CMD_CALC" else int(start),
+            "num": num if div == "CMD_CALC" else int(num),
+            "div": None if div == "CMD_CALC" else int(div),
+            "signed": signed == "true",
+        })
+    if not entries:
+        raise RuntimeError("No byte assignment found in " + source)
+    return entries
+
+
+def parse_alarm_messages():
+    text = read("parser/AlarmLogParser.cpp")
+    messages = {}
+    for m in re.finditer(r"alarmMessageKey\(AlarmMessageType_t::(\w+), (\d+)\), \{ \"([^\"]*)\"", text):
+        messages[(m.group(1), int(m.group(2)))] = m.group(3)
+    return messages
+
+
+def parse_grid_profile():
+    text = read("parser/GridProfileParser.cpp")
+    types = [(int(a, 16), int(b, 16), name) for a, b, name in
+             re.findall(r"\{ (0x[0-9a-f]{2}), (0x[0-9a-f]{2}), \"([^\"]+)\" \}", text)]
+    sections = {int(a, 16): name for a, name in re.findall(r"\{ (0x[0-9a-f]{2}), \"([^\"]+)\" \}", text)}
+    items = {int(a, 16): (name, unit, int(div)) for a, name, unit, div in
+             re.findall(r"\{ (0x[0-9a-f]{2}), make_value\(\"([^\"]+)\", \"([^\"]*)\", (\d+)\) \}", text)}
+    values = {}
+    body = text[text.index("profileValues = {"):]
+    body = body[:body.index("} };")]
+    for sec, ver, item in re.findall(r"\{ (0x[0-9a-f]{2}), (0x[0-9a-f]{2}), (0x[0-9a-f]{2}) \}", body):
+        values.setdefault((int(sec, 16), int(ver, 16)), []).append(int(item, 16))
+    return types, sections, items, values
+
+
+def parse_devinfo():
+    text = read("parser/DevInfoParser.cpp")
+    models = []
+    for parts, power, name in re.findall(r"\{ \{ ([^}]+) \}, ([^,]+), \"([^\"]+)\" \}", text):
+        hw = [0xFF if p.strip() == "ALL" else int(p, 16) for p in parts.split(",")]
+        models.append((hw, power, name))
+    return models
+
+
+class Writer:
+    def __init__(self, inv, serial, command, description, name=None):
+        self.lines = ["# " + line for line in description.splitlines()]
+        self.lines.append("# Generated by generate.py, do not edit")
+        self.lines.append("serial %012X" % serial)
+        self.lines.append("command " + command)
+        self.serial = serial
+        self.path = os.path.join(CORPUS_DIR, inv, (name or command) + ".txt")
+
+    def payload(self, payload):
+        self.packets(fragments(self.serial, payload), "OK")
+
+    def packets(self, packets, result):
+        for p in packets:
+            self.lines.append("rx " + " ".join("%02X" % b for b in p))
+        self.lines.append("result " + result)
+
+    def expect(self, key, value):
+        self.lines.append("expect %s %s" % (key, value))
+
+    def write(self):
+        os.makedirs(os.path.dirname(self.path), exist_ok=True)
+        with open(self.path, "w", encoding="utf-8") as f:
+            f.write("\n".join(self.lines) + "\n")
+
+
+def real_time_run_data(inv, serial, source):
+    assignment = parse_byte_assignment(source)
+    size = max(a["start"] + a["num"] for a in assignment if not a["calc"])
+    payload = [0] * size
+    payload[0:2] = [0x00, 0x01]
+    raw = {}
+
+    values = {}
+    for a in assignment:
+        if a["calc"]:
+            continue
+        key = (a["start"], a["num"])
+        if key not in raw:
+            lo, hi = FIELD_RANGES[a["field"]]
+            r = rng(inv, a["type"], a["ch"], a["field"])
+            value = r.uniform(lo, hi)
+            raw_value = int(round(value * a["div"]))
+            raw_value = max(min(raw_value, (1 << (8 * a["num"] - a["signed"])) - 1), 0 if not a["signed"] else -(1 << (8 * a["num"] - 1)))
+            raw[key] = raw_value
+            payload[a["start"]:a["start"] + a["num"]] = be(raw_value, a["num"])
+        values[(a["type"], a["ch"], a["field"])] = raw[key] / a["div"]
+
+    def channels(typ):
+        return sorted({a["ch"] for a in assignment if a["type"] == typ})
+
+    def total(typ, field):
+        return sum(values.get((typ, c, field), 0) for c in channels(typ))
+
+    for a in assignment:
+        if not a["calc"]:
+            continue
+        func = a["start"]
+        if func == "CALC_TOTAL_YT":
+            v = total("DC", "YT")
+        elif func == "CALC_TOTAL_YD":
+            v = total("DC", "YD")
+        elif func == "CALC_CH_UDC":
+            v = values[("DC", int(a["num"].replace("CH", "")), "UDC")]
+        elif func == "CALC_TOTAL_PDC":
+            v = total("DC", "PDC")
+        elif func == "CALC_TOTAL_EFF":
+            dc = total("DC", "PDC")
+            v = total("AC", "PAC") / dc * 100 if dc > 0 else 0
+        elif func == "CALC_CH_IRR":
+            v = 0  # No string max power configured
+        elif func == "CALC_TOTAL_IAC":
+            v = sum(values[("AC", 0, f)] for f in ("IAC_1", "IAC_2", "IAC_3"))
+        else:
+            raise RuntimeError("Unknown calculation " + func)
+        values[(a["type"], a["ch"], a["field"])] = v
+
+    w = Writer(inv, serial, "RealTimeRunData", "Live data of all channels, %d bytes plus CRC16" % size)
+    w.payload(payload)
+    w.expect("stat.bytes", size + 2)
+    for typ in ("AC", "DC", "INV"):
+        w.expect("stat.channels.%s" % typ, len(channels(typ)))
+    for a in assignment:
+        w.expect("stat.%s.%d.%s" % (a["type"], a["ch"], a["field"]), fmt(values[(a["type"], a["ch"], a["field"])]))
+    w.write()
+
+
+def alarm_data(inv, serial, messages):
+    message_type = "HMT" if inv.startswith("HMT") else "ALL"
+    # Only the low byte of the wcode is the message id
+    ids = sorted({i for t, i in messages if t == "ALL" and i <= 0xFF})
+    r = rng(inv, "alarm")
+    count = r.randint(1, 6)
+
+    payload = [0x00, 0x01]
+    w = Writer(inv, serial, "AlarmData", "Event log with %d entries" % count)
+    entries = []
+    for n in range(count):
+        msg_id = r.choice(ids)
+        start = r.randint(0, 43199)
+        end = r.choice([0, min(start + r.randint(1, 3600), 43199)])
+        pm_start = r.random() < 0.5
+        pm_end = end > 0 and (pm_start or r.random() < 0.5)
+        wcode = msg_id | (0x2000 if pm_start else 0) | (0x1000 if pm_end else 0)
+        payload += be(wcode, 2) + be(n + 1, 2) + be(start, 2) + be(end, 2) + [0, 0, 0, 0]
+        entries.append((msg_id, start + (43200 if pm_start else 0), end + (43200 if pm_end else 0) if end > 0 else 0,
+                        messages.get((message_type, msg_id), messages[("ALL", msg_id)])))
+
+    w.payload(payload)
+    w.expect("alarm.count", count)
+    for n, (msg_id, start, end, text) in enumerate(entries):
+        w.expect("alarm.%d.id" % n, msg_id)
+        w.expect("alarm.%d.start" % n, start)
+        w.expect("alarm.%d.end" % n, end)
+        w.expect("alarm.%d.message" % n, text)
+    w.write()
+
+
+def dev_info(inv, serial, hw_part, models):
+    r = rng(inv, "devinfo")
+    fw = r.randint(10000, 10099)
+    year = r.randint(2019, 2024)
+    month, day = r.randint(1, 12), r.randint(1, 28)
+    hour, minute = r.randint(0, 23), r.randint(0, 59)
+    bootloader = r.randint(1, 9)
+
+    w = Writer(inv, serial, "DevInfoAll", "Firmware version and build date")
+    w.payload(be(fw, 2) + be(year, 2) + be(month * 100 + day, 2) + be(hour * 100 + minute, 2) + be(bootloader, 2) + [0, 0, 0, 0])
+    w.expect("devinfo.fw_version", fw)
+    w.expect("devinfo.fw_build", "%04d-%02d-%02d %02d:%02d:00" % (year, month, day, hour, minute))
+    w.expect("devinfo.bootloader", bootloader)
+    w.write()
+
+    hw_major, hw_minor = r.randint(0, 2), r.randint(0, 20)
+    name, power = "", 0
+    for exact in (True, False):
+        for parts, max_power, model in models:
+            if list(hw_part[:3]) == parts[:3] and (not exact or hw_part[3] == parts[3]):
+                name, power = model, int(eval(max_power.replace("static_cast<uint16_t>", "int")))
+                break
+        if name:
+            break
+
+    w = Writer(inv, serial, "DevInfoSimple", "Hardware part number and version" + ("" if name else ", model unknown to the firmware"))
+    w.payload(be(fw, 2) + list(hw_part) + [hw_major, hw_minor] + [0x00, 0x20, 0x01, 0x00, 0x00, 0x00])
+    w.expect("devinfo.hw_part", "%08X" % int.from_bytes(bytes(hw_part), "big"))
+    w.expect("devinfo.hw_version", "%02d.%02d" % (hw_major, hw_minor))
+    w.expect("devinfo.model", name if name else "-")
+    w.expect("devinfo.max_power", power)
+    w.write()
+
+
+def grid_profile(inv, serial, index, tables):
+    types, sections, items, values = tables
+    l_idx, h_idx, name = types[index % len(types)]
+    r = rng(inv, "gridprofile")
+    major, patch = r.randint(0x10, 0x3F), r.randint(0, 9)
+
+    payload = [l_idx, h_idx, major, patch]
+    lines = []
+    for sec in sorted(sections):
+        versions = sorted(v for s, v in values if s == sec)
+        if not versions:
+            continue
+        ver = r.choice(versions)
+        section = [sec, ver]
+        section_lines = []
+        for item in values[(sec, ver)]:
+            item_name, unit, div = items[item]
+            raw = r.randint(-300 if unit == "%" else 0, 3000)
+            section += be(raw, 2)
+            section_lines.append([raw, div])
+        # Stay below GRID_PROFILE_SIZE including the CRC16
+        if len(payload) + len(section) + 2 > 141:
+            continue
+        payload += section
+        lines.append((sections[sec], section_lines))
+
+    # The CRC16 must not look like a further section to the parser
+    crc = crc16(payload)
+    if (crc >> 8) in sections and ((crc >> 8), crc & 0xFF) in values:
+        payload[-1] ^= 0x01
+        lines[-1][1][-1][0] ^= 0x01
+
+    w = Writer(inv, serial, "GridOnProFilePara", "Grid profile %s with %d sections" % (name, len(lines)))
+    w.payload(payload)
+    w.expect("gridprofile.name", name)
+    w.expect("gridprofile.version", "%d.%d.%d" % (major >> 4, major & 0x0F, patch))
+    w.expect("gridprofile.sections", len(lines))
+    w.expect("gridprofile.items", sum(len(s[1]) for s in lines))
+    n = 0
+    for _, section_lines in lines:
+        for raw, div in section_lines:
+            w.expect("gridprofile.item.%d" % n, fmt(raw / div))
+            n += 1
+    w.write()
+
+
+def system_config_para(inv, serial):
+    limit = rng(inv, "limit").randint(20, 1000)
+    w = Writer(inv, serial, "SystemConfigPara", "Active power limit of %.1f %%" % (limit / 10))
+    w.payload([0x00, 0x01] + be(limit, 2) + [0x00, 0x00, 0x03, 0xE8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00])
+    w.expect("limit.percent", fmt(limit / 10))
+    w.write()
+
+
+def invalid(name, description, serial, command, packets, result, expectations=()):
+    w = Writer("invalid", serial, command, description, name)
+    w.packets(packets, result)
+    for key, value in expectations:
+        w.expect(key, value)
+    w.write()
+
+
+def invalid_cases():
+    serial = INVERTERS[1][1]
+    payload = [(i * 37 + 11) & 0xFF for i in range(42)]
+    packets = fragments(serial, payload)
+
+    def resign(packet):
+        return packet[:-1] + [crc8(packet[:-1])]
+
+    damaged = [list(p) for p in packets]
+    damaged[1][12] ^= 0x40
+    invalid("crc16_error", "One payload byte changed after the CRC16 was calculated",
+            serial, "RealTimeRunData", [resign(p) for p in damaged], "HANDLE_ERROR")
+
+    invalid("missing_middle", "The second of three fragments was not received",
+            serial, "RealTimeRunData", [packets[0], packets[2]], "RETRANSMIT", [("fragments.missing", "0002")])
+
+    invalid("missing_last", "The fragment with the end marker was not received",
+            serial, "RealTimeRunData", packets[:2], "RETRANSMIT", [("fragments.missing", "0004")])
+
+    invalid("all_missing", "Nothing was received", serial, "RealTimeRunData", [], "ALL_MISSING_RESEND")
+
+    invalid("duplicate_fragment", "A retransmitted fragment arrives twice",
+            serial, "RealTimeRunData", [packets[0], packets[1], packets[1], packets[2]], "OK", [("stat.bytes", 44)])
+
+    invalid("reordered_fragments", "Fragments arrive in reverse order",
+            serial, "RealTimeRunData", list(reversed(packets)), "OK", [("stat.bytes", 44)])
+
+    invalid("too_short", "Valid CRC16 but less data than the byte assignment requires",
+            serial, "RealTimeRunData", fragments(serial, payload[:30]), "HANDLE_ERROR")
+
+    wrong_cmd = [resign([0x96] + p[1:-1] + [0]) for p in packets]
+    invalid("wrong_main_command", "Response to a different main command",
+            serial, "RealTimeRunData", wrong_cmd, "HANDLE_ERROR")
+
+    oversized = resign(packets[0][:-1] + [0x00] * 6 + [0])
+    invalid("oversized_fragment", "The first fragment carries more than 16 data bytes and is dropped",
+            serial, "RealTimeRunData", [oversized] + packets[1:], "RETRANSMIT", [("fragments.missing", "0001")])
+
+    zero_id = resign(packets[0][:9] + [0x00] + packets[0][10:])
+    invalid("fragment_id_zero", "A fragment with id zero is ignored",
+            serial, "RealTimeRunData", [zero_id] + packets[1:], "RETRANSMIT", [("fragments.missing", "0001")])
+
+    invalid("truncated_packet", "A packet shorter than the header is ignored",
+            serial, "RealTimeRunData", [packets[0][:10]] + packets[1:], "RETRANSMIT", [("fragments.missing", "0001")])
+
+    alarm = [0x00, 0x01] + [0x00, 0x01, 0x00, 0x01, 0x10, 0x00, 0x00, 0x00, 0, 0, 0, 0] + [0x00, 0x02, 0x00, 0x02, 0x20]
+    invalid("alarm_partial_entry", "Event log with one complete and one truncated entry",
+            serial, "AlarmData", fragments(serial, alarm), "OK",
+            [("alarm.count", 1), ("alarm.0.id", 1), ("alarm.0.start", 4096), ("alarm.0.end", 0)])
+
+    invalid("alarm_empty", "Event log without entries", serial, "AlarmData", fragments(serial, [0x00, 0x01]), "OK",
+            [("alarm.count", 0)])
+
+    profile = [0x03, 0x00, 0x38, 0x09] + [0x00, 0x00] + [0x09, 0x00] * 80
+    invalid("gridprofile_oversized", "Grid profile larger than the parser buffer is dropped",
+            serial, "GridOnProFilePara", fragments(serial, profile[:154]), "OK", [("gridprofile.bytes", 0)])
+
+
+def main():
+    messages = parse_alarm_messages()
+    tables = parse_grid_profile()
+    models = parse_devinfo()
+
+    for index, (inv, serial, source, hw_part) in enumerate(INVERTERS):
+        real_time_run_data(inv, serial, source)
+        alarm_data(inv, serial, messages)
+        dev_info(inv, serial, hw_part, models)
+        grid_profile(inv, serial, index, tables)
+        system_config_para(inv, serial)
+
+    invalid_cases()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Measures the table driven CRC functions against the bit wise reference
+ * implementations for the buffer sizes used by the radios: a single RF
+ * fragment (crc8 over 27 bytes), a reassembled payload (crc16 over 150
+ * bytes) and an NRF24 packet with its 9 bit packet control field
+ * (crc16nrf24 over 225 bits). A range with an unaligned start is measured
+ * as well.
+ *
+ * Usage: crc_benchmark [--min-time ms]
+ *
+ * The host numbers are only useful to compare changes against each other.
+ */
+#include "CrcReference.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+
+namespace {
+volatile uint32_t sink;
+
+// Runs func until minTime has passed and returns the ns per call
+double measure(const std::function<uint32_t()>& func, const double minTimeMs)
+{
+    using clock = std::chrono::steady_clock;
+
+    sink = func(); // Warm up
+    uint64_t iterations = 0;
+    uint64_t batch = 1;
+    const auto start = clock::now();
+    double elapsedNs = 0;
+    do {
+        for (uint64_t i = 0; i < batch; i++) {
+            sink = func();
+        }
+        iterations += batch;
+        batch *= 2;
+        elapsedNs = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    } while (elapsedNs < minTimeMs * 1e6);
+
+    return elapsedNs / iterations;
+}
+
+void report(const char* name, const double referenceNs, const double tableNs)
+{
+    printf("%-28s %12.1f %12.1f %8.1fx\n", name, referenceNs, tableNs, referenceNs / tableNs);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    double minTimeMs = 100;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minTimeMs = atof(argv[++i]);
+        } else {
+            printf("Usage: %s [--min-time ms]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint8_t buf[256];
+    std::mt19937 rng(1);
+    for (auto& b : buf) {
+        b = rng();
+    }
+
+    printf("%-28s %12s %12s %9s\n", "function", "bitwise ns", "table ns", "speedup");
+
+    report("crc8 27 bytes",
+        measure([&buf]() { return CrcReference::crc8(buf, 27); }, minTimeMs),
+        measure([&buf]() { return crc8(buf, 27); }, minTimeMs));
+
+    report("crc16 150 bytes",
+        measure([&buf]() { return CrcReference::crc16(buf, 150); }, minTimeMs),
+        measure([&buf]() { return crc16(buf, 150); }, minTimeMs));
+
+    report("crc16nrf24 9 + 216 bits",
+        measure([&buf]() { return CrcReference::crc16nrf24(buf, 9 + 27 * 8); }, minTimeMs),
+        measure([&buf]() { return crc16nrf24(buf, 9 + 27 * 8); }, minTimeMs));
+
+    report("crc16nrf24 bits 3-250",
+        measure([&buf]() { return CrcReference::crc16nrf24(buf, 250, 3); }, minTimeMs),
+        measure([&buf]() { return crc16nrf24(buf, 250, 3); }, minTimeMs));
+
+    return 0;
+}
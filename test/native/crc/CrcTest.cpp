@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Compares crc8(), crc16() and crc16nrf24() with the bit wise reference
+ * implementations for random buffers, lengths, start values and bit ranges.
+ * Known check values of the standard CRCs are verified as well.
+ *
+ * Usage: crc_test [--iterations n] [--seed s]
+ */
+#include "CrcReference.h"
+#include <algorithm>
+#include <crc.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+uint32_t failures = 0;
+
+void check(const char* name, const uint32_t iteration, const uint32_t expected, const uint32_t actual)
+{
+    if (expected == actual) {
+        return;
+    }
+    if (failures++ < 10) {
+        printf("%s: iteration %u: expected %04x, got %04x\n", name, iteration, expected, actual);
+    }
+}
+
+void checkKnownValues()
+{
+    const uint8_t text[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+    // CRC-16/MODBUS and CRC-16/CCITT-FALSE of "123456789"
+    check("crc16 check value", 0, 0x4b37, crc16(text, sizeof(text)));
+    check("crc16nrf24 check value", 0, 0x29b1, crc16nrf24(text, sizeof(text) * 8));
+
+    // Empty ranges return the start value
+    check("crc8 empty", 0, CRC8_INIT, crc8(text, 0));
+    check("crc16 empty", 0, 0x1234, crc16(text, 0, 0x1234));
+    check("crc16nrf24 empty", 0, 0x1234, crc16nrf24(text, 20, 20, 0x1234));
+}
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t iterations = 200000;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 0);
+        } else {
+            printf("Usage: %s [--iterations n] [--seed s]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    checkKnownValues();
+
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> buf(256 + 1);
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (auto& b : buf) {
+            b = rng();
+        }
+
+        // Mostly short lengths like the radio payloads, sometimes up to the maximum
+        const uint8_t len = (i & 7) ? rng() % 64 : rng() % 256;
+        const uint16_t start = rng();
+
+        check("crc8", i, CrcReference::crc8(buf.data(), len), crc8(buf.data(), len));
+        check("crc16", i, CrcReference::crc16(buf.data(), len, start), crc16(buf.data(), len, start));
+
+        // Any bit range within the buffer, including ranges within a single byte
+        const uint16_t lenBits = rng() % (len * 8 + 1);
+        const uint16_t startBit = (i & 3) ? rng() % (lenBits + 1) : lenBits - rng() % (std::min<uint16_t>(lenBits, 12) + 1);
+        check("crc16nrf24", i, CrcReference::crc16nrf24(buf.data(), lenBits, startBit, start), crc16nrf24(buf.data(), lenBits, startBit, start));
+    }
+
+    if (failures > 0) {
+        printf("%u mismatches\n", failures);
+        return 1;
+    }
+
+    printf("%u random buffers identical to the reference implementation\n", iterations);
+    return 0;
+}
@@ -0,0 +1,506 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "Corpus.h"
+#include <Arduino.h>
+#include <Hoymiles.h>
+#include <algorithm>
+#include <array>
+#include <commands/AlarmDataCommand.h>
+#include <commands/DevInfoAllCommand.h>
+#include <commands/DevInfoSimpleCommand.h>
+#include <commands/GridOnProFilePara.h>
+#include <commands/RealTimeRunDataCommand.h>
+#include <commands/SystemConfigParaCommand.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+class NullPrint : public Print {
+public:
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t*, size_t size) override { return size; }
+};
+
+NullPrint nullOutput;
+bool initialized = false;
+volatile float sink;
+
+// Same order as FieldId_t
+constexpr std::array<const char*, 24> fieldNames = {
+    "UDC", "IDC", "PDC", "YD", "YT", "UAC", "IAC", "PAC", "F", "T", "PF", "EFF", "IRR", "Q", "EVT_LOG",
+    "UAC_1N", "UAC_2N", "UAC_3N", "UAC_12", "UAC_23", "UAC_31", "IAC_1", "IAC_2", "IAC_3"
+};
+
+void initHoymiles()
+{
+    if (!initialized) {
+        Hoymiles.init();
+        Hoymiles.setMessageOutput(&nullOutput);
+        initialized = true;
+    }
+}
+
+std::vector<std::string> split(const std::string& str, const char delimiter)
+{
+    std::vector<std::string> parts;
+    std::stringstream stream(str);
+    std::string part;
+    while (std::getline(stream, part, delimiter)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+bool parseNumber(const std::string& str, double& value)
+{
+    if (str.empty()) {
+        return false;
+    }
+    char* end;
+    value = strtod(str.c_str(), &end);
+    return *end == '\0';
+}
+
+std::string formatFloat(const float value)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.6f", value);
+    return buf;
+}
+
+int findIndex(const char* const* names, const size_t count, const std::string& name)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (name == names[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool readStatistics(InverterAbstract& inv, const std::vector<std::string>& key, std::string& value)
+{
+    StatisticsParser* stat = inv.Statistics();
+
+    if (key.size() == 2 && key[1] == "bytes") {
+        value = std::to_string(stat->getRawData().size());
+        return true;
+    }
+
+    if (key.size() == 3 && key[1] == "channels") {
+        const int type = findIndex(channelsTypes, 3, key[2]);
+        if (type < 0) {
+            return false;
+        }
+        value = std::to_string(stat->getChannelsByType(static_cast<ChannelType_t>(type)).size());
+        return true;
+    }
+
+    if (key.size() != 4) {
+        return false;
+    }
+
+    const int type = findIndex(channelsTypes, 3, key[1]);
+    const int channel = atoi(key[2].c_str());
+    const int field = findIndex(fieldNames.data(), fieldNames.size(), key[3]);
+    if (type < 0 || channel < CH0 || channel >= CH_CNT || field < 0) {
+        return false;
+    }
+
+    const auto t = static_cast<ChannelType_t>(type);
+    const auto c = static_cast<ChannelNum_t>(channel);
+    const auto f = static_cast<FieldId_t>(field);
+    if (!stat->hasChannelFieldValue(t, c, f)) {
+        value = "missing";
+        return true;
+    }
+    value = formatFloat(stat->getChannelFieldValue(t, c, f));
+    return true;
+}
+
+bool readAlarm(InverterAbstract& inv, const std::vector<std::string>& key, std::string& value)
+{
+    AlarmLogParser* log = inv.EventLog();
+
+    if (key.size() == 2 && key[1] == "count") {
+        value = std::to_string(log->getEntryCount());
+        return true;
+    }
+
+    if (key.size() != 3) {
+        return false;
+    }
+
+    AlarmLogEntry_t entry;
+    log->getLogEntry(atoi(key[1].c_str()), entry, 0);
+
+    if (key[2] == "id") {
+        value = std::to_string(entry.MessageId);
+    } else if (key[2] == "start") {
+        value = std::to_string(entry.StartTime);
+    } else if (key[2] == "end") {
+        value = std::to_string(entry.EndTime);
+    } else if (key[2] == "message") {
+        value = entry.Message;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool readDevInfo(InverterAbstract& inv, const std::vector<std::string>& key, std::string& value)
+{
+    DevInfoParser* info = inv.DevInfo();
+    if (key.size() != 2) {
+        return false;
+    }
+
+    if (key[1] == "fw_version") {
+        value = std::to_string(info->getFwBuildVersion());
+    } else if (key[1] == "fw_build") {
+        value = info->getFwBuildDateTimeStr().c_str();
+    } else if (key[1] == "bootloader") {
+        value = std::to_string(info->getFwBootloaderVersion());
+    } else if (key[1] == "hw_part") {
+        char buf[12];
+        snprintf(buf, sizeof(buf), "%08" PRIX32, info->getHwPartNumber());
+        value = buf;
+    } else if (key[1] == "hw_version") {
+        value = info->getHwVersion().c_str();
+    } else if (key[1] == "model") {
+        value = info->getHwModelName().c_str();
+        if (value.empty()) {
+            value = "-";
+        }
+    } else if (key[1] == "max_power") {
+        value = std::to_string(info->getMaxPower());
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool readGridProfile(InverterAbstract& inv, const std::vector<std::string>& key, std::string& value)
+{
+    GridProfileParser* profile = inv.GridProfile();
+
+    if (key.size() == 2 && key[1] == "name") {
+        value = profile->getProfileName().c_str();
+        return true;
+    }
+    if (key.size() == 2 && key[1] == "version") {
+        value = profile->getProfileVersion().c_str();
+        return true;
+    }
+    if (key.size() == 2 && key[1] == "bytes") {
+        value = std::to_string(profile->getRawData().size());
+        return true;
+    }
+
+    std::vector<float> items;
+    size_t sections = 0;
+    profile->visitProfile(
+        [&sections](const char*) { sections++; },
+        [&items](const char*, const char*, const float v) { items.push_back(v); });
+
+    if (key.size() == 2 && key[1] == "sections") {
+        value = std::to_string(sections);
+        return true;
+    }
+    if (key.size() == 2 && key[1] == "items") {
+        value = std::to_string(items.size());
+        return true;
+    }
+    if (key.size() == 3 && key[1] == "item") {
+        const size_t index = atoi(key[2].c_str());
+        value = index < items.size() ? formatFloat(items[index]) : "missing";
+        return true;
+    }
+    return false;
+}
+}
+
+namespace Corpus {
+CorpusEntry loadFile(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Unable to open " + path);
+    }
+
+    CorpusEntry entry;
+    entry.File = path;
+
+    std::string line;
+    unsigned lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        const size_t sep = line.find(' ');
+        const std::string keyword = line.substr(0, sep);
+        const std::string arg = sep == std::string::npos ? "" : line.substr(sep + 1);
+
+        if (keyword == "serial") {
+            entry.Serial = strtoull(arg.c_str(), nullptr, 16);
+        } else if (keyword == "command") {
+            entry.Command = arg;
+        } else if (keyword == "rx") {
+            std::vector<uint8_t> fragment;
+            for (const auto& byte : split(arg, ' ')) {
+                if (!byte.empty()) {
+                    fragment.push_back(strtoul(byte.c_str(), nullptr, 16));
+                }
+            }
+            entry.Fragments.push_back(std::move(fragment));
+        } else if (keyword == "result") {
+            entry.Result = arg;
+        } else if (keyword == "expect") {
+            const size_t valueSep = arg.find(' ');
+            if (valueSep == std::string::npos) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": expectation without value");
+            }
+            entry.Expectations.emplace_back(arg.substr(0, valueSep), arg.substr(valueSep + 1));
+        } else {
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": unknown keyword " + keyword);
+        }
+    }
+
+    if (entry.Serial == 0 || entry.Command.empty()) {
+        throw std::runtime_error(path + ": serial or command missing");
+    }
+    return entry;
+}
+
+std::vector<CorpusEntry> load(const std::string& dir)
+{
+    std::vector<std::string> files;
+    for (const auto& file : std::filesystem::recursive_directory_iterator(dir)) {
+        if (file.is_regular_file() && file.path().extension() == ".txt") {
+            files.push_back(file.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<CorpusEntry> entries;
+    for (const auto& file : files) {
+        entries.push_back(loadFile(file));
+    }
+    return entries;
+}
+
+void setVerbose(const bool verbose)
+{
+    initHoymiles();
+    Hoymiles.setMessageOutput(verbose ? static_cast<Print*>(&Serial) : &nullOutput);
+}
+
+const std::vector<uint64_t>& getInverterSerials()
+{
+    static const std::vector<uint64_t> serials = {
+        0x112112345678, // HM_1CH
+        0x114112345678, // HM_2CH
+        0x116112345678, // HM_4CH
+        0x112412345678, // HMS_1CH
+        0x112512345678, // HMS_1CHv2
+        0x114412345678, // HMS_2CH
+        0x116412345678, // HMS_4CH
+        0x136112345678, // HMT_4CH
+        0x138212345678, // HMT_6CH
+        0x284112345678, // HERF_1CH
+        0x282112345678, // HERF_2CH
+        0x280112345678, // HERF_4CH
+    };
+    return serials;
+}
+
+std::shared_ptr<InverterAbstract> getInverter(const uint64_t serial)
+{
+    initHoymiles();
+
+    auto inv = Hoymiles.getInverterBySerial(serial);
+    if (inv == nullptr) {
+        inv = Hoymiles.addInverter("corpus", serial);
+    }
+    return inv;
+}
+
+const std::vector<std::string>& getCommandNames()
+{
+    static const std::vector<std::string> names = {
+        "RealTimeRunData", "AlarmData", "DevInfoAll", "DevInfoSimple", "GridOnProFilePara", "SystemConfigPara"
+    };
+    return names;
+}
+
+std::shared_ptr<CommandAbstract> createCommand(InverterAbstract& inv, const std::string& name)
+{
+    HoymilesRadio* radio = inv.getRadio();
+    if (name == "RealTimeRunData") {
+        return radio->prepareCommand<RealTimeRunDataCommand>(&inv);
+    } else if (name == "AlarmData") {
+        return radio->prepareCommand<AlarmDataCommand>(&inv);
+    } else if (name == "DevInfoAll") {
+        return radio->prepareCommand<DevInfoAllCommand>(&inv);
+    } else if (name == "DevInfoSimple") {
+        return radio->prepareCommand<DevInfoSimpleCommand>(&inv);
+    } else if (name == "GridOnProFilePara") {
+        return radio->prepareCommand<GridOnProFilePara>(&inv);
+    } else if (name == "SystemConfigPara") {
+        return radio->prepareCommand<SystemConfigParaCommand>(&inv);
+    }
+    return nullptr;
+}
+
+uint8_t decode(InverterAbstract& inv, CommandAbstract& cmd, const std::vector<std::vector<uint8_t>>& fragments)
+{
+    inv.clearRxFragmentBuffer();
+    for (const auto& fragment : fragments) {
+        inv.addRxFragment(fragment.data(), std::min<size_t>(fragment.size(), UINT8_MAX), -60);
+    }
+    return inv.verifyAllFragments(cmd);
+}
+
+const char* getResultName(const uint8_t result)
+{
+    switch (result) {
+    case FRAGMENT_OK:
+        return "OK";
+    case FRAGMENT_ALL_MISSING_RESEND:
+        return "ALL_MISSING_RESEND";
+    case FRAGMENT_ALL_MISSING_TIMEOUT:
+        return "ALL_MISSING_TIMEOUT";
+    case FRAGMENT_RETRANSMIT_TIMEOUT:
+        return "RETRANSMIT_TIMEOUT";
+    case FRAGMENT_HANDLE_ERROR:
+        return "HANDLE_ERROR";
+    case FRAGMENT_RETRANSMIT:
+        return "RETRANSMIT";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+bool readValue(InverterAbstract& inv, const std::string& key, std::string& value)
+{
+    const auto parts = split(key, '.');
+    if (parts.empty()) {
+        return false;
+    }
+
+    if (parts[0] == "stat") {
+        return readStatistics(inv, parts, value);
+    } else if (parts[0] == "alarm") {
+        return readAlarm(inv, parts, value);
+    } else if (parts[0] == "devinfo") {
+        return readDevInfo(inv, parts, value);
+    } else if (parts[0] == "gridprofile") {
+        return readGridProfile(inv, parts, value);
+    } else if (key == "limit.percent") {
+        value = formatFloat(inv.SystemConfigPara()->getLimitPercent());
+        return true;
+    } else if (key == "fragments.missing") {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%04" PRIX16, inv.getMissingFragments());
+        value = buf;
+        return true;
+    }
+    return false;
+}
+
+bool matches(const std::string& actual, const std::string& expected)
+{
+    double a, e;
+    if (parseNumber(actual, a) && parseNumber(expected, e)) {
+        // Values are decoded as float
+        return std::fabs(a - e) <= 1e-5 * std::max(1.0, std::fabs(e));
+    }
+    return actual == expected;
+}
+
+unsigned readAllValues(InverterAbstract& inv, const std::string& command)
+{
+    unsigned reads = 0;
+    float sum = 0;
+
+    if (command == "RealTimeRunData") {
+        StatisticsParser* stat = inv.Statistics();
+        for (const auto type : stat->getChannelTypes()) {
+            for (const auto channel : stat->getChannelsByType(type)) {
+                for (uint8_t field = FLD_UDC; field <= FLD_IAC_3; field++) {
+                    if (stat->hasChannelFieldValue(type, channel, static_cast<FieldId_t>(field))) {
+                        sum += stat->getChannelFieldValue(type, channel, static_cast<FieldId_t>(field));
+                        reads++;
+                    }
+                }
+            }
+        }
+    } else if (command == "AlarmData") {
+        AlarmLogParser* log = inv.EventLog();
+        const uint8_t count = log->getEntryCount();
+        for (uint8_t i = 0; i < count; i++) {
+            AlarmLogEntry_t entry;
+            log->getLogEntry(i, entry, 0);
+            sum += entry.StartTime + strlen(entry.Message);
+            reads++;
+        }
+    } else if (command == "DevInfoAll") {
+        DevInfoParser* info = inv.DevInfo();
+        sum += info->getFwBuildVersion();
+        sum += info->getFwBuildDateTimeStr().length();
+        sum += info->getFwBootloaderVersion();
+        reads += 3;
+    } else if (command == "DevInfoSimple") {
+        DevInfoParser* info = inv.DevInfo();
+        sum += info->getHwPartNumber();
+        sum += info->getHwVersion().length();
+        sum += info->getMaxPower();
+        sum += info->getHwModelName().length();
+        reads += 4;
+    } else if (command == "GridOnProFilePara") {
+        GridProfileParser* profile = inv.GridProfile();
+        sum += profile->getProfileName().length() + profile->getProfileVersion().length();
+        profile->visitProfile(
+            [&sum](const char* name) { sum += strlen(name); },
+            [&sum, &reads](const char* name, const char* unit, const float value) {
+                sum += value + strlen(name) + strlen(unit);
+                reads++;
+            });
+    } else if (command == "SystemConfigPara") {
+        sum += inv.SystemConfigPara()->getLimitPercent();
+        reads++;
+    }
+
+    sink = sum;
+    return reads;
+}
+
+std::vector<uint8_t> toFuzzInput(const CorpusEntry& entry)
+{
+    const auto& serials = getInverterSerials();
+    const auto& commands = getCommandNames();
+
+    // Recorded entries of other serials use the inverter class of their prefix
+    uint8_t inverter = 0;
+    for (size_t i = 0; i < serials.size(); i++) {
+        if ((serials[i] >> 32) == (entry.Serial >> 32)) {
+            inverter = i;
+        }
+    }
+
+    const auto command = std::find(commands.begin(), commands.end(), entry.Command);
+
+    std::vector<uint8_t> input = { inverter, static_cast<uint8_t>(command != commands.end() ? command - commands.begin() : 0) };
+    for (const auto& fragment : entry.Fragments) {
+        input.push_back(fragment.size());
+        input.insert(input.end(), fragment.begin(), fragment.end());
+    }
+    return input;
+}
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <commands/CommandAbstract.h>
+#include <cstdint>
+#include <inverters/InverterAbstract.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef CORPUS_DIR
+#define CORPUS_DIR "corpus"
+#endif
+
+// One response of an inverter as received by the radio. See corpus/generate.py
+// for the file format.
+struct CorpusEntry {
+    std::string File;
+    uint64_t Serial = 0;
+    std::string Command;
+    std::vector<std::vector<uint8_t>> Fragments;
+    std::string Result = "OK";
+    std::vector<std::pair<std::string, std::string>> Expectations;
+};
+
+namespace Corpus {
+// Loads all *.txt files below dir sorted by path. Throws std::runtime_error on syntax errors.
+std::vector<CorpusEntry> load(const std::string& dir = CORPUS_DIR);
+CorpusEntry loadFile(const std::string& path);
+
+// Message output of the library is discarded unless verbose is set
+void setVerbose(const bool verbose);
+
+// One serial for every inverter class
+const std::vector<uint64_t>& getInverterSerials();
+
+// Returns the inverter for the serial and creates it on first use
+std::shared_ptr<InverterAbstract> getInverter(const uint64_t serial);
+
+const std::vector<std::string>& getCommandNames();
+std::shared_ptr<CommandAbstract> createCommand(InverterAbstract& inv, const std::string& name);
+
+// Runs the fragments through the same path as the radio implementations and
+// returns the result of verifyAllFragments()
+uint8_t decode(InverterAbstract& inv, CommandAbstract& cmd, const std::vector<std::vector<uint8_t>>& fragments);
+const char* getResultName(const uint8_t result);
+
+// Reads the value of an expectation key (e.g. stat.DC.0.UDC) from the parsers
+// of the inverter. Returns false if the key is unknown.
+bool readValue(InverterAbstract& inv, const std::string& key, std::string& value);
+
+// Reads every value the parser of the command provides like the web
+// interface does and returns the number of values
+unsigned readAllValues(InverterAbstract& inv, const std::string& command);
+
+// Numbers are compared with a relative tolerance, everything else as string
+bool matches(const std::string& actual, const std::string& expected);
+
+// Converts an entry into the input format of the fuzzer (see ParserFuzzer.cpp)
+std::vector<uint8_t> toFuzzInput(const CorpusEntry& entry);
+}
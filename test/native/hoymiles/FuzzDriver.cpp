@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Standalone driver for LLVMFuzzerTestOneInput() for compilers without
+ * libFuzzer. It is not coverage guided: the seeds are mutated randomly with a
+ * fixed seed so every run is reproducible. Use clang for real fuzzing.
+ *
+ * Usage: parser_fuzzer [-runs=N] [-seed=N] [-max_len=N] [file or dir...]
+ *
+ * Without files the corpus is used as seed. The input which made a
+ * sanitizer fail is written to crash-input.bin.
+ */
+#include "Corpus.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sanitizer/common_interface_defs.h>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+using Input = std::vector<uint8_t>;
+
+const Input* currentInput = nullptr;
+
+constexpr uint8_t interestingValues[] = { 0x00, 0x01, 0x0a, 0x0b, 0x10, 0x11, 0x15, 0x20, 0x7f, 0x80, 0x81, 0x8d, 0x95, 0xfe, 0xff };
+
+Input readFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return Input(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeCrashInput()
+{
+    if (currentInput != nullptr) {
+        std::ofstream("crash-input.bin", std::ios::binary).write(reinterpret_cast<const char*>(currentInput->data()), currentInput->size());
+        fprintf(stderr, "Input written to crash-input.bin\n");
+    }
+}
+
+void run(const Input& input)
+{
+    currentInput = &input;
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+    currentInput = nullptr;
+}
+
+Input mutate(const std::vector<Input>& pool, std::mt19937& rng, const size_t maxLen)
+{
+    Input input = pool[rng() % pool.size()];
+    const unsigned mutations = 1 + rng() % 4;
+
+    for (unsigned m = 0; m < mutations; m++) {
+        const size_t pos = input.empty() ? 0 : rng() % input.size();
+        switch (rng() % 8) {
+        case 0: // Flip a bit
+            if (!input.empty()) {
+                input[pos] ^= 1 << (rng() % 8);
+            }
+            break;
+        case 1: // Random byte
+            if (!input.empty()) {
+                input[pos] = rng();
+            }
+            break;
+        case 2: // Interesting byte
+            if (!input.empty()) {
+                input[pos] = interestingValues[rng() % sizeof(interestingValues)];
+            }
+            break;
+        case 3: // Insert bytes
+            input.insert(input.begin() + pos, 1 + rng() % 8, static_cast<uint8_t>(rng()));
+            break;
+        case 4: // Erase bytes
+            if (!input.empty()) {
+                input.erase(input.begin() + pos, input.begin() + std::min(input.size(), pos + 1 + rng() % 8));
+            }
+            break;
+        case 5: // Truncate
+            input.resize(pos);
+            break;
+        case 6: { // Splice with another input
+            const Input& other = pool[rng() % pool.size()];
+            if (!other.empty()) {
+                const size_t from = rng() % other.size();
+                input.resize(pos);
+                input.insert(input.end(), other.begin() + from, other.end());
+            }
+            break;
+        }
+        default: // Other inverter or command
+            if (input.size() >= 2) {
+                input[rng() % 2] = rng();
+            }
+            break;
+        }
+    }
+
+    if (input.size() > maxLen) {
+        input.resize(maxLen);
+    }
+    return input;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned long runs = 100000;
+    unsigned long seed = 1;
+    size_t maxLen = 512;
+    std::vector<Input> pool;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.rfind("-runs=", 0) == 0) {
+            runs = std::stoul(arg.substr(6));
+        } else if (arg.rfind("-seed=", 0) == 0) {
+            seed = std::stoul(arg.substr(6));
+        } else if (arg.rfind("-max_len=", 0) == 0) {
+            maxLen = std::stoul(arg.substr(9));
+        } else if (std::filesystem::is_directory(arg)) {
+            for (const auto& file : std::filesystem::directory_iterator(arg)) {
+                pool.push_back(readFile(file.path().string()));
+            }
+        } else {
+            pool.push_back(readFile(arg));
+        }
+    }
+
+    __sanitizer_set_death_callback(writeCrashInput);
+
+    if (pool.empty()) {
+        for (const auto& entry : Corpus::load()) {
+            pool.push_back(Corpus::toFuzzInput(entry));
+        }
+    }
+
+    for (const auto& input : pool) {
+        run(input);
+    }
+
+    std::mt19937 rng(seed);
+    for (unsigned long i = 0; i < runs; i++) {
+        run(mutate(pool, rng, maxLen));
+    }
+
+    printf("Done %lu runs on %zu seeds\n", runs, pool.size());
+    return 0;
+}
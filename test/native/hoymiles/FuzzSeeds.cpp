@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Writes the corpus in the binary input format of the fuzzer to use it as
+ * seed corpus for libFuzzer.
+ *
+ * Usage: fuzz_seeds <output dir> [corpus dir]
+ */
+#include "Corpus.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        printf("Usage: %s <output dir> [corpus dir]\n", argv[0]);
+        return 1;
+    }
+
+    const std::filesystem::path out = argv[1];
+    std::filesystem::create_directories(out);
+
+    try {
+        unsigned count = 0;
+        for (const auto& entry : Corpus::load(argc > 2 ? argv[2] : CORPUS_DIR)) {
+            const auto input = Corpus::toFuzzInput(entry);
+            const auto file = std::filesystem::path(entry.File);
+            const auto name = file.parent_path().filename().string() + "_" + file.stem().string() + ".bin";
+            std::ofstream(out / name, std::ios::binary).write(reinterpret_cast<const char*>(input.data()), input.size());
+            count++;
+        }
+        printf("%u seeds written to %s\n", count, out.c_str());
+    } catch (const std::exception& e) {
+        printf("%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Measures the time to decode the responses of the corpus (fragment
+ * reassembly, CRC and parser) and the time to read a single value from the
+ * parser afterwards.
+ *
+ * Usage: parser_benchmark [--min-time ms] [corpus dir]
+ *
+ * The host numbers are only useful to compare changes against each other,
+ * the ESP32 is roughly 20-50 times slower.
+ */
+#include "Corpus.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+// Runs func until minTime has passed and returns the ns per call
+double measure(const std::function<void()>& func, const double minTimeMs)
+{
+    using clock = std::chrono::steady_clock;
+
+    func(); // Warm up
+    uint64_t iterations = 0;
+    uint64_t batch = 1;
+    const auto start = clock::now();
+    double elapsedNs = 0;
+    do {
+        for (uint64_t i = 0; i < batch; i++) {
+            func();
+        }
+        iterations += batch;
+        batch *= 2;
+        elapsedNs = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    } while (elapsedNs < minTimeMs * 1e6);
+
+    return elapsedNs / iterations;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    double minTimeMs = 50;
+    std::string dir = CORPUS_DIR;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minTimeMs = atof(argv[++i]);
+        } else {
+            dir = argv[i];
+        }
+    }
+
+    std::vector<CorpusEntry> entries;
+    try {
+        entries = Corpus::load(dir);
+    } catch (const std::exception& e) {
+        printf("%s\n", e.what());
+        return 1;
+    }
+
+    printf("%-44s %6s %12s %8s %12s\n", "file", "bytes", "ns/decode", "fields", "ns/field");
+
+    for (const auto& entry : entries) {
+        if (entry.Result != "OK") {
+            continue;
+        }
+
+        const auto inv = Corpus::getInverter(entry.Serial);
+        const auto cmd = inv != nullptr ? Corpus::createCommand(*inv, entry.Command) : nullptr;
+        if (cmd == nullptr) {
+            continue;
+        }
+
+        size_t bytes = 0;
+        for (const auto& fragment : entry.Fragments) {
+            bytes += fragment.size();
+        }
+
+        const double decodeNs = measure([&]() { Corpus::decode(*inv, *cmd, entry.Fragments); }, minTimeMs);
+
+        unsigned fields = 0;
+        const double readNs = measure([&]() { fields = Corpus::readAllValues(*inv, entry.Command); }, minTimeMs);
+
+        std::string name = entry.File.substr(dir.size());
+        if (!name.empty() && name[0] == '/') {
+            name.erase(0, 1);
+        }
+        printf("%-44s %6zu %12.1f %8u %12.1f\n", name.c_str(), bytes, decodeNs, fields, fields > 0 ? readNs / fields : 0.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Decodes every response of the corpus like the radio implementations do and
+ * compares the result and the parser values with the expectations.
+ *
+ * Usage: parser_corpus_test [-v] [corpus dir or file...]
+ */
+#include "Corpus.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+unsigned checkEntry(const CorpusEntry& entry)
+{
+    unsigned failures = 0;
+
+    const auto inv = Corpus::getInverter(entry.Serial);
+    if (inv == nullptr) {
+        printf("FAIL %s: no inverter class for serial %012llX\n", entry.File.c_str(), static_cast<unsigned long long>(entry.Serial));
+        return 1;
+    }
+
+    const auto cmd = Corpus::createCommand(*inv, entry.Command);
+    if (cmd == nullptr) {
+        printf("FAIL %s: unknown command %s\n", entry.File.c_str(), entry.Command.c_str());
+        return 1;
+    }
+
+    const char* result = Corpus::getResultName(Corpus::decode(*inv, *cmd, entry.Fragments));
+    if (entry.Result != result) {
+        printf("FAIL %s: result %s, expected %s\n", entry.File.c_str(), result, entry.Result.c_str());
+        failures++;
+    }
+
+    for (const auto& [key, expected] : entry.Expectations) {
+        std::string actual;
+        if (!Corpus::readValue(*inv, key, actual)) {
+            printf("FAIL %s: unknown key %s\n", entry.File.c_str(), key.c_str());
+            failures++;
+        } else if (!Corpus::matches(actual, expected)) {
+            printf("FAIL %s: %s is %s, expected %s\n", entry.File.c_str(), key.c_str(), actual.c_str(), expected.c_str());
+            failures++;
+        }
+    }
+
+    return failures;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<CorpusEntry> entries;
+    bool verbose = false;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "-v") == 0) {
+                verbose = true;
+            } else if (strstr(argv[i], ".txt") != nullptr) {
+                entries.push_back(Corpus::loadFile(argv[i]));
+            } else {
+                const auto dir = Corpus::load(argv[i]);
+                entries.insert(entries.end(), dir.begin(), dir.end());
+            }
+        }
+        if (entries.empty()) {
+            entries = Corpus::load();
+        }
+    } catch (const std::exception& e) {
+        printf("FAIL %s\n", e.what());
+        return 1;
+    }
+
+    Corpus::setVerbose(verbose);
+
+    unsigned failures = 0;
+    unsigned checks = 0;
+    for (const auto& entry : entries) {
+        failures += checkEntry(entry);
+        checks += entry.Expectations.size() + 1;
+    }
+
+    printf("%zu files, %u checks, %u failures\n", entries.size(), checks, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Fuzz target for the fragment reassembly and the payload parsers.
+ *
+ * Input format:
+ *   byte 0     index into Corpus::getInverterSerials()
+ *   byte 1     bit 7 clear: index into Corpus::getCommandNames(), the rest
+ *                           are fragments as [length][packet] records which
+ *                           are passed through addRxFragment() and
+ *                           verifyAllFragments() like the radio does
+ *              bit 7 set:   the rest is [offset][payload] and passed
+ *                           directly to appendFragment() of the parser
+ *
+ * Afterwards every value of every parser is read.
+ */
+#include "Corpus.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+void appendToParser(InverterAbstract& inv, const uint8_t parser, const uint8_t offset, const uint8_t* data, const uint8_t len)
+{
+    switch (parser % Corpus::getCommandNames().size()) {
+    case 0:
+        inv.Statistics()->beginAppendFragment();
+        inv.Statistics()->clearBuffer();
+        inv.Statistics()->appendFragment(offset, data, len);
+        inv.Statistics()->endAppendFragment();
+        break;
+    case 1:
+        inv.EventLog()->beginAppendFragment();
+        inv.EventLog()->clearBuffer();
+        inv.EventLog()->appendFragment(offset, data, len);
+        inv.EventLog()->endAppendFragment();
+        break;
+    case 2:
+        inv.DevInfo()->beginAppendFragment();
+        inv.DevInfo()->clearBufferAll();
+        inv.DevInfo()->appendFragmentAll(offset, data, len);
+        inv.DevInfo()->endAppendFragment();
+        break;
+    case 3:
+        inv.DevInfo()->beginAppendFragment();
+        inv.DevInfo()->clearBufferSimple();
+        inv.DevInfo()->appendFragmentSimple(offset, data, len);
+        inv.DevInfo()->endAppendFragment();
+        break;
+    case 4:
+        inv.GridProfile()->beginAppendFragment();
+        inv.GridProfile()->clearBuffer();
+        inv.GridProfile()->appendFragment(offset, data, len);
+        inv.GridProfile()->endAppendFragment();
+        break;
+    default:
+        inv.SystemConfigPara()->beginAppendFragment();
+        inv.SystemConfigPara()->clearBuffer();
+        inv.SystemConfigPara()->appendFragment(offset, data, len);
+        inv.SystemConfigPara()->endAppendFragment();
+        break;
+    }
+}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (size < 2) {
+        return 0;
+    }
+
+    const auto& serials = Corpus::getInverterSerials();
+    const auto& commands = Corpus::getCommandNames();
+
+    const auto inv = Corpus::getInverter(serials[data[0] % serials.size()]);
+    const uint8_t mode = data[1];
+    data += 2;
+    size -= 2;
+
+    if (mode & 0x80) {
+        if (size > 0) {
+            appendToParser(*inv, mode & 0x7f, data[0], data + 1, std::min<size_t>(size - 1, UINT8_MAX));
+        }
+    } else {
+        std::vector<std::vector<uint8_t>> fragments;
+        while (size > 0) {
+            const size_t len = std::min<size_t>(data[0], size - 1);
+            fragments.emplace_back(data + 1, data + 1 + len);
+            data += len + 1;
+            size -= len + 1;
+        }
+
+        const auto cmd = Corpus::createCommand(*inv, commands[mode % commands.size()]);
+        Corpus::decode(*inv, *cmd, fragments);
+    }
+
+    for (const auto& command : commands) {
+        Corpus::readAllValues(*inv, command);
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Compares ThreadSafeQueue with both variants of BoundedQueue:
+ *
+ *   single     push and pop of one element within one thread (ns per pair)
+ *   1P1C       throughput with one producer and one consumer thread
+ *   latency    time from push until pop with one element in flight (p50 and
+ *              p99 in ns)
+ *   2P2C       throughput with two producers and two consumers (not for the
+ *              single producer single consumer variant)
+ *
+ * Producers retry while a bounded queue is full, consumers poll with
+ * try_pop(). Both yield in between. Every run checks that each element is
+ * received exactly once and in order per producer. The process fails
+ * otherwise.
+ *
+ * Usage: queue_benchmark [--items n]
+ *
+ * The host numbers are only useful to compare the queues with each other.
+ * On a single core the threaded runs mostly measure the context switches.
+ */
+#include <BoundedQueue.h>
+#include <ThreadSafeQueue.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define QUEUE_CAPACITY 1024
+
+namespace {
+using clock = std::chrono::steady_clock;
+
+struct Item {
+    uint32_t Producer;
+    uint32_t Seq;
+    int64_t PushNs;
+};
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+}
+
+bool failed = false;
+
+void fail(const char* queue, const char* run, const char* reason)
+{
+    printf("%s %s: %s\n", queue, run, reason);
+    failed = true;
+}
+
+template <typename Queue>
+void pushWait(Queue& queue, const Item& item)
+{
+    while (!queue.push(item)) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename Queue>
+double runSingle(const char* name, const uint32_t items)
+{
+    auto queue = std::make_unique<Queue>();
+    Item item {};
+    const auto start = clock::now();
+    for (uint32_t i = 0; i < items; i++) {
+        pushWait(*queue, { 0, i, 0 });
+        if (!queue->try_pop(item) || item.Seq != i) {
+            fail(name, "single", "element lost");
+            return 0;
+        }
+    }
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count() / items;
+}
+
+// Returns million elements per second. With paced set only one element is in
+// flight at a time and the latencies are collected.
+template <typename Queue>
+double runThreads(const char* name, const char* run, const uint32_t producers, const uint32_t consumers,
+    const uint32_t itemsPerProducer, const bool paced, std::vector<int64_t>* latencies = nullptr)
+{
+    auto queue = std::make_unique<Queue>();
+    const uint64_t total = static_cast<uint64_t>(producers) * itemsPerProducer;
+    std::atomic<uint64_t> consumed { 0 };
+    std::atomic<bool> error { false };
+
+    // Last sequence number received per consumer and producer
+    std::vector<std::vector<int64_t>> lastSeq(consumers, std::vector<int64_t>(producers, -1));
+    std::vector<std::vector<int64_t>> threadLatencies(consumers);
+    std::vector<uint64_t> received(consumers, 0);
+
+    std::vector<std::thread> threads;
+    const auto start = clock::now();
+
+    for (uint32_t c = 0; c < consumers; c++) {
+        threads.emplace_back([&, c]() {
+            Item item;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (!queue->try_pop(item)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (paced) {
+                    threadLatencies[c].push_back(nowNs() - item.PushNs);
+                }
+                if (item.Producer >= producers || item.Seq <= lastSeq[c][item.Producer]) {
+                    error = true;
+                } else {
+                    lastSeq[c][item.Producer] = item.Seq;
+                }
+                received[c]++;
+                consumed.fetch_add(1, std::memory_order_release);
+            }
+        });
+    }
+
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&, p]() {
+            for (uint32_t i = 0; i < itemsPerProducer; i++) {
+                if (paced) {
+                    while (consumed.load(std::memory_order_acquire) < i) {
+                        std::this_thread::yield();
+                    }
+                }
+                pushWait(*queue, { p, i, nowNs() });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    uint64_t sum = 0;
+    for (uint32_t c = 0; c < consumers; c++) {
+        sum += received[c];
+        if (latencies != nullptr) {
+            latencies->insert(latencies->end(), threadLatencies[c].begin(), threadLatencies[c].end());
+        }
+    }
+    if (error || sum != total || queue->size() != 0) {
+        fail(name, run, "elements lost, duplicated or reordered");
+    }
+
+    return total / seconds / 1e6;
+}
+
+int64_t percentile(std::vector<int64_t>& values, const double percent)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(values.size() * percent / 100));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+template <typename Queue>
+void benchmark(const char* name, const uint32_t items, const bool multi)
+{
+    const double singleNs = runSingle<Queue>(name, items);
+    const double spscRate = runThreads<Queue>(name, "1P1C", 1, 1, items, false);
+
+    std::vector<int64_t> latencies;
+    runThreads<Queue>(name, "latency", 1, 1, std::min<uint32_t>(items, 100000), true, &latencies);
+    const int64_t p50 = percentile(latencies, 50);
+    const int64_t p99 = percentile(latencies, 99);
+
+    if (multi) {
+        const double mpmcRate = runThreads<Queue>(name, "2P2C", 2, 2, items / 2, false);
+        printf("%-28s %10.1f %10.2f %10" PRId64 " %10" PRId64 " %10.2f\n", name, singleNs, spscRate, p50, p99, mpmcRate);
+    } else {
+        printf("%-28s %10.1f %10.2f %10" PRId64 " %10" PRId64 " %10s\n", name, singleNs, spscRate, p50, p99, "-");
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t items = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--items") == 0 && i + 1 < argc) {
+            items = std::max(2, atoi(argv[++i]));
+        } else {
+            printf("Usage: %s [--items n]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("%-28s %10s %10s %10s %10s %10s\n", "queue", "single ns", "1P1C M/s", "p50 ns", "p99 ns", "2P2C M/s");
+    benchmark<ThreadSafeQueue<Item>>("ThreadSafeQueue", items, true);
+    benchmark<BoundedQueue<Item, QUEUE_CAPACITY>>("BoundedQueue", items, true);
+    benchmark<BoundedQueue<Item, QUEUE_CAPACITY, true>>("BoundedQueue (SPSC)", items, false);
+
+    return failed ? 1 : 0;
+}
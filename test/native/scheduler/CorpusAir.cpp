@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "CorpusAir.h"
+#include <algorithm>
+#include <crc.h>
+
+CorpusAir::CorpusAir(const uint32_t latencyUs, const uint32_t spacingUs, const double lossRate)
+    : _latencyUs(latencyUs)
+    , _spacingUs(spacingUs)
+    , _lossRate(lossRate)
+{
+}
+
+void CorpusAir::addResponse(InverterAbstract& inv, const CorpusEntry& entry)
+{
+    const auto cmd = Corpus::createCommand(inv, entry.Command);
+    if (cmd == nullptr || entry.Fragments.empty()) {
+        return;
+    }
+    const uint8_t* packetId = cmd->getDataPayload() + 1;
+    auto& fragments = _responses[{ getPacketSerial(cmd->getDataPayload()), cmd->getCommandType() }];
+    fragments = entry.Fragments;
+    for (auto& fragment : fragments) {
+        if (fragment.size() > 5) {
+            std::copy(packetId, packetId + 4, fragment.begin() + 1);
+            fragment.back() = crc8(fragment.data(), fragment.size() - 1);
+        }
+    }
+}
+
+uint32_t CorpusAir::getPacketSerial(const uint8_t* data)
+{
+    return (static_cast<uint32_t>(data[1]) << 24) | (data[2] << 16) | (data[3] << 8) | data[4];
+}
+
+void CorpusAir::transmit(const uint8_t channel, const uint8_t* data, const uint8_t len)
+{
+    if (len < 11) {
+        _unansweredCount++;
+        return;
+    }
+
+    const uint32_t serial = getPacketSerial(data);
+    const uint64_t startUs = std::max(HostClock::nowUs(), _pending.empty() ? 0 : _pending.back().DueUs) + _latencyUs;
+
+    // Re-request of a single fragment of the last response
+    const uint8_t fragmentId = data[9] & 0x7f;
+    if (fragmentId > 0) {
+        _reRequestCount++;
+        const auto last = _lastResponse.find(serial);
+        if (last == _lastResponse.end()) {
+            _unansweredCount++;
+            return;
+        }
+        for (const auto& fragment : *last->second) {
+            if (fragment.size() > 9 && (fragment[9] & 0x7f) == fragmentId) {
+                send(fragment, startUs);
+            }
+        }
+        return;
+    }
+
+    _requestCount++;
+    const auto response = _responses.find({ serial, static_cast<uint16_t>((data[0] << 8) | data[10]) });
+    if (response == _responses.end()) {
+        _unansweredCount++;
+        return;
+    }
+
+    _lastResponse[serial] = &response->second;
+    uint64_t dueUs = startUs;
+    for (const auto& fragment : response->second) {
+        send(fragment, dueUs);
+        dueUs += _spacingUs;
+    }
+}
+
+void CorpusAir::send(const Fragment& fragment, const uint64_t dueUs)
+{
+    if (std::uniform_real_distribution<double>(0, 1)(_rng) < _lossRate) {
+        _droppedCount++;
+        return;
+    }
+    _pending.push_back({ dueUs, fragment });
+}
+
+bool CorpusAir::deliver(const uint64_t nowUs)
+{
+    bool delivered = false;
+    while (!_pending.empty() && _pending.front().DueUs <= nowUs) {
+        RF24::receive(_pending.front().Data.data(), _pending.front().Data.size());
+        _pending.pop_front();
+        delivered = true;
+    }
+    return delivered;
+}
+
+uint64_t CorpusAir::getNextDeliveryUs() const
+{
+    return _pending.empty() ? UINT64_MAX : _pending.front().DueUs;
+}
+
+uint32_t CorpusAir::getRequestCount() const
+{
+    return _requestCount;
+}
+
+uint32_t CorpusAir::getUnansweredCount() const
+{
+    return _unansweredCount;
+}
+
+uint32_t CorpusAir::getReRequestCount() const
+{
+    return _reRequestCount;
+}
+
+uint32_t CorpusAir::getDroppedCount() const
+{
+    return _droppedCount;
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "Corpus.h"
+#include <RF24.h>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Answers the requests of the DTU with the responses of the corpus like the
+// inverters would. The responses are readdressed to the serial of the
+// simulated inverter as all inverters of the corpus share the lower 4 bytes
+// of their serial. The first fragment arrives latencyUs after the request,
+// the following ones spacingUs apart. Fragments are dropped with the
+// probability lossRate to exercise the retransmits.
+class CorpusAir : public RF24Air {
+public:
+    CorpusAir(const uint32_t latencyUs, const uint32_t spacingUs, const double lossRate);
+
+    // Answers the request of entry.Command to inv with the fragments of entry
+    // (readdressed to inv)
+    void addResponse(InverterAbstract& inv, const CorpusEntry& entry);
+
+    void transmit(const uint8_t channel, const uint8_t* data, const uint8_t len) override;
+
+    // Passes all fragments which are due to the radio. Returns false if
+    // there were none.
+    bool deliver(const uint64_t nowUs);
+
+    // UINT64_MAX if no fragment is pending
+    uint64_t getNextDeliveryUs() const;
+
+    uint32_t getRequestCount() const;
+    uint32_t getUnansweredCount() const;
+    uint32_t getReRequestCount() const;
+    uint32_t getDroppedCount() const;
+
+private:
+    using Fragment = std::vector<uint8_t>;
+
+    // Inverter part of the packet id (byte 1-4) and command type
+    using Key = std::pair<uint32_t, uint16_t>;
+    static uint32_t getPacketSerial(const uint8_t* data);
+
+    void send(const Fragment& fragment, const uint64_t dueUs);
+
+    struct Pending {
+        uint64_t DueUs;
+        Fragment Data;
+    };
+
+    std::map<Key, std::vector<Fragment>> _responses;
+    std::map<uint32_t, const std::vector<Fragment>*> _lastResponse; // Source of re-requested fragments
+    std::deque<Pending> _pending;
+
+    const uint32_t _latencyUs;
+    const uint32_t _spacingUs;
+    const double _lossRate;
+    std::mt19937 _rng { 1 };
+
+    uint32_t _requestCount = 0;
+    uint32_t _unansweredCount = 0;
+    uint32_t _reRequestCount = 0;
+    uint32_t _droppedCount = 0;
+};
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ *
+ * Globals of the firmware which are used by the simulated tasks but are not
+ * compiled for the host. The configuration is kept in memory.
+ */
+#include "Configuration.h"
+#include "InverterPersistence.h"
+#include "MqttSettings.h"
+#include "NetworkSettings.h"
+#include "PinMapping.h"
+#include "Utils.h"
+#include <CpuTemperature.h>
+#include <SpiManager.h>
+
+ConfigurationClass Configuration;
+InverterPersistenceClass InverterPersistence;
+MqttSettingsClass MqttSettings;
+NetworkSettingsClass NetworkSettings;
+PinMappingClass PinMapping;
+CpuTemperatureClass CpuTemperature;
+SpiManager SpiManagerInst;
+WiFiClass WiFi;
+
+namespace {
+CONFIG_T config;
+std::mutex configMutex;
+}
+
+CONFIG_T const& ConfigurationClass::get()
+{
+    return config;
+}
+
+ConfigurationClass::WriteGuard ConfigurationClass::getWriteGuard()
+{
+    return WriteGuard();
+}
+
+ConfigurationClass::WriteGuard::WriteGuard()
+    : _lock(configMutex)
+{
+}
+
+CONFIG_T& ConfigurationClass::WriteGuard::getConfig()
+{
+    return config;
+}
+
+ConfigurationClass::WriteGuard::~WriteGuard() = default;
+
+INVERTER_CONFIG_T* ConfigurationClass::getInverterConfig(const uint64_t serial)
+{
+    for (auto& inv : config.Inverter) {
+        if (inv.Serial == serial) {
+            return &inv;
+        }
+    }
+    return nullptr;
+}
+
+bool MqttSettingsClass::getConnected()
+{
+    return _connected;
+}
+
+void MqttSettingsClass::publish(const String& subtopic, const String& payload)
+{
+    publishGeneric(getPrefix() + subtopic, payload, Configuration.get().Mqtt.Retain);
+}
+
+void MqttSettingsClass::publishGeneric(const String& topic, const String& payload, const bool retain, const uint8_t qos)
+{
+    _publishCount++;
+    _publishBytes += topic.length() + payload.length();
+}
+
+void MqttSettingsClass::subscribe(const String& topic, const uint8_t qos, const espMqttClientTypes::OnMessageCallback& cb)
+{
+    _subscriptions[topic.c_str()] = cb;
+}
+
+void MqttSettingsClass::unsubscribe(const String& topic)
+{
+    _subscriptions.erase(topic.c_str());
+}
+
+String MqttSettingsClass::getPrefix() const
+{
+    return Configuration.get().Mqtt.Topic;
+}
+
+void MqttSettingsClass::setConnected(const bool connected)
+{
+    _connected = connected;
+}
+
+uint32_t MqttSettingsClass::getPublishCount() const
+{
+    return _publishCount;
+}
+
+uint64_t MqttSettingsClass::getPublishBytes() const
+{
+    return _publishBytes;
+}
+
+size_t MqttSettingsClass::getSubscriptionCount() const
+{
+    return _subscriptions.size();
+}
+
+float CpuTemperatureClass::read()
+{
+    return 42.5;
+}
+
+// Only the NRF radio is connected
+PinMappingClass::PinMappingClass()
+{
+    memset(&_pinMapping, 0, sizeof(_pinMapping));
+    snprintf(_pinMapping.name, sizeof(_pinMapping.name), "Simulation");
+    _pinMapping.nrf24_miso = 19;
+    _pinMapping.nrf24_mosi = 23;
+    _pinMapping.nrf24_clk = 18;
+    _pinMapping.nrf24_irq = 16;
+    _pinMapping.nrf24_en = 4;
+    _pinMapping.nrf24_cs = 5;
+    _pinMapping.cmt_clk = -1;
+    _pinMapping.cmt_cs = -1;
+    _pinMapping.cmt_fcs = -1;
+    _pinMapping.cmt_gpio2 = -1;
+    _pinMapping.cmt_gpio3 = -1;
+    _pinMapping.cmt_sdio = -1;
+}
+
+PinMapping_t& PinMappingClass::get()
+{
+    return _pinMapping;
+}
+
+bool PinMappingClass::isValidNrf24Config() const
+{
+    return true;
+}
+
+bool PinMappingClass::isValidCmt2300Config() const
+{
+    return false;
+}
+
+// Nothing is persisted, the inverters start without data
+InverterPersistenceClass::InverterPersistenceClass()
+{
+}
+
+void InverterPersistenceClass::restoreAll()
+{
+}
+
+// Only passed to the sunset stub which does not use it
+int Utils::getTimezoneOffset()
+{
+    return 0;
+}
@@ -0,0 +1,301 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Runs the scheduler tasks of the firmware together with the Hoymiles loop
+ * against a virtual clock. The HM inverters of the corpus answer on a
+ * simulated NRF radio, MQTT publishes and websocket messages are only counted.
+ * WebApiWsLive and Display are not part of the simulation as ArduinoJson,
+ * ESPAsyncWebServer and U8g2 are not available for the host.
+ *
+ * Usage: task_simulation [-v] [--hours h] [--pass-us us] [--poll-interval s]
+ *                        [--publish-interval s] [--latency-ms ms]
+ *                        [--spacing-ms ms] [--loss percent]
+ *                        [--mqtt-offline start_s:duration_s]...
+ *
+ * The main loop of the firmware calls scheduler.execute() back to back. A
+ * pass is modelled to take --pass-us of virtual time while a task is due,
+ * idle time in between is skipped. The Hoymiles loop runs like the task of
+ * InverterSettings (which does not start it on the host): woken up by the
+ * radio interrupt, at the latest every
+ * tick while a radio is busy and every HOY_TASK_IDLE_WAIT ms otherwise.
+ *
+ * For every task the runs, the forceNextIteration() calls (passes in which
+ * the task only waited for the radio or MQTT) and the host time spent in the
+ * callback are reported. The host time is only useful to compare changes
+ * against each other.
+ */
+#include "CorpusAir.h"
+#include "Datastore.h"
+#include "InverterSettings.h"
+#include "MessageOutput.h"
+#include "MqttHandleDtu.h"
+#include "MqttHandleInverter.h"
+#include "MqttHandleInverterTotal.h"
+#include "MqttSettings.h"
+#include "PinMapping.h"
+#include "StallDetector.h"
+#include "SunPosition.h"
+#include "TaskProfiler.h"
+#include "defaults.h"
+#include <FunctionalInterrupt.h>
+#include <Hoymiles.h>
+#include <TaskScheduler.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+Scheduler scheduler;
+
+namespace {
+std::map<const Task*, const char*> taskNames;
+
+struct Options {
+    bool Verbose = false;
+    double Hours = 24;
+    uint32_t PassUs = 50;
+    uint32_t PollInterval = 5;
+    uint32_t PublishInterval = 5;
+    uint32_t LatencyMs = 10;
+    uint32_t SpacingMs = 2;
+    double LossPercent = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> MqttOffline; // Start and end in us
+};
+
+bool parseOptions(const int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "-v") {
+            options.Verbose = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+
+        if (arg == "--hours") {
+            options.Hours = atof(value);
+        } else if (arg == "--pass-us") {
+            options.PassUs = std::max(1, atoi(value));
+        } else if (arg == "--poll-interval") {
+            options.PollInterval = atoi(value);
+        } else if (arg == "--publish-interval") {
+            options.PublishInterval = std::max(1, atoi(value));
+        } else if (arg == "--latency-ms") {
+            options.LatencyMs = atoi(value);
+        } else if (arg == "--spacing-ms") {
+            options.SpacingMs = atoi(value);
+        } else if (arg == "--loss") {
+            options.LossPercent = atof(value);
+        } else if (arg == "--mqtt-offline") {
+            unsigned long start;
+            unsigned long duration;
+            if (sscanf(value, "%lu:%lu", &start, &duration) != 2) {
+                return false;
+            }
+            options.MqttOffline.emplace_back(start * 1000000ULL, (start + duration) * 1000000ULL);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Adds an inverter for every HM class of the corpus to the configuration.
+// The serials get distinct lower 4 bytes. The inverters are only added to
+// Hoymiles to find their class, InverterSettings adds them again.
+void addInverters(CorpusAir& air, const std::vector<CorpusEntry>& entries)
+{
+    auto guard = Configuration.getWriteGuard();
+    auto& config = guard.getConfig();
+    uint8_t slot = 0;
+
+    for (const uint64_t corpusSerial : Corpus::getInverterSerials()) {
+        const uint64_t serial = (corpusSerial & 0xffff00000000) | (0x10000001 + slot);
+        auto inv = Hoymiles.addInverter("sim", serial);
+        if (inv == nullptr) {
+            continue;
+        }
+        if (inv->getRadio() != Hoymiles.getRadioNrf()) {
+            Hoymiles.removeInverterBySerial(serial);
+            continue;
+        }
+
+        for (const auto& entry : entries) {
+            if (entry.Serial == corpusSerial && entry.Result == "OK") {
+                air.addResponse(*inv, entry);
+            }
+        }
+        Hoymiles.removeInverterBySerial(serial);
+
+        auto& cfg = config.Inverter[slot++];
+        cfg.Serial = serial;
+        snprintf(cfg.Name, sizeof(cfg.Name), "%s", inv->typeName().c_str());
+        cfg.Poll_Enable = true;
+        cfg.Poll_Enable_Night = true;
+        cfg.Command_Enable = true;
+        cfg.Command_Enable_Night = true;
+        for (uint8_t c = 0; c < INV_MAX_CHAN_COUNT; c++) {
+            snprintf(cfg.channel[c].Name, sizeof(cfg.channel[c].Name), "String %u", c + 1);
+        }
+    }
+}
+
+bool isMqttOffline(const Options& options, const uint64_t nowUs)
+{
+    return std::any_of(options.MqttOffline.begin(), options.MqttOffline.end(),
+        [nowUs](const auto& w) { return nowUs >= w.first && nowUs < w.second; });
+}
+
+// Next start or end of an offline window after nowUs
+uint64_t getNextMqttChangeUs(const Options& options, const uint64_t nowUs)
+{
+    uint64_t next = UINT64_MAX;
+    for (const auto& w : options.MqttOffline) {
+        if (w.first > nowUs) {
+            next = std::min(next, w.first);
+        }
+        if (w.second > nowUs) {
+            next = std::min(next, w.second);
+        }
+    }
+    return next;
+}
+}
+
+// Called by TaskProfiler for every run of a task
+StallDetectorClass::Scope::Scope(const char* name, const StallContext_t context)
+{
+    taskNames[&scheduler.currentTask()] = name;
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printf("Usage: %s [-v] [--hours h] [--pass-us us] [--poll-interval s] [--publish-interval s] [--latency-ms ms] [--spacing-ms ms] [--loss percent] [--mqtt-offline start_s:duration_s]...\n", argv[0]);
+        return 1;
+    }
+
+    // Also initializes Hoymiles. The firmware writes its messages to Serial.
+    Corpus::setVerbose(options.Verbose);
+    Serial.setOutput(options.Verbose ? stdout : nullptr);
+
+    const auto entries = Corpus::load();
+    CorpusAir air(options.LatencyMs * 1000, options.SpacingMs * 1000, options.LossPercent / 100);
+
+    HostClock::useVirtualTime();
+    RF24::setAir(&air);
+
+    {
+        auto guard = Configuration.getWriteGuard();
+        auto& config = guard.getConfig();
+        snprintf(config.Mqtt.Topic, sizeof(config.Mqtt.Topic), "solar/");
+        config.Mqtt.PublishInterval = options.PublishInterval;
+        config.Dtu.PollInterval = options.PollInterval;
+        config.Dtu.Serial = DTU_SERIAL;
+    }
+
+    addInverters(air, entries);
+
+    // Same order as in main.cpp
+    AsyncWebSocket ws;
+    TaskProfiler.init(scheduler);
+    MessageOutput.init(scheduler);
+    MessageOutput.register_ws_output(&ws);
+    SunPosition.init(scheduler);
+    MqttHandleDtu.init(scheduler);
+    MqttHandleInverter.init(scheduler);
+    MqttHandleInverterTotal.init(scheduler);
+    InverterSettings.init(scheduler);
+    Datastore.init(scheduler);
+
+    if (!Hoymiles.getRadioNrf()->isInitialized()) {
+        printf("NRF radio not initialized\n");
+        return 1;
+    }
+
+    const uint64_t endUs = static_cast<uint64_t>(options.Hours * 3600e6);
+    uint64_t nextPassUs = 0;
+    uint64_t nextHoymilesUs = 0;
+    uint64_t passes = 0;
+    uint64_t hoymilesLoops = 0;
+    uint64_t hoymilesNs = 0;
+
+    const auto hostStart = std::chrono::steady_clock::now();
+
+    for (uint64_t nowUs = 0; nowUs < endUs; nowUs = HostClock::nowUs()) {
+        MqttSettings.setConnected(!isMqttOffline(options, nowUs));
+
+        if (air.deliver(nowUs)) {
+            triggerInterrupt(PinMapping.get().nrf24_irq);
+            nextHoymilesUs = nowUs;
+        }
+
+        if (nowUs >= nextHoymilesUs) {
+            const auto start = std::chrono::steady_clock::now();
+            Hoymiles.loop();
+            hoymilesNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            hoymilesLoops++;
+            nextHoymilesUs = nowUs + (Hoymiles.isAllRadioIdle() ? HOY_TASK_IDLE_WAIT : 1) * 1000;
+        }
+
+        if (nowUs >= nextPassUs) {
+            scheduler.execute();
+            passes++;
+            nextPassUs = nowUs + options.PassUs;
+        }
+
+        // Skip to the next event. millis() based tasks are due at the start of a ms.
+        uint64_t nextUs = std::min({ nextHoymilesUs, air.getNextDeliveryUs(), getNextMqttChangeUs(options, nowUs), endUs });
+        const long untilTaskMs = scheduler.timeUntilNextRun();
+        if (untilTaskMs >= 0) {
+            nextUs = std::min(nextUs, std::max(nextPassUs, (nowUs / 1000 + untilTaskMs) * 1000));
+        }
+        HostClock::setUs(std::max(nextUs, nowUs + 1));
+    }
+
+    const double hostMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hostStart).count();
+
+    printf("Simulated %.1f h, pass %" PRIu32 " us, poll interval %" PRIu32 " s, publish interval %" PRIu32 " s\n\n",
+        options.Hours, options.PassUs, options.PollInterval, options.PublishInterval);
+
+    printf("%-20s %10s %10s %8s %10s %10s\n", "task", "runs", "spins", "spin %", "host ms", "ns/run");
+    for (const Task* task : scheduler.getTasks()) {
+        const auto name = taskNames.find(task);
+        const unsigned long runs = task->getRunCounter();
+        const unsigned long spins = task->getForcedIterations();
+        printf("%-20s %10lu %10lu %8.1f %10.1f %10.0f\n",
+            name != taskNames.end() ? name->second : "?", runs, spins,
+            runs > 0 ? 100.0 * spins / runs : 0.0,
+            task->getCallbackNs() / 1e6, runs > 0 ? static_cast<double>(task->getCallbackNs()) / runs : 0.0);
+    }
+    printf("%-20s %10" PRIu64 " %10s %8s %10.1f %10.0f\n", "Hoymiles.loop", hoymilesLoops, "", "",
+        hoymilesNs / 1e6, hoymilesLoops > 0 ? static_cast<double>(hoymilesNs) / hoymilesLoops : 0.0);
+
+    uint32_t rxSuccess = 0;
+    uint32_t rxFail = 0;
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        const auto inv = Hoymiles.getInverterByPos(i);
+        rxSuccess += inv->RadioStats.RxSuccess;
+        rxFail += inv->RadioStats.RxFailNoAnswer + inv->RadioStats.RxFailPartialAnswer + inv->RadioStats.RxFailCorruptData;
+    }
+
+    printf("\nScheduler passes:   %" PRIu64 "\n", passes);
+    printf("Radio requests:     %" PRIu32 " (%" PRIu32 " unanswered, %" PRIu32 " fragments re-requested, %" PRIu32 " dropped)\n",
+        air.getRequestCount(), air.getUnansweredCount(), air.getReRequestCount(), air.getDroppedCount());
+    printf("Commands:           %" PRIu32 " successful, %" PRIu32 " failed\n", rxSuccess, rxFail);
+    printf("MQTT publishes:     %" PRIu32 " (%" PRIu64 " bytes)\n", MqttSettings.getPublishCount(), MqttSettings.getPublishBytes());
+    printf("Console messages:   %" PRIu32 " (%" PRIu64 " bytes)\n", ws.getMessageCount(), ws.getMessageBytes());
+    printf("Host time:          %.0f ms\n", hostMs);
+
+    if (rxSuccess == 0 || MqttSettings.getPublishCount() == 0) {
+        printf("Nothing was received or published\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,8 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Only declared to compile the headers which mention it. Nothing of the
+// simulation serializes JSON.
+class JsonDocument;
+class JsonObject;
+class JsonVariant;
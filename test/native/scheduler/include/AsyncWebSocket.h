@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Host replacement of the websocket of ESPAsyncWebServer. Nothing is
+// connected, the messages are only counted.
+
+#include <cstddef>
+#include <cstdint>
+
+class AsyncWebSocket {
+public:
+    void textAll(const char* message, const size_t len)
+    {
+        _messageCount++;
+        _messageBytes += len;
+    }
+
+    uint32_t getMessageCount() const { return _messageCount; }
+    uint64_t getMessageBytes() const { return _messageBytes; }
+
+private:
+    uint32_t _messageCount = 0;
+    uint64_t _messageBytes = 0;
+};
@@ -0,0 +1,4 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Empty, CONFIG_ETH_USE_ESP32_EMAC is not defined on the host
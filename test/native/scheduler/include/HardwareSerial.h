@@ -0,0 +1,5 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// HardwareSerial is part of the Arduino stub
+#include <Arduino.h>
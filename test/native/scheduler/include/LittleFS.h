@@ -0,0 +1,6 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Only declared to compile the headers which mention it. Nothing of the
+// simulation accesses the file system.
+class File;
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Host replacement of include/MqttSettings.h. Nothing is sent, publishes are
+// only counted. The connection state is set by the simulation.
+
+#include "NetworkSettings.h"
+#include <espMqttClient.h>
+#include <map>
+#include <string>
+
+class MqttSettingsClass {
+public:
+    bool getConnected();
+    void publish(const String& subtopic, const String& payload);
+    void publishGeneric(const String& topic, const String& payload, const bool retain, const uint8_t qos = 0);
+
+    void subscribe(const String& topic, const uint8_t qos, const espMqttClientTypes::OnMessageCallback& cb);
+    void unsubscribe(const String& topic);
+
+    String getPrefix() const;
+
+    // Host only
+    void setConnected(const bool connected);
+    uint32_t getPublishCount() const;
+    uint64_t getPublishBytes() const;
+    size_t getSubscriptionCount() const;
+
+private:
+    bool _connected = true;
+    uint32_t _publishCount = 0;
+    uint64_t _publishBytes = 0;
+    std::map<std::string, espMqttClientTypes::OnMessageCallback> _subscriptions;
+};
+
+extern MqttSettingsClass MqttSettings;
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Host replacement of include/NetworkSettings.h. The network is always
+// connected by WiFi.
+
+#include <WiFi.h>
+
+enum class network_mode {
+    WiFi,
+    Ethernet,
+    Undefined
+};
+
+class NetworkSettingsClass {
+public:
+    IPAddress localIP() const { return IPAddress(192, 168, 4, 20); }
+    static String getHostname() { return "OpenDTU-Sim"; }
+    bool isConnected() const { return true; }
+    network_mode NetworkMode() const { return network_mode::WiFi; }
+};
+
+extern NetworkSettingsClass NetworkSettings;
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Host replacement of the SpiManager library. The simulated NRF radio is
+// always attached to HSPI.
+
+#include <SPI.h>
+#include <cstdint>
+#include <optional>
+
+class SpiManager {
+public:
+    std::optional<uint8_t> claim_bus_arduino() { return HSPI; }
+};
+
+extern SpiManager SpiManagerInst;
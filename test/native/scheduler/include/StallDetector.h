@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Host replacement of include/StallDetector.h. Stalls are not detected, the
+// scopes only tell the simulation the name of the running scheduler task.
+
+#include <cstdint>
+
+enum StallContext_t {
+    STALL_CONTEXT_LOOP,
+    STALL_CONTEXT_WEB,
+    STALL_CONTEXT_MODBUS,
+    STALL_CONTEXT_COUNT,
+};
+
+class StallDetectorClass {
+public:
+    class Scope {
+    public:
+        explicit Scope(const char* name, const StallContext_t context = STALL_CONTEXT_LOOP);
+    };
+};
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+
+class IPAddress {
+public:
+    IPAddress(const uint8_t a = 0, const uint8_t b = 0, const uint8_t c = 0, const uint8_t d = 0)
+        : _bytes { a, b, c, d }
+    {
+    }
+
+    String toString() const
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+        return String(buf);
+    }
+
+private:
+    uint8_t _bytes[4];
+};
+
+class WiFiClass {
+public:
+    int8_t RSSI() { return -62; }
+    String BSSIDstr() { return "02:00:00:00:00:01"; }
+};
+
+extern WiFiClass WiFi;
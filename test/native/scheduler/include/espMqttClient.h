@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Types of bertmelis/espMqttClient which are part of the interface of the
+// MQTT handlers
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace espMqttClientTypes {
+struct MessageProperties {
+    uint8_t qos;
+    bool dup;
+    bool retain;
+    uint16_t packetId;
+};
+
+typedef std::function<void(const MessageProperties& properties, const char* topic, const uint8_t* payload, size_t len, size_t index, size_t total)> OnMessageCallback;
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "Arduino.h"
+#include "FunctionalInterrupt.h"
+#include <chrono>
+#include <map>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount()
+{
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return static_cast<uint32_t>(ns * getCpuFreqMHz() / 1000);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return _output != nullptr ? fwrite(&c, 1, 1, _output) : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+    return _output != nullptr ? fwrite(buffer, 1, size, _output) : size;
+}
+
+static std::map<uint8_t, std::function<void()>>& interruptHandlers()
+{
+    static std::map<uint8_t, std::function<void()>> handlers;
+    return handlers;
+}
+
+void attachInterrupt(const uint8_t pin, std::function<void()> intRoutine, const int)
+{
+    interruptHandlers()[pin] = std::move(intRoutine);
+}
+
+void detachInterrupt(const uint8_t pin)
+{
+    interruptHandlers().erase(pin);
+}
+
+bool triggerInterrupt(const uint8_t pin)
+{
+    const auto handler = interruptHandlers().find(pin);
+    if (handler == interruptHandlers().end()) {
+        return false;
+    }
+    handler->second();
+    return true;
+}
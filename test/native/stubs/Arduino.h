@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Minimal subset of the Arduino core which is required to build the
+// firmware libraries on the host. Only what is actually used is provided.
+
+#include "Esp.h"
+#include "HostClock.h"
+#include "Print.h"
+#include "WString.h"
+#include "esp_err.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <ctime>
+#include <new>
+
+#define ARDUINO_ISR_ATTR
+#define IRAM_ATTR
+
+// Core of the loop task of the Arduino core
+#define ARDUINO_RUNNING_CORE 1
+
+#define LOW 0x0
+#define HIGH 0x1
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+inline unsigned long millis()
+{
+    return static_cast<unsigned long>(HostClock::nowUs() / 1000);
+}
+
+inline unsigned long micros()
+{
+    return static_cast<unsigned long>(HostClock::nowUs());
+}
+
+inline void delay(const uint32_t ms)
+{
+    HostClock::sleepUs(static_cast<uint64_t>(ms) * 1000);
+}
+
+inline void yield() { }
+
+inline void pinMode(uint8_t, uint8_t) { }
+inline void digitalWrite(uint8_t, uint8_t) { }
+inline int digitalRead(uint8_t) { return LOW; }
+inline uint8_t digitalPinToInterrupt(const uint8_t pin) { return pin; }
+
+// Fails like on the ESP32 as long as the time was not synchronized
+inline bool getLocalTime(struct tm* info, const uint32_t ms = 5000)
+{
+    const time_t now = time(nullptr);
+    localtime_r(&now, info);
+    return info->tm_year > (2016 - 1900);
+}
+
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+inline size_t strlcpy(char* dst, const char* src, const size_t size)
+{
+    const size_t len = strlen(src);
+    if (size > 0) {
+        const size_t n = std::min(len, size - 1);
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) { }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+
+    // Host only: Stream the output is written to, nullptr discards it
+    void setOutput(FILE* output) { _output = output; }
+
+private:
+    FILE* _output = stdout;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+// The cycle counter runs at the nominal CPU frequency of the host time.
+// It does not follow the virtual time of HostClock, so durations measured
+// with it are the real duration of the host code.
+class EspClass {
+public:
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 240; }
+
+    // Values of a typical ESP32 without PSRAM
+    uint32_t getHeapSize() { return 330000; }
+    uint32_t getFreeHeap() { return 150000; }
+    uint32_t getMinFreeHeap() { return 120000; }
+    uint32_t getMaxAllocHeap() { return 110000; }
+};
+
+extern EspClass ESP;
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+struct HostTask {
+    std::atomic<uint32_t> Notifications { 0 };
+};
+
+struct HostSemaphore {
+    std::mutex Mutex;
+    std::condition_variable Released;
+    bool Taken = false;
+};
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    static thread_local HostTask task;
+    return &task;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, const uint32_t,
+    void*, const UBaseType_t, TaskHandle_t* createdTask, const BaseType_t)
+{
+    if (createdTask != nullptr) {
+        *createdTask = new HostTask();
+    }
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken)
+{
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken != nullptr) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+}
+
+void xTaskNotifyGive(TaskHandle_t task)
+{
+    if (task != nullptr) {
+        task->Notifications.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint32_t ulTaskNotifyTake(const BaseType_t clearCountOnExit, const TickType_t)
+{
+    auto& notifications = xTaskGetCurrentTaskHandle()->Notifications;
+    if (clearCountOnExit) {
+        return notifications.exchange(0);
+    }
+
+    uint32_t count = notifications.load();
+    while (count > 0 && !notifications.compare_exchange_weak(count, count - 1)) { }
+    return count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new HostSemaphore();
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, const TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(semaphore->Mutex);
+    const auto available = [semaphore] { return !semaphore->Taken; };
+
+    if (ticksToWait == portMAX_DELAY) {
+        semaphore->Released.wait(lock, available);
+    } else if (!semaphore->Released.wait_for(lock, std::chrono::milliseconds(ticksToWait), available)) {
+        return pdFAIL;
+    }
+
+    semaphore->Taken = true;
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    {
+        std::lock_guard<std::mutex> lock(semaphore->Mutex);
+        if (!semaphore->Taken) {
+            return pdFAIL;
+        }
+        semaphore->Taken = false;
+    }
+    semaphore->Released.notify_one();
+    return pdPASS;
+}
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+void attachInterrupt(const uint8_t pin, std::function<void()> intRoutine, const int mode);
+void detachInterrupt(const uint8_t pin);
+
+// Host only: calls the handler attached to pin as if the pin had changed
+bool triggerInterrupt(const uint8_t pin);
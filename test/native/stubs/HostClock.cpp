@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HostClock.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+const auto startTime = std::chrono::steady_clock::now();
+std::atomic<bool> virtualTime { false };
+std::atomic<uint64_t> virtualUs { 0 };
+}
+
+uint64_t HostClock::nowUs()
+{
+    if (virtualTime.load(std::memory_order_relaxed)) {
+        return virtualUs.load(std::memory_order_relaxed);
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void HostClock::sleepUs(const uint64_t us)
+{
+    if (virtualTime.load(std::memory_order_relaxed)) {
+        advanceUs(us);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void HostClock::useVirtualTime(const uint64_t startUs)
+{
+    virtualUs = startUs;
+    virtualTime = true;
+}
+
+bool HostClock::isVirtualTime()
+{
+    return virtualTime;
+}
+
+void HostClock::setUs(const uint64_t us)
+{
+    virtualUs = us;
+}
+
+void HostClock::advanceUs(const uint64_t us)
+{
+    virtualUs.fetch_add(us, std::memory_order_relaxed);
+}
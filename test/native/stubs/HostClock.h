@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+// Time base of millis() and micros(). By default the monotonic host clock
+// is used. Simulations switch to a virtual clock which only advances when
+// it is told to (or by delay()).
+namespace HostClock {
+uint64_t nowUs();
+void sleepUs(const uint64_t us);
+
+void useVirtualTime(const uint64_t startUs = 0);
+bool isVirtualTime();
+void setUs(const uint64_t us);
+void advanceUs(const uint64_t us);
+}
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "WString.h"
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size-- > 0 && write(*buffer++) == 1) {
+            n++;
+        }
+        return n;
+    }
+    size_t write(const char* str) { return write(reinterpret_cast<const uint8_t*>(str), strlen(str)); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char buf[256];
+        va_list args;
+        va_start(args, format);
+        const int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (len < 0) {
+            return 0;
+        }
+        if (static_cast<size_t>(len) < sizeof(buf)) {
+            return write(reinterpret_cast<const uint8_t*>(buf), len);
+        }
+
+        char* dyn = new char[len + 1];
+        va_start(args, format);
+        vsnprintf(dyn, len + 1, format, args);
+        va_end(args);
+        const size_t n = write(reinterpret_cast<const uint8_t*>(dyn), len);
+        delete[] dyn;
+        return n;
+    }
+
+    size_t print(const char* str) { return write(str); }
+    size_t print(const String& str) { return write(str.c_str()); }
+    size_t print(const char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(const unsigned char value, const int base = DEC) { return print(String(value, base)); }
+    size_t print(const int value, const int base = DEC) { return print(String(value, base)); }
+    size_t print(const unsigned int value, const int base = DEC) { return print(String(value, base)); }
+    size_t print(const long value, const int base = DEC) { return print(String(value, base)); }
+    size_t print(const unsigned long value, const int base = DEC) { return print(String(value, base)); }
+    size_t print(const long long value, const int base = DEC) { return print(String(value, base)); }
+    size_t print(const unsigned long long value, const int base = DEC) { return print(String(value, base)); }
+    size_t print(const double value, const int digits = 2) { return print(String(value, digits)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value)
+    {
+        return print(value) + println();
+    }
+    template <typename T>
+    size_t println(const T& value, const int base)
+    {
+        return print(value, base) + println();
+    }
+};
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// nRF24L01+ driver without a chip. isChipConnected() returns false, so the
+// radio is never initialized, unless a simulated counterpart on the air is
+// set with RF24::setAir().
+
+#include <SPI.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+// Host only: receives the written packets. Answers are passed to
+// RF24::receive() and the interrupt has to be triggered by the caller.
+class RF24Air {
+public:
+    virtual ~RF24Air() = default;
+    virtual void transmit(const uint8_t channel, const uint8_t* data, const uint8_t len) = 0;
+};
+
+typedef enum {
+    RF24_PA_MIN = 0,
+    RF24_PA_LOW,
+    RF24_PA_HIGH,
+    RF24_PA_MAX,
+    RF24_PA_ERROR
+} rf24_pa_dbm_e;
+
+typedef enum {
+    RF24_1MBPS = 0,
+    RF24_2MBPS,
+    RF24_250KBPS
+} rf24_datarate_e;
+
+typedef enum {
+    RF24_CRC_DISABLED = 0,
+    RF24_CRC_8,
+    RF24_CRC_16
+} rf24_crclength_e;
+
+class RF24 {
+public:
+    RF24(const uint8_t cePin, const uint8_t csPin) { }
+
+    bool begin(SPIClass*) { return true; }
+    bool isChipConnected() { return _air != nullptr; }
+    bool isPVariant() { return false; }
+
+    bool setDataRate(const rf24_datarate_e) { return true; }
+    void enableDynamicPayloads() { }
+    void setCRCLength(const rf24_crclength_e) { }
+    void setAddressWidth(const uint8_t) { }
+    void setRetries(const uint8_t, const uint8_t) { }
+    void maskIRQ(const bool, const bool, const bool) { }
+    void setPALevel(const uint8_t, const bool = true) { }
+
+    void setChannel(const uint8_t channel) { _channel = channel; }
+    uint8_t getChannel() { return _channel; }
+
+    void openReadingPipe(const uint8_t, const uint64_t) { }
+    void openWritingPipe(const uint64_t) { }
+    void startListening() { }
+    void stopListening() { }
+
+    bool available() { return !_rxFifo.empty(); }
+    uint8_t getDynamicPayloadSize() { return _rxFifo.empty() ? 0 : _rxFifo.front().size(); }
+    void read(void* buf, const uint8_t len)
+    {
+        if (_rxFifo.empty()) {
+            return;
+        }
+        memcpy(buf, _rxFifo.front().data(), std::min<size_t>(len, _rxFifo.front().size()));
+        _rxFifo.pop_front();
+    }
+    void flush_rx() { _rxFifo.clear(); }
+    bool testRPD() { return false; }
+
+    bool write(const void* buf, const uint8_t len)
+    {
+        if (_air == nullptr) {
+            return false;
+        }
+        _air->transmit(_channel, static_cast<const uint8_t*>(buf), len);
+        return true;
+    }
+
+    // Host only
+    static void setAir(RF24Air* air) { _air = air; }
+    static void receive(const uint8_t* data, const uint8_t len) { _rxFifo.emplace_back(data, data + len); }
+
+private:
+    uint8_t _channel = 76;
+
+    static inline RF24Air* _air = nullptr;
+    static inline std::deque<std::vector<uint8_t>> _rxFifo;
+};
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+#define HSPI 2
+#define VSPI 3
+
+class SPIClass {
+public:
+    explicit SPIClass(const uint8_t bus = HSPI)
+        : _bus(bus)
+    {
+    }
+
+    void begin(const int8_t sck = -1, const int8_t miso = -1, const int8_t mosi = -1, const int8_t ss = -1)
+    {
+        _ss = ss;
+    }
+    void end() { }
+    int8_t pinSS() const { return _ss; }
+
+private:
+    uint8_t _bus;
+    int8_t _ss = -1;
+};
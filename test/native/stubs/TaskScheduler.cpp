@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "TaskScheduler.h"
+#include "Arduino.h"
+#include <algorithm>
+#include <chrono>
+
+Task::Task(const unsigned long interval, const long iterations, TaskCallback callback, Scheduler* scheduler, const bool enable)
+    : _callback(std::move(callback))
+    , _interval(interval)
+    , _iterations(iterations)
+    , _setIterations(iterations)
+{
+    if (scheduler != nullptr) {
+        scheduler->addTask(*this);
+    }
+    if (enable) {
+        this->enable();
+    }
+}
+
+Task::~Task()
+{
+    if (_scheduler != nullptr) {
+        _scheduler->deleteTask(*this);
+    }
+}
+
+void Task::enable()
+{
+    _enabled = true;
+    _runCounter = 0;
+    _previousMillis = millis() - (_delay = _interval);
+}
+
+bool Task::enableIfNot()
+{
+    const bool wasEnabled = _enabled;
+    if (!wasEnabled) {
+        enable();
+    }
+    return wasEnabled;
+}
+
+void Task::enableDelayed(const unsigned long delay)
+{
+    enable();
+    this->delay(delay);
+}
+
+bool Task::disable()
+{
+    const bool wasEnabled = _enabled;
+    _enabled = false;
+    return wasEnabled;
+}
+
+bool Task::isEnabled() const
+{
+    return _enabled;
+}
+
+void Task::restart()
+{
+    _iterations = _setIterations;
+    enable();
+}
+
+void Task::restartDelayed(const unsigned long delay)
+{
+    _iterations = _setIterations;
+    enableDelayed(delay);
+}
+
+void Task::delay(const unsigned long delay)
+{
+    _delay = delay > 0 ? delay : _interval;
+    _previousMillis = millis();
+}
+
+void Task::forceNextIteration()
+{
+    _forcedIterations++;
+    _previousMillis = millis() - (_delay = _interval);
+}
+
+void Task::set(const unsigned long interval, const long iterations, TaskCallback callback)
+{
+    _interval = interval;
+    _delay = interval;
+    _iterations = _setIterations = iterations;
+    _callback = std::move(callback);
+}
+
+void Task::setInterval(const unsigned long interval)
+{
+    _interval = interval;
+    delay();
+}
+
+unsigned long Task::getInterval() const
+{
+    return _interval;
+}
+
+void Task::setIterations(const long iterations)
+{
+    _iterations = _setIterations = iterations;
+}
+
+long Task::getIterations() const
+{
+    return _iterations;
+}
+
+unsigned long Task::getRunCounter() const
+{
+    return _runCounter;
+}
+
+void Task::setCallback(TaskCallback callback)
+{
+    _callback = std::move(callback);
+}
+
+bool Task::isFirstIteration() const
+{
+    return _runCounter <= 1;
+}
+
+bool Task::isLastIteration() const
+{
+    return _iterations == 0;
+}
+
+unsigned long Task::getForcedIterations() const
+{
+    return _forcedIterations;
+}
+
+uint64_t Task::getCallbackNs() const
+{
+    return _callbackNs;
+}
+
+bool Task::isDue(const unsigned long now) const
+{
+    return now - _previousMillis >= _delay;
+}
+
+Scheduler::~Scheduler()
+{
+    for (Task* task : _tasks) {
+        task->_scheduler = nullptr;
+    }
+}
+
+void Scheduler::init()
+{
+    _tasks.clear();
+}
+
+void Scheduler::addTask(Task& task)
+{
+    if (task._scheduler != nullptr) {
+        task._scheduler->deleteTask(task);
+    }
+    task._scheduler = this;
+    _tasks.push_back(&task);
+}
+
+void Scheduler::deleteTask(Task& task)
+{
+    _tasks.erase(std::remove(_tasks.begin(), _tasks.end(), &task), _tasks.end());
+    task._scheduler = nullptr;
+}
+
+void Scheduler::enableAll()
+{
+    for (Task* task : _tasks) {
+        task->enable();
+    }
+}
+
+void Scheduler::disableAll()
+{
+    for (Task* task : _tasks) {
+        task->disable();
+    }
+}
+
+bool Scheduler::execute()
+{
+    bool idle = true;
+
+    // Callbacks may add tasks, so the list is not iterated by iterator
+    for (size_t i = 0; i < _tasks.size(); i++) {
+        Task& task = *_tasks[i];
+        if (!task._enabled) {
+            continue;
+        }
+        if (task._iterations == 0) {
+            task.disable();
+            continue;
+        }
+        if (!task.isDue(millis())) {
+            continue;
+        }
+
+        if (task._iterations > 0) {
+            task._iterations--;
+        }
+        task._runCounter++;
+        task._previousMillis += task._delay;
+        task._delay = task._interval;
+        idle = false;
+
+        if (task._callback) {
+            _currentTask = &task;
+            const auto start = std::chrono::steady_clock::now();
+            task._callback();
+            task._callbackNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            _currentTask = nullptr;
+        }
+    }
+
+    return idle;
+}
+
+Task& Scheduler::currentTask()
+{
+    return *_currentTask;
+}
+
+long Scheduler::timeUntilNextRun() const
+{
+    const unsigned long now = millis();
+    long next = -1;
+    for (const Task* task : _tasks) {
+        if (!task->_enabled) {
+            continue;
+        }
+        const unsigned long elapsed = now - task->_previousMillis;
+        const long remaining = elapsed >= task->_delay ? 0 : static_cast<long>(task->_delay - elapsed);
+        if (next < 0 || remaining < next) {
+            next = remaining;
+        }
+    }
+    return next;
+}
+
+const std::vector<Task*>& Scheduler::getTasks() const
+{
+    return _tasks;
+}
@@ -0,0 +1,5 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// The implementation is in TaskScheduler.cpp instead of this header
+#include "TaskSchedulerDeclarations.h"
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Subset of arkhipenko/TaskScheduler 3.8 (_TASK_STD_FUNCTION) which is used
+// by the firmware. The scheduling follows the library: a task is due once
+// its delay (usually the interval) has passed since the previous start,
+// forceNextIteration() makes it due at the next pass and setInterval()
+// restarts the delay. Time is taken from millis() and therefore follows
+// HostClock.
+//
+// Host only: every task counts the calls of forceNextIteration() and the
+// host time spent within its callback.
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#define TASK_MILLISECOND 1UL
+#define TASK_SECOND 1000UL
+#define TASK_MINUTE 60000UL
+#define TASK_HOUR 3600000UL
+#define TASK_IMMEDIATE 0
+#define TASK_FOREVER (-1)
+#define TASK_ONCE 1
+
+typedef std::function<void()> TaskCallback;
+
+class Scheduler;
+
+class Task {
+    friend class Scheduler;
+
+public:
+    Task(const unsigned long interval = 0, const long iterations = 0, TaskCallback callback = nullptr, Scheduler* scheduler = nullptr, const bool enable = false);
+    ~Task();
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    void enable();
+    bool enableIfNot();
+    void enableDelayed(const unsigned long delay = 0);
+    bool disable();
+    bool isEnabled() const;
+    void restart();
+    void restartDelayed(const unsigned long delay = 0);
+
+    void delay(const unsigned long delay = 0);
+    void forceNextIteration();
+
+    void set(const unsigned long interval, const long iterations, TaskCallback callback);
+    void setInterval(const unsigned long interval);
+    unsigned long getInterval() const;
+    void setIterations(const long iterations);
+    long getIterations() const;
+    unsigned long getRunCounter() const;
+    void setCallback(TaskCallback callback);
+
+    bool isFirstIteration() const;
+    bool isLastIteration() const;
+
+    // Host only
+    unsigned long getForcedIterations() const;
+    uint64_t getCallbackNs() const;
+
+private:
+    bool isDue(const unsigned long now) const;
+
+    Scheduler* _scheduler = nullptr;
+    TaskCallback _callback;
+    unsigned long _interval;
+    unsigned long _delay = 0;
+    unsigned long _previousMillis = 0;
+    long _iterations;
+    long _setIterations;
+    unsigned long _runCounter = 0;
+    bool _enabled = false;
+
+    unsigned long _forcedIterations = 0;
+    uint64_t _callbackNs = 0;
+};
+
+class Scheduler {
+public:
+    Scheduler() = default;
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    void init();
+    void addTask(Task& task);
+    void deleteTask(Task& task);
+    void enableAll();
+    void disableAll();
+
+    // Runs every task which is due once. Returns true if no task was due.
+    bool execute();
+
+    Task& currentTask();
+
+    // Host only: ms until the first enabled task is due, 0 if one is due
+    // already and -1 if no task is enabled
+    long timeUntilNextRun() const;
+    const std::vector<Task*>& getTasks() const;
+
+private:
+    std::vector<Task*> _tasks;
+    Task* _currentTask = nullptr;
+};
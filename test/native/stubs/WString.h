@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Arduino String on top of std::string. Numbers are formatted like the
+// Arduino core does (e.g. floats with two decimals by default).
+class String {
+public:
+    String() = default;
+    String(const char* str)
+        : _str(str != nullptr ? str : "")
+    {
+    }
+    String(const char* str, const size_t len)
+        : _str(str, len)
+    {
+    }
+    explicit String(const char c)
+        : _str(1, c)
+    {
+    }
+    String(const unsigned char value, const unsigned char base = 10) { fromUnsigned(value, base); }
+    String(const int value, const unsigned char base = 10) { fromSigned(value, base); }
+    String(const unsigned int value, const unsigned char base = 10) { fromUnsigned(value, base); }
+    String(const long value, const unsigned char base = 10) { fromSigned(value, base); }
+    String(const unsigned long value, const unsigned char base = 10) { fromUnsigned(value, base); }
+    String(const long long value, const unsigned char base = 10) { fromSigned(value, base); }
+    String(const unsigned long long value, const unsigned char base = 10) { fromUnsigned(value, base); }
+    String(const float value, const unsigned int decimalPlaces = 2) { fromDouble(value, decimalPlaces); }
+    String(const double value, const unsigned int decimalPlaces = 2) { fromDouble(value, decimalPlaces); }
+
+    const char* c_str() const { return _str.c_str(); }
+    unsigned int length() const { return _str.length(); }
+    bool isEmpty() const { return _str.empty(); }
+    bool reserve(const unsigned int size)
+    {
+        _str.reserve(size);
+        return true;
+    }
+
+    char charAt(const unsigned int index) const { return index < _str.length() ? _str[index] : '\0'; }
+    char operator[](const unsigned int index) const { return charAt(index); }
+    char& operator[](const unsigned int index) { return _str[index]; }
+
+    bool concat(const String& s)
+    {
+        _str += s._str;
+        return true;
+    }
+    bool concat(const char* s)
+    {
+        _str += s;
+        return true;
+    }
+    bool concat(const char c)
+    {
+        _str += c;
+        return true;
+    }
+    template <typename T>
+    bool concat(const T value)
+    {
+        return concat(String(value));
+    }
+
+    template <typename T>
+    String& operator+=(const T& value)
+    {
+        concat(value);
+        return *this;
+    }
+
+    bool equals(const String& s) const { return _str == s._str; }
+    bool equals(const char* s) const { return _str == (s != nullptr ? s : ""); }
+    bool operator==(const String& s) const { return equals(s); }
+    bool operator==(const char* s) const { return equals(s); }
+    bool operator!=(const String& s) const { return !equals(s); }
+    bool operator!=(const char* s) const { return !equals(s); }
+    bool operator<(const String& s) const { return _str < s._str; }
+
+    bool startsWith(const String& prefix) const { return _str.compare(0, prefix._str.length(), prefix._str) == 0; }
+    bool endsWith(const String& suffix) const
+    {
+        return _str.length() >= suffix._str.length()
+            && _str.compare(_str.length() - suffix._str.length(), suffix._str.length(), suffix._str) == 0;
+    }
+
+    int indexOf(const char c, const unsigned int from = 0) const { return toIndex(_str.find(c, from)); }
+    int indexOf(const String& s, const unsigned int from = 0) const { return toIndex(_str.find(s._str, from)); }
+    int lastIndexOf(const char c) const { return toIndex(_str.rfind(c)); }
+
+    String substring(const unsigned int from) const { return from < _str.length() ? String(_str.substr(from).c_str()) : String(); }
+    String substring(const unsigned int from, const unsigned int to) const
+    {
+        if (from >= to || from >= _str.length()) {
+            return String();
+        }
+        return String(_str.substr(from, to - from).c_str());
+    }
+
+    void toLowerCase()
+    {
+        for (auto& c : _str) {
+            c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    void toUpperCase()
+    {
+        for (auto& c : _str) {
+            c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    void trim()
+    {
+        const auto first = _str.find_first_not_of(" \t\r\n");
+        const auto last = _str.find_last_not_of(" \t\r\n");
+        _str = first == std::string::npos ? std::string() : _str.substr(first, last - first + 1);
+    }
+    void replace(const String& find, const String& replace)
+    {
+        if (find._str.empty()) {
+            return;
+        }
+        for (size_t pos = 0; (pos = _str.find(find._str, pos)) != std::string::npos; pos += replace._str.length()) {
+            _str.replace(pos, find._str.length(), replace._str);
+        }
+    }
+
+    long toInt() const { return strtol(_str.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(_str.c_str(), nullptr); }
+
+private:
+    static int toIndex(const size_t pos) { return pos == std::string::npos ? -1 : static_cast<int>(pos); }
+
+    void fromUnsigned(unsigned long long value, const unsigned char base)
+    {
+        char buf[8 * sizeof(value) + 1];
+        char* p = &buf[sizeof(buf) - 1];
+        *p = '\0';
+        do {
+            const unsigned digit = value % base;
+            *--p = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+            value /= base;
+        } while (value > 0);
+        _str = p;
+    }
+
+    void fromSigned(const long long value, const unsigned char base)
+    {
+        if (value < 0 && base == 10) {
+            fromUnsigned(-static_cast<unsigned long long>(value), base);
+            _str.insert(0, 1, '-');
+        } else {
+            fromUnsigned(static_cast<unsigned long long>(value), base);
+        }
+    }
+
+    void fromDouble(const double value, const unsigned int decimalPlaces)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+        _str = buf;
+    }
+
+    std::string _str;
+};
+
+template <typename T>
+inline String operator+(const String& lhs, const T& rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline String operator+(const char* lhs, const String& rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// CMT2300A driver without a chip. Replaces lib/CMT2300a, isChipConnected()
+// returns false, so the radio is never initialized.
+
+#include <cstdint>
+
+#define CMT2300A_ONE_STEP_SIZE 2500
+#define FH_OFFSET 100
+#define CMT_SPI_SPEED 4000000
+#define CMT_CHANNEL_UNKNOWN 0xFF
+#define CMT_TX_TIMEOUT 95
+
+#define CMT_BASE_FREQ_900 900000000
+#define CMT_BASE_FREQ_860 860000000
+
+enum FrequencyBand_t {
+    BAND_860,
+    BAND_900,
+    FrequencyBand_Max,
+};
+
+class CMT2300A {
+public:
+    CMT2300A(const uint8_t pin_sdio, const uint8_t pin_clk, const uint8_t pin_cs, const uint8_t pin_fcs, const uint32_t spi_speed = CMT_SPI_SPEED) { }
+
+    bool begin() { return true; }
+    bool isChipConnected() { return false; }
+
+    bool startListening() { return true; }
+    bool stopListening() { return true; }
+
+    bool available() { return false; }
+    void read(void*, const uint8_t) { }
+    bool write(const uint8_t*, const uint8_t) { return false; }
+
+    bool startTransmit(const uint8_t*, const uint8_t) { return false; }
+    bool isTransmitDone() { return true; }
+    void finishTransmit() { }
+
+    void setChannel(const uint8_t channel) { _channel = channel; }
+    uint8_t getChannel() { return _channel; }
+
+    uint8_t getDynamicPayloadSize() { return 0; }
+    int getRssiDBm() { return -128; }
+    bool setPALevel(const int8_t) { return true; }
+    bool rxFifoAvailable() { return false; }
+    void flush_rx() { }
+
+    uint32_t getBaseFrequency() const { return getBaseFrequency(_frequencyBand); }
+    static constexpr uint32_t getBaseFrequency(const FrequencyBand_t band)
+    {
+        return band == FrequencyBand_t::BAND_900 ? CMT_BASE_FREQ_900 : CMT_BASE_FREQ_860;
+    }
+
+    FrequencyBand_t getFrequencyBand() const { return _frequencyBand; }
+    void setFrequencyBand(const FrequencyBand_t band) { _frequencyBand = band; }
+
+private:
+    FrequencyBand_t _frequencyBand = FrequencyBand_t::BAND_860;
+    uint8_t _channel = CMT_CHANNEL_UNKNOWN;
+};
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+// Aborts like on the ESP32
+#define ESP_ERROR_CHECK(x)                                                 \
+    do {                                                                   \
+        const esp_err_t err_rc_ = (x);                                     \
+        if (err_rc_ != ESP_OK) {                                           \
+            fprintf(stderr, "ESP_ERROR_CHECK failed: %d (%s:%d)\n",        \
+                err_rc_, __FILE__, __LINE__);                              \
+            abort();                                                       \
+        }                                                                  \
+    } while (0)
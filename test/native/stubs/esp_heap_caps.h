@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <malloc.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+
+inline size_t heap_caps_get_allocated_size(void* ptr)
+{
+    return malloc_usable_size(ptr);
+}
+
+// The host behaves like a board without PSRAM
+inline size_t heap_caps_get_total_size(const uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? 0 : 320 * 1024;
+}
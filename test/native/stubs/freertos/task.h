@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "FreeRTOS.h"
+
+struct HostTask;
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+// Tasks are not started on the host, whoever creates one has to run its work
+// itself. The handle can be notified like the one of a running task.
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, const uint32_t stackDepth,
+    void* parameter, const UBaseType_t priority, TaskHandle_t* createdTask, const BaseType_t coreId);
+
+// Every host thread is seen as a task of its own
+TaskHandle_t xTaskGetCurrentTaskHandle();
+
+// Notifications are counted per task. Nobody waits for them on the host.
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
+void xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(const BaseType_t clearCountOnExit, const TickType_t ticksToWait);
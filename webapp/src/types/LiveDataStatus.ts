@@ -21,6 +21,21 @@ export interface InverterStatistics {
     Irradiation?: ValueObject;
 }
 
+export interface RadioChannelStatistics {
+    channel: number;
+    rx_fragments: number;
+    rx_crc_errors: number;
+    rssi: number;
+    score: number;
+}
+
+export interface Histogram {
+    bounds: number[];
+    buckets: number[]; // One more than bounds, the last one counts all values above the last bound
+    count: number;
+    sum: number;
+}
+
 export interface RadioStatistics {
     tx_request: number;
     tx_re_request: number;
@@ -28,7 +43,11 @@ export interface RadioStatistics {
     rx_fail_nothing: number;
     rx_fail_partial: number;
     rx_fail_corrupt: number;
+    rx_complete_time: number;
+    rx_complete_time_avg: number;
     rssi: number;
+    channels: RadioChannelStatistics[];
+    rssi_histogram: Histogram;
 }
 
 export interface Inverter {
@@ -36,6 +55,7 @@ export interface Inverter {
     name: string;
     order: number;
     data_age: number;
+    data_stale: boolean;
     poll_enabled: boolean;
     reachable: boolean;
     producing: boolean;
@@ -60,8 +80,26 @@ export interface Hints {
     radio_problem: boolean;
 }
 
+export interface RadioCommandStatistics {
+    name: string;
+    complete_time: Histogram;
+    retransmits: Histogram;
+}
+
+export interface RadioHistograms {
+    tx_airtime: number;
+    rx_latency: Histogram;
+    commands: RadioCommandStatistics[];
+}
+
+export interface Radios {
+    nrf?: RadioHistograms;
+    cmt?: RadioHistograms;
+}
+
 export interface LiveData {
     inverters: Inverter[];
     total: Total;
     hints: Hints;
+    radio: Radios;
 }
@@ -4,6 +4,15 @@ export interface TaskDetail {
     priority: number;
 }
 
+export interface TaskProfile {
+    name: string;
+    count: number;
+    total_ms: number;
+    max_us: number;
+    p99_us: number;
+    overruns: number;
+}
+
 export interface SystemStatus {
     // HardwareInfo
     chipmodel: string;
@@ -14,6 +23,8 @@ export interface SystemStatus {
     flashsize: number;
     // TaskDetails
     task_details: TaskDetail[];
+    // TaskProfile
+    task_profiles: TaskProfile[];
     // FirmwareInfo
     hostname: string;
     sdkversion: string;
@@ -45,4 +56,5 @@ export interface SystemStatus {
     nrf_pvariant: boolean;
     cmt_configured: boolean;
     cmt_connected: boolean;
+    cmt_turnaround: number;
 }
@@ -95,10 +95,47 @@ export function handleResponse(
             return Promise.reject(error);
         }
 
+        // Settings are written to flash in the background
+        if (data && data.write_sequence !== undefined) {
+            return waitConfigWrite(data);
+        }
+
         return data;
     });
 }
 
+interface ConfigWriteResponse {
+    write_sequence: number;
+    type: string;
+    message: string;
+    code: number;
+}
+
+// Resolves once the deferred configuration write has finished. A failed
+// write replaces the result of the original request.
+function waitConfigWrite<T extends ConfigWriteResponse>(data: T): Promise<T> {
+    return new Promise((resolve) => {
+        const poll = () => {
+            fetch('/api/config/write_status?sequence=' + data.write_sequence, { headers: authHeader() })
+                .then((response) => (response.ok ? response.json() : Promise.reject()))
+                .then((status) => {
+                    if (status.pending) {
+                        setTimeout(poll, 500);
+                        return;
+                    }
+                    if (status.type !== 'success') {
+                        data.type = status.type;
+                        data.message = status.message;
+                        data.code = status.code;
+                    }
+                    resolve(data);
+                })
+                .catch(() => resolve(data));
+        };
+        setTimeout(poll, 500);
+    });
+}
+
 function handleAuthResponse(response: Response) {
     return response.text().then((text) => {
         const data = text && JSON.parse(text);